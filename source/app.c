@@ -1,7 +1,7 @@
 /**
  * @ Author: Mo David
  * @ Create Time: 2024-07-19 18:40:56
- * @ Modified time: 2024-07-29 03:55:23
+ * @ Modified time: 2026-10-19 10:33:48
  * @ Description:
  * 
  * The main flow of the application.
@@ -13,6 +13,8 @@
 #include "./io/ui.c"
 #include "./model/model.c"
 
+#include <ctype.h>
+
 #define APP_DEFAULT_DATASET "./data/Caltech36.txt"
 #define APP_DEFAULT_COLS 7
 
@@ -30,7 +32,27 @@ enum AppState {
   APPSTATE_MENU,
   APPSTATE_LOAD,
   APPSTATE_FRIENDS,
+  APPSTATE_RELEVANT,
+  APPSTATE_SUGGEST,
   APPSTATE_CONNECTIONS,
+  APPSTATE_BATCH,
+  APPSTATE_INDEX,
+  APPSTATE_COMPONENTS,
+  APPSTATE_NEIGHBORHOOD,
+  APPSTATE_BOUNDED,
+  APPSTATE_PATHS,
+  APPSTATE_CLUSTERING,
+  APPSTATE_CENTRALITY,
+  APPSTATE_BETWEENNESS,
+  APPSTATE_SUMMARY,
+  APPSTATE_CORES,
+  APPSTATE_COMMUNITIES,
+  APPSTATE_DIAMETER,
+  APPSTATE_DISTANCES,
+  APPSTATE_SIMILAR,
+  APPSTATE_PRODUCT,
+  APPSTATE_CLIQUES,
+  APPSTATE_COHORT,
   APPSTATE_EXIT,
 };
 
@@ -87,7 +109,27 @@ void App_menu() {
   UI__();
   UI_indent(APP_INDENT_SUBINFO); UI_indent("1. "); UI_s("Load another dataset."); UI__();
   UI_indent(APP_INDENT_SUBINFO); UI_indent("2. "); UI_s("Display friend list."); UI__();
-  UI_indent(APP_INDENT_SUBINFO); UI_indent("3. "); UI_s("Display connections."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("3. "); UI_s("Display most relevant people."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("4. "); UI_s("Suggest friends."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("5. "); UI_s("Display connections."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("6. "); UI_s("Answer connections from a file."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("7. "); UI_s("Build a distance index."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("8. "); UI_s("Display component summary."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("9. "); UI_s("Display friends within k hops."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("10."); UI_s("Display connections within limits."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("11."); UI_s("Count shortest paths."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("12."); UI_s("Display clustering statistics."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("13."); UI_s("Display centrality rankings."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("14."); UI_s("Display betweenness rankings."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("15."); UI_s("Display dataset summary."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("16."); UI_s("Display k-cores."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("17."); UI_s("Detect communities."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("18."); UI_s("Display diameter and eccentricities."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("19."); UI_s("Display distance distribution."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("20."); UI_s("Find similar friend lists."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("21."); UI_s("Count walks between everyone."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("22."); UI_s("Find tight friend groups."); UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_indent("23."); UI_s("Compare distances within a group."); UI__();
   UI_indent(APP_INDENT_SUBINFO); UI_indent("0. "); UI_s("Exit the app."); UI__();
   UI__();
   
@@ -95,12 +137,32 @@ void App_menu() {
   char option[1024];
   scanf(" %s", option);
   
-  // Go to the next page
-  switch(option[0] - 48) {
+  // Go to the next page; anything that isn't a number just reprompts
+  switch(isdigit(option[0]) ? atoi(option) : -1) {
     case 0: App.appState = APPSTATE_EXIT; break;
     case 1: App.appState = APPSTATE_LOAD; break;
     case 2: App.appState = APPSTATE_FRIENDS; break;
-    case 3: App.appState = APPSTATE_CONNECTIONS; break;
+    case 3: App.appState = APPSTATE_RELEVANT; break;
+    case 4: App.appState = APPSTATE_SUGGEST; break;
+    case 5: App.appState = APPSTATE_CONNECTIONS; break;
+    case 6: App.appState = APPSTATE_BATCH; break;
+    case 7: App.appState = APPSTATE_INDEX; break;
+    case 8: App.appState = APPSTATE_COMPONENTS; break;
+    case 9: App.appState = APPSTATE_NEIGHBORHOOD; break;
+    case 10: App.appState = APPSTATE_BOUNDED; break;
+    case 11: App.appState = APPSTATE_PATHS; break;
+    case 12: App.appState = APPSTATE_CLUSTERING; break;
+    case 13: App.appState = APPSTATE_CENTRALITY; break;
+    case 14: App.appState = APPSTATE_BETWEENNESS; break;
+    case 15: App.appState = APPSTATE_SUMMARY; break;
+    case 16: App.appState = APPSTATE_CORES; break;
+    case 17: App.appState = APPSTATE_COMMUNITIES; break;
+    case 18: App.appState = APPSTATE_DIAMETER; break;
+    case 19: App.appState = APPSTATE_DISTANCES; break;
+    case 20: App.appState = APPSTATE_SIMILAR; break;
+    case 21: App.appState = APPSTATE_PRODUCT; break;
+    case 22: App.appState = APPSTATE_CLIQUES; break;
+    case 23: App.appState = APPSTATE_COHORT; break;
 
     // Do nothing and just remprompt
     default: App.appState = APPSTATE_MENU; break;
@@ -215,6 +277,291 @@ void App_friends() {
   App.appState = APPSTATE_MENU;
 }
 
+/**
+ * Ranks everyone by how relevant they are to a given node.
+*/
+void App_relevant() {
+
+  // The user input
+  char id[256];
+  char epsilon[256];
+  char k[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the prompts
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the people most relevant to a given node."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node to inspect."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, id);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify the precision (0 for the default)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, epsilon);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify how many people to list."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, k);
+
+  // Print the rankings; smaller precisions look further out
+  Model_printRelevant(id, atof(epsilon) > 0 ? atof(epsilon) : PERSONALRANK_EPSILON, atoi(k));
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Inspect another node? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Suggests new friends for a node, or for everyone at once.
+*/
+void App_suggest() {
+
+  // The user input
+  char id[256];
+  char metric[256];
+  char k[256];
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the prompts
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing friend suggestions."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node to inspect (- for every node)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, id);
+  UI_indent(APP_INDENT_INFO); UI_s("Rank by (1) common friends, (2) Jaccard or (3) Adamic-Adar."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, metric);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify how many people to suggest."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, k);
+
+  // Anything else counts as common friends
+  SuggestMetric pick = atoi(metric) == 2 ? SUGGEST_JACCARD : atoi(metric) == 3 ? SUGGEST_ADAMIC_ADAR : SUGGEST_COMMON;
+
+  // Suggest for everyone
+  if(!strcmp(id, MODEL_STREAM)) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify a file to write the suggestions to (- for stdout)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, outputPath);
+
+    if(!Model_writeSuggestions(pick, atoi(k) > 0 ? atoi(k) : 0, outputPath)) {
+      UI_indent(APP_INDENT_FAILURE); UI_s("Could not open the file."); UI__();
+    }
+
+  // Or just the one
+  } else {
+    Model_printSuggestions(id, pick, atoi(k));
+  }
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Suggest again? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Finds the people with friend lists like a node's, or every such pair.
+*/
+void App_similar() {
+
+  // The user input
+  char id[256];
+  char k[256];
+  char threshold[256];
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the prompts
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing people with similar friend lists."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node to inspect (- for every pair)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, id);
+
+  // Every pair above a threshold
+  if(!strcmp(id, MODEL_STREAM)) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify the least similarity (0 for the default)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, threshold);
+    UI_indent(APP_INDENT_INFO); UI_s("Specify a file to write the pairs to (- for stdout)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, outputPath);
+    UI__();
+
+    if(!Model_writeSimilarPairs(atof(threshold) > 0 ? atof(threshold) : MINHASH_THRESHOLD, outputPath)) {
+      UI_indent(APP_INDENT_FAILURE); UI_s("Could not open the file."); UI__();
+    }
+
+  // Or the best for one node
+  } else {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify how many people to list."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, k);
+    UI__();
+    Model_printSimilar(id, atoi(k));
+  }
+
+  // Offer to keep the signatures if they were just made
+  if(Model.minhash != NULL && !Model.minhash->bSaved) {
+    UI__();
+    UI_indent(APP_INDENT_INFO); UI_s("Save the signatures beside the dataset for next time? (y/n)"); UI__();
+
+    if(UI_response(APP_INDENT_PROMPT))
+      Model_saveMinHash();
+  }
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Search again? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Counts the walks of two or three hops between every pair of people.
+*/
+void App_product() {
+
+  // The user input
+  char hops[256];
+  char threshold[256];
+  char k[256];
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the prompts
+  UI_indent(APP_INDENT_INFO); UI_s("You are now counting walks between everyone."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify how many hops to walk (2 or 3)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, hops);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify the least count to keep (0 for any)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, threshold);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify the most counts to keep per person (0 for no limit)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, k);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a file to write the counts to (- for stdout)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, outputPath);
+  UI__();
+
+  // Walks back to oneself are left out
+  if(!Model_writeProduct(atoi(hops) == 3 ? 3 : 2, 
+    atof(threshold) > 0 ? atof(threshold) : SPARSE_NO_LIMIT, 
+    atoi(k) > 0 ? atoi(k) : SPARSE_NO_LIMIT, 0, outputPath)) {
+    UI_indent(APP_INDENT_FAILURE); UI_s("Could not open the file."); UI__();
+  }
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Count again? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Finds the maximal cliques of the dataset, the ones around a node, or just the largest.
+*/
+void App_cliques() {
+
+  // The user input
+  char id[256];
+  char minSize[256];
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the prompts
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing groups where everyone is friends."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node to inspect (- for every group, + for the largest)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, id);
+
+  // Just the largest
+  if(!strcmp(id, "+")) {
+    UI__();
+    Model_printMaximumClique(APP_DEFAULT_COLS);
+
+  // Or write them out
+  } else {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify the least group size to write (0 for any)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, minSize);
+    UI_indent(APP_INDENT_INFO); UI_s("Specify a file to write the groups to (- for stdout)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, outputPath);
+    UI__();
+
+    if(!Model_writeCliques(id, atoi(minSize), outputPath)) {
+      UI_indent(APP_INDENT_FAILURE); UI_s("Could not open the file."); UI__();
+    }
+  }
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Search again? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Lists everyone within a few hops of a node.
+*/
+void App_neighborhood() {
+
+  // The user input
+  char id[256];
+  char hops[256];
+  char limit[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the prompts
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the friends within k hops of a node."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node to inspect."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, id);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify how many hops out to go."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, hops);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify the most nodes to list (0 for no limit)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, limit);
+
+  // Print the neighborhood with APP_DEFAULT_COLS number of columns
+  Model_printNeighborhood(id, atoi(hops), atoi(limit) > 0 ? atoi(limit) : NEIGHBORHOOD_UNLIMITED, APP_DEFAULT_COLS);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Inspect another node? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
 /**
  * Runs the model and looks for paths within the data.
 */
@@ -238,6 +585,10 @@ void App_connections() {
   // Print the connections with the right number of cols
   Model_printConnection(sourceId, targetId, APP_DEFAULT_COLS);
 
+  // Show how well the cache is doing
+  UI__();
+  Model_printCacheStats();
+
   // Type any key to continue
   UI__();
   UI_indent(APP_INDENT_INFO); UI_s("View another connection? (y/n)"); UI__();
@@ -251,31 +602,675 @@ void App_connections() {
 }
 
 /**
- * The main process of the app.
- * Switches between the different pages.
+ * Answers a whole file of connection queries.
 */
-void App_main() {
+void App_batch() {
 
-  do {
+  // The input and output paths
+  char inputPath[256];
+  char outputPath[256];
 
-    // Print the header each time after init
-    if(App.appState != APPSTATE_INIT)
-      App_header();
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
 
-    // Execute the correct oage
-    switch(App.appState) {
-      
-      // Init the app
-      case APPSTATE_INIT: App_init(); break;
+  // Prompt for both paths
+  UI_indent(APP_INDENT_INFO); UI_s("You are now answering connections in bulk."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a file of \"node1 node2\" lines (- for stdin)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, inputPath);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a file to write the answers to (- for stdout)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, outputPath);
 
-      // Load another dataset
-      case APPSTATE_LOAD: App_load(); break;
+  // Answer everything
+  if(!Model_printConnectionFile(inputPath, outputPath)) {
+    UI_indent(APP_INDENT_FAILURE); UI_s("Could not open one of the files."); UI__();
+  }
 
-      // Load another dataset
-      case APPSTATE_FRIENDS: App_friends(); break;
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Answer another file? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
 
-      // Load another dataset
-      case APPSTATE_CONNECTIONS: App_connections(); break;
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Builds the distance index for the active dataset.
+*/
+void App_index() {
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Build it
+  UI_indent(APP_INDENT_INFO); UI_s("Building the distance index. Connections will be read off of it from now on."); UI__();
+  UI__();
+  Model_buildLandmarks();
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Shows how the model splits into connected components.
+*/
+void App_components() {
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the summary
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the connected components of the dataset."); UI__();
+  UI__();
+  Model_printComponents(APP_DEFAULT_COLS);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Shows an overview of the dataset.
+*/
+void App_summary() {
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the summary
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the summary of the dataset."); UI__();
+  UI__();
+  Model_printSummary();
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Shows the core numbers, and answers questions about them.
+*/
+void App_cores() {
+
+  // The user input
+  char id[256];
+  char k[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Print the summary
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the k-cores of the dataset."); UI__();
+  UI__();
+  Model_printCores(APP_DEFAULT_COLS);
+
+  // Prompt for a node
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node to inspect (- to skip)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, id);
+
+  if(strcmp(id, MODEL_STREAM))
+    Model_printCoreOf(id);
+
+  // Prompt for a core
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify k to list the k-core (0 to skip)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, k);
+
+  if(atoi(k) > 0)
+    Model_printKCore(atoi(k), APP_DEFAULT_COLS);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Inspect the cores again? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Splits the dataset into communities.
+*/
+void App_communities() {
+
+  // The user input
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for the method
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the communities of the dataset."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Use label propagation instead of Louvain? (y/n)"); UI__();
+  int bLabelPropagation = UI_response(APP_INDENT_PROMPT);
+
+  // Prompt for the output, if wanted
+  UI_indent(APP_INDENT_INFO); UI_s("Write the community of every node to a file? (y/n)"); UI__();
+  int bShouldWrite = UI_response(APP_INDENT_PROMPT);
+
+  if(bShouldWrite) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify the output file (- for the screen)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, outputPath);
+  }
+
+  // Print the summary
+  UI__();
+  Model_printCommunities(bLabelPropagation, bShouldWrite ? outputPath : NULL);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Detect the communities again? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Measures the diameter of the dataset, and optionally every eccentricity.
+*/
+void App_diameter() {
+
+  // The user input
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for how much to compute
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the diameter of the dataset."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Compute the eccentricity of every node too? (y/n)"); UI__();
+  int bEccentricities = UI_response(APP_INDENT_PROMPT);
+  int bShouldWrite = 0;
+
+  // Prompt for the output, if wanted
+  if(bEccentricities) {
+    UI_indent(APP_INDENT_INFO); UI_s("Write the eccentricity of every node to a file? (y/n)"); UI__();
+    bShouldWrite = UI_response(APP_INDENT_PROMPT);
+  }
+
+  if(bShouldWrite) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify the output file (- for the screen)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, outputPath);
+  }
+
+  // Print the summary
+  UI__();
+  Model_printDiameter(bEccentricities, bShouldWrite ? outputPath : NULL);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Measures the distances within a group of people read from a file.
+*/
+void App_cohort() {
+
+  // The input and output paths
+  char inputPath[256];
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for both paths
+  UI_indent(APP_INDENT_INFO); UI_s("You are now comparing the distances within a group."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a file with the ids of the group."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, inputPath);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a file to write the distance table to (- for the screen)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, outputPath);
+
+  // Measure everyone
+  UI__();
+  if(!Model_writeCohort(inputPath, outputPath)) {
+    UI_indent(APP_INDENT_FAILURE); UI_s("Could not open one of the files."); UI__();
+  }
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Shows the approximate distance distribution and harmonic centralities of the dataset.
+*/
+void App_distances() {
+
+  // The user input
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for the output, if wanted
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the distance distribution of the dataset."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Write the harmonic centrality of every node to a file? (y/n)"); UI__();
+  int bShouldWrite = UI_response(APP_INDENT_PROMPT);
+
+  if(bShouldWrite) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify the output file (- for the screen)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, outputPath);
+  }
+
+  // Print the summary
+  UI__();
+  Model_printDistances(bShouldWrite ? outputPath : NULL);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Looks for paths within the data, but gives up past the limits the user sets.
+*/
+void App_bounded() {
+
+  // The source and target ids, and the limits
+  char sourceId[256];
+  char targetId[256];
+  char hops[256];
+  char edges[256];
+  char millis[256];
+  char maskPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for both ids
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing bounded connections between two nodes."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node 1."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, sourceId);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node 2."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, targetId);
+
+  // Prompt for the limits
+  UI_indent(APP_INDENT_INFO); UI_s("Specify the most hops (0 for no limit)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, hops);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify the most adjacencies to scan (0 for no limit)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, edges);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify the most milliseconds to take (0 for no limit)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, millis);
+
+  // Prompt for the nodes the path may use
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a file of ids to pass through, prefixed with ! to avoid them instead (- for any)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, maskPath);
+
+  // Read the mask, if any
+  Bitset *pMask = NULL;
+
+  if(strcmp(maskPath, MODEL_STREAM)) {
+    pMask = Model_readMask(maskPath);
+
+    // Couldn't read it
+    if(pMask == NULL) {
+      UI_indent(APP_INDENT_FAILURE); UI_s("Could not read the file of ids."); UI__();
+    }
+  }
+
+  // Anything not positive isn't a limit
+  BFSLimits limits = {
+    pMask,
+    atoi(hops) > 0 ? atoi(hops) : BFS_NO_LIMIT,
+    atol(edges) > 0 ? atol(edges) : BFS_NO_LIMIT,
+    atof(millis) > 0 ? atof(millis) / 1000 : BFS_NO_LIMIT,
+  };
+
+  // Print the connections with the right number of cols
+  if(pMask != NULL || !strcmp(maskPath, MODEL_STREAM))
+    Model_printConnectionWithin(sourceId, targetId, &limits, APP_DEFAULT_COLS);
+
+  // Done with the mask
+  if(pMask != NULL)
+    Bitset_kill(pMask);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("View another connection? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Counts the shortest paths between two nodes.
+*/
+void App_paths() {
+
+  // The source and target ids, and the other options
+  char sourceId[256];
+  char targetId[256];
+  char samples[256];
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for both ids
+  UI_indent(APP_INDENT_INFO); UI_s("You are now counting the shortest paths between two nodes."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node 1."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, sourceId);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify a node 2."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, targetId);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify how many paths to sample."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, samples);
+
+  // Prompt for the output, if wanted
+  UI_indent(APP_INDENT_INFO); UI_s("Write the shortest-path graph to a file? (y/n)"); UI__();
+  int bShouldWrite = UI_response(APP_INDENT_PROMPT);
+
+  if(bShouldWrite) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify the output file (- for the screen)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, outputPath);
+  }
+
+  // Print the counts with the right number of cols
+  Model_printPathCount(sourceId, targetId, atoi(samples), bShouldWrite ? outputPath : NULL, APP_DEFAULT_COLS);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Count another pair? (y/n)"); UI__();
+  
+  // Stay on page if yes
+  if(UI_response(APP_INDENT_PROMPT))
+    return;
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Shows the triangle counts and clustering coefficients of the dataset.
+*/
+void App_clustering() {
+
+  // The user input
+  char outputPath[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for the output, if wanted
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the clustering of the dataset."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Write the numbers of every node to a file? (y/n)"); UI__();
+  int bShouldWrite = UI_response(APP_INDENT_PROMPT);
+
+  if(bShouldWrite) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify the output file (- for the screen)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, outputPath);
+  }
+
+  // Print the summary
+  UI__();
+  Model_printClustering(bShouldWrite ? outputPath : NULL);
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Ranks the nodes of the dataset by centrality.
+*/
+void App_centrality() {
+
+  // The user input
+  char damping[256];
+  char tolerance[256];
+  char k[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for the measure
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the most central nodes of the dataset."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Use eigenvector centrality instead of PageRank? (y/n)"); UI__();
+  int bEigenvector = UI_response(APP_INDENT_PROMPT);
+
+  // The damping only matters to PageRank
+  if(!bEigenvector) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify the damping (0 for the default)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, damping);
+  }
+
+  UI_indent(APP_INDENT_INFO); UI_s("Specify the tolerance (0 for the default)."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, tolerance);
+  UI_indent(APP_INDENT_INFO); UI_s("Specify how many nodes to list."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, k);
+
+  // Print the rankings
+  Model_printCentrality(bEigenvector,
+    !bEigenvector && atof(damping) > 0 && atof(damping) < 1 ? atof(damping) : CENTRALITY_DAMPING,
+    atof(tolerance) > 0 ? atof(tolerance) : CENTRALITY_TOLERANCE,
+    atoi(k));
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Shows the nodes that lie between the most pairs of others.
+*/
+void App_betweenness() {
+
+  // The user input
+  char samples[256];
+  char epsilon[256];
+  char k[256];
+
+  // No dataset loaded
+  if(App_hasNoDataset())
+    return;
+
+  // Prompt for how to compute it
+  UI_indent(APP_INDENT_INFO); UI_s("You are now viewing the nodes that bridge the most pairs."); UI__();
+  UI_indent(APP_INDENT_INFO); UI_s("Search from every node? (y/n)"); UI__();
+  int bExact = UI_response(APP_INDENT_PROMPT);
+  int sampleCount = 0;
+
+  // Either a fixed sample or one that grows until the error bound
+  if(!bExact) {
+    UI_indent(APP_INDENT_INFO); UI_s("Specify how many nodes to sample (0 to sample until the error bound)."); UI__(); 
+    UI_input(APP_INDENT_PROMPT, samples);
+    sampleCount = atoi(samples) > 0 ? atoi(samples) : -1;
+
+    if(sampleCount < 0) {
+      UI_indent(APP_INDENT_INFO); UI_s("Specify the error bound (0 for the default)."); UI__(); 
+      UI_input(APP_INDENT_PROMPT, epsilon);
+    }
+  }
+
+  UI_indent(APP_INDENT_INFO); UI_s("Specify how many nodes to list."); UI__(); 
+  UI_input(APP_INDENT_PROMPT, k);
+
+  // Print the rankings
+  Model_printBetweenness(sampleCount, 
+    sampleCount < 0 && atof(epsilon) > 0 ? atof(epsilon) : BETWEENNESS_EPSILON, 
+    atoi(k));
+
+  // Type any key to continue
+  UI__();
+  UI_indent(APP_INDENT_SUBINFO); UI_s("Press any key to continue."); UI__();
+  UI_response(APP_INDENT_PROMPT);
+
+  // Go to menu
+  App.appState = APPSTATE_MENU;
+}
+
+/**
+ * Answers a file of connection queries without the menu.
+ * Useful for scripting; the answers are streamed to the output in input order.
+ * 
+ * @param   { char * }  dataset     The dataset to load.
+ * @param   { char * }  inputPath   The file of pairs, or - for stdin.
+ * @param   { char * }  outputPath  The file to write to, or - for stdout.
+ * @return  { int }                 The exit code of the program.
+*/
+int App_batchOnly(char *dataset, char *inputPath, char *outputPath) {
+
+  // Load the requested dataset
+  Model_init();
+  if(!Model_loadData(dataset)) {
+    fprintf(stderr, "Could not find the specified dataset.\n");
+    return 1;
+  }
+
+  // Answer everything
+  if(!Model_printConnectionFile(inputPath, outputPath)) {
+    fprintf(stderr, "Could not open one of the files.\n");
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+ * The main process of the app.
+ * Switches between the different pages.
+*/
+void App_main() {
+
+  do {
+
+    // Print the header each time after init
+    if(App.appState != APPSTATE_INIT)
+      App_header();
+
+    // Execute the correct oage
+    switch(App.appState) {
+      
+      // Init the app
+      case APPSTATE_INIT: App_init(); break;
+
+      // Load another dataset
+      case APPSTATE_LOAD: App_load(); break;
+
+      // Load another dataset
+      case APPSTATE_FRIENDS: App_friends(); break;
+
+      // Load another dataset
+      case APPSTATE_CONNECTIONS: App_connections(); break;
+
+      // Answer a file of connections
+      case APPSTATE_BATCH: App_batch(); break;
+
+      // Build the distance index
+      case APPSTATE_INDEX: App_index(); break;
+
+      // Show the components
+      case APPSTATE_COMPONENTS: App_components(); break;
+
+      // List the friends within k hops
+      case APPSTATE_NEIGHBORHOOD: App_neighborhood(); break;
+
+      // Look for connections within limits
+      case APPSTATE_BOUNDED: App_bounded(); break;
+
+      // Count the shortest paths
+      case APPSTATE_PATHS: App_paths(); break;
+
+      // Show the clustering
+      case APPSTATE_CLUSTERING: App_clustering(); break;
+
+      // Rank by centrality
+      case APPSTATE_CENTRALITY: App_centrality(); break;
+
+      // Rank by relevance to someone
+      case APPSTATE_RELEVANT: App_relevant(); break;
+
+      // Rank by betweenness
+      case APPSTATE_BETWEENNESS: App_betweenness(); break;
+
+      // Show the summary of the dataset
+      case APPSTATE_SUMMARY: App_summary(); break;
+
+      // Show the cores
+      case APPSTATE_CORES: App_cores(); break;
+
+      // Find the communities
+      case APPSTATE_COMMUNITIES: App_communities(); break;
+
+      // Measure the diameter
+      case APPSTATE_DIAMETER: App_diameter(); break;
+
+      // Approximate the distances
+      case APPSTATE_DISTANCES: App_distances(); break;
+
+      // Suggest friends
+      case APPSTATE_SUGGEST: App_suggest(); break;
+
+      // Find similar friend lists
+      case APPSTATE_SIMILAR: App_similar(); break;
+
+      // Count walks between everyone
+      case APPSTATE_PRODUCT: App_product(); break;
+
+      // Find tight friend groups
+      case APPSTATE_CLIQUES: App_cliques(); break;
+      case APPSTATE_COHORT: App_cohort(); break;
 
       // Run the main menu of the app
       case APPSTATE_MENU: App_menu(); break;
@@ -1,7 +1,7 @@
 /**
  * @ Author: Mo David
  * @ Create Time: 2024-07-16 17:36:51
- * @ Modified time: 2024-07-19 19:12:19
+ * @ Modified time: 2026-10-18 19:55:56
  * @ Description:
  * 
  * The main file of the project.
@@ -9,7 +9,12 @@
 
 #include "./app.c"
 
-int main() {
+int main(int argc, char **argv) {
+
+  // Answer a file of connections without the menu
+  // Usage: main <dataset> <pairs file or -> <output file or ->
+  if(argc == 4)
+    return App_batchOnly(argv[1], argv[2], argv[3]);
 
   // Run the app
   App_main();
@@ -0,0 +1,208 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 19:50:12
+ * @ Modified time: 2026-10-19 07:48:20
+ * @ Description:
+ *
+ * A compact, read-only view of the adjacencies in the model.
+ * Nodes are referred to by their dense index, and the neighbors of each node are stored contiguously.
+ */
+
+#ifndef GRAPH_C
+#define GRAPH_C
+
+#include "./node.c"
+
+#include <stdlib.h>
+#include <stdint.h>
+
+// The FNV-1a constants used by the checksum
+#define GRAPH_CHECKSUM_BASIS 0xcbf29ce484222325ULL
+#define GRAPH_CHECKSUM_PRIME 0x100000001b3ULL
+
+typedef struct Graph Graph;
+
+/**
+ * Represents the adjacencies of the model in compressed sparse row form.
+ * The neighbors of node i are adjs[offsets[i]] up to (but not including) adjs[offsets[i + 1]].
+ * Each neighbor list is sorted in increasing index order, and self-loops are dropped.
+ */
+struct Graph {
+
+  // The number of nodes and the number of stored adjacencies
+  // Note that each undirected edge is stored twice
+  int nodeCount;
+  int adjCount;
+
+  // The row offsets and the flattened neighbor lists
+  int *offsets;
+  int *adjs;
+
+  // Maps a dense index back to its node
+  // The graph does not own these
+  Node **pNodes;
+};
+
+/**
+ * The graph interface.
+ */
+Graph *_Graph_alloc();
+Graph *_Graph_init(Graph *this, Node **pNodes, int nodeCount);
+Graph *Graph_new(Node **pNodes, int nodeCount);
+void Graph_kill(Graph *this);
+
+int Graph_getDegree(Graph *this, int index);
+int *Graph_getAdjs(Graph *this, int index);
+uint64_t Graph_getChecksum(Graph *this);
+
+/**
+ * Compares two indices for sorting.
+ *
+ * @param   { const void * }  a   The first index.
+ * @param   { const void * }  b   The second index.
+ * @return  { int }               The ordering of the two indices.
+*/
+static int _Graph_compareIndex(const void *a, const void *b) {
+  return *(const int *) a - *(const int *) b;
+}
+
+/**
+ * Allocates memory for a graph.
+ *
+ * @return  { Graph * }   The memory for the new graph.
+*/
+Graph *_Graph_alloc() {
+  Graph *pGraph = calloc(1, sizeof(*pGraph));
+
+  return pGraph;
+}
+
+/**
+ * Initializes the graph from the adjacency hashmaps of the given nodes.
+ * The index of each node must already be set to its position within the array.
+ *
+ * @param   { Graph * }   this        The graph to initialize.
+ * @param   { Node ** }   pNodes      The nodes of the model, ordered by index.
+ * @param   { int }       nodeCount   The number of nodes.
+ * @return  { Graph * }               The initialized graph.
+*/
+Graph *_Graph_init(Graph *this, Node **pNodes, int nodeCount) {
+
+  // Save the node references
+  this->pNodes = pNodes;
+  this->nodeCount = nodeCount;
+
+  // Allocate the offsets first
+  this->offsets = calloc(nodeCount + 1, sizeof(int));
+
+  // Count the adjacencies of each node, excluding self-loops
+  for(int i = 0; i < nodeCount; i++) {
+
+    // Grab the adjacencies
+    HashMap *adjNodes = pNodes[i]->adjNodes;
+    int degree = HashMap_getCount(adjNodes);
+
+    // Self-loops aren't needed by any of the traversals
+    if(HashMap_get(adjNodes, pNodes[i]->id) != NULL)
+      degree--;
+
+    // Prefix sum
+    this->offsets[i + 1] = this->offsets[i] + degree;
+  }
+
+  // Allocate the flattened lists
+  this->adjCount = this->offsets[nodeCount];
+  this->adjs = calloc(this->adjCount + 1, sizeof(int));
+
+  // Fill in the neighbor indices
+  for(int i = 0; i < nodeCount; i++) {
+
+    // Grab the adjacencies
+    HashMap *adjNodes = pNodes[i]->adjNodes;
+    char **keys = HashMap_getKeys(adjNodes);
+    int count = HashMap_getCount(adjNodes);
+    int *pRow = this->adjs + this->offsets[i];
+    int n = 0;
+
+    // Copy the indices of the neighbors
+    for(int j = 0; j < count; j++) {
+      Node *pAdj = HashMap_get(adjNodes, keys[j]);
+
+      // Skip self-loops
+      if(pAdj != pNodes[i])
+        pRow[n++] = pAdj->index;
+    }
+
+    // Sorted lists allow merges and binary searches later on
+    qsort(pRow, n, sizeof(int), _Graph_compareIndex);
+  }
+
+  return this;
+}
+
+/**
+ * Creates a new graph from the given nodes.
+ *
+ * @param   { Node ** }   pNodes      The nodes of the model, ordered by index.
+ * @param   { int }       nodeCount   The number of nodes.
+ * @return  { Graph * }               The new graph.
+*/
+Graph *Graph_new(Node **pNodes, int nodeCount) {
+  return _Graph_init(_Graph_alloc(), pNodes, nodeCount);
+}
+
+/**
+ * Frees the memory associated with the graph.
+ * The nodes themselves are left untouched.
+ *
+ * @param   { Graph * }   this  The graph to free.
+*/
+void Graph_kill(Graph *this) {
+  free(this->offsets);
+  free(this->adjs);
+  free(this);
+}
+
+/**
+ * Returns the number of neighbors of a node.
+ *
+ * @param   { Graph * }   this    The graph to inspect.
+ * @param   { int }       index   The index of the node.
+ * @return  { int }               The degree of the node.
+*/
+int Graph_getDegree(Graph *this, int index) {
+  return this->offsets[index + 1] - this->offsets[index];
+}
+
+/**
+ * Returns a pointer to the sorted neighbors of a node.
+ *
+ * @param   { Graph * }   this    The graph to inspect.
+ * @param   { int }       index   The index of the node.
+ * @return  { int * }             The start of the neighbor list.
+*/
+int *Graph_getAdjs(Graph *this, int index) {
+  return this->adjs + this->offsets[index];
+}
+
+/**
+ * Hashes the offsets and the neighbor lists, so that files saved for one graph can be told apart from another's.
+ * Two graphs with the same number of nodes and edges almost surely still differ here.
+ *
+ * @param   { Graph * }   this  The graph to hash.
+ * @return  { uint64_t }        The checksum of the graph.
+*/
+uint64_t Graph_getChecksum(Graph *this) {
+  uint64_t hash = GRAPH_CHECKSUM_BASIS;
+
+  // The offsets fix the degrees, then the lists fix who the neighbors are
+  for(int i = 0; i <= this->nodeCount; i++)
+    hash = (hash ^ (uint32_t) this->offsets[i]) * GRAPH_CHECKSUM_PRIME;
+
+  for(int i = 0; i < this->adjCount; i++)
+    hash = (hash ^ (uint32_t) this->adjs[i]) * GRAPH_CHECKSUM_PRIME;
+
+  return hash;
+}
+
+#endif
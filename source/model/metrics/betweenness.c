@@ -0,0 +1,495 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 01:48:06
+ * @ Modified time: 2026-10-19 08:47:05
+ * @ Description:
+ *
+ * Betweenness centrality by Brandes' algorithm: one search per source, then the dependencies are summed back up.
+ * Sources are split across threads, and each thread sums into its own scores until the end.
+ * Instead of every source, a random sample can be used, either of a fixed size or until the error is small enough.
+ */
+
+#ifndef BETWEENNESS_C
+#define BETWEENNESS_C
+
+#include "../graph.c"
+#include "../../utils/thread.c"
+#include "../../utils/timer.c"
+#include "../../utils/topk.c"
+
+#include <stdlib.h>
+#include <stdint.h>
+
+// The defaults of the sampling
+#define BETWEENNESS_EPSILON 0.01
+#define BETWEENNESS_MAX_SAMPLES 4096
+
+// The fewest sources to sample before trusting the error estimate
+#define BETWEENNESS_MIN_SAMPLES 64
+
+// How many sources each thread claims at a time
+#define BETWEENNESS_CHUNK 4
+
+// Unreached nodes
+#define BETWEENNESS_UNVISITED (-1)
+
+typedef struct Betweenness Betweenness;
+typedef struct BetweennessJob BetweennessJob;
+
+/**
+ * The betweenness of every node, and how it was computed.
+ * Scores count unordered pairs, so a node bridging two otherwise unconnected halves of size a and b scores a * b.
+ */
+struct Betweenness {
+
+  // How many nodes there are, and their scores
+  int nodeCount;
+  double *pScores;
+
+  // How many sources were searched, and whether that was all of them
+  int sourceCount;
+  int bExact;
+
+  // The bound asked for when sampling adaptively, and whether every node reached it
+  double epsilon;
+  int bPrecise;
+
+  // How many adjacencies were scanned, and how long everything took
+  long edgeCount;
+  double seconds;
+};
+
+/**
+ * The state shared by the threads running the searches.
+ * Each thread gets its own search buffers and its own sums.
+ */
+struct BetweennessJob {
+
+  // The graph being scored, and the sources in the order they're searched
+  Graph *pGraph;
+  int *pSources;
+
+  // Where the range handed to the threads starts within the sources
+  int offset;
+
+  // The search buffers of each thread
+  int *pDistances[THREAD_MAX_COUNT];
+  double *pPaths[THREAD_MAX_COUNT];
+  double *pDependencies[THREAD_MAX_COUNT];
+  int *pOrders[THREAD_MAX_COUNT];
+
+  // The sums of each thread; the squares are only kept for estimating the error
+  double *pSums[THREAD_MAX_COUNT];
+  double *pSquares[THREAD_MAX_COUNT];
+  long edgeCounts[THREAD_MAX_COUNT];
+};
+
+/**
+ * The betweenness interface.
+ */
+Betweenness *_Betweenness_alloc();
+Betweenness *_Betweenness_init(Betweenness *this, Graph *pGraph);
+Betweenness *Betweenness_newExact(Graph *pGraph);
+Betweenness *Betweenness_newSampled(Graph *pGraph, int sampleCount);
+Betweenness *Betweenness_newAdaptive(Graph *pGraph, double epsilon, int maxSamples);
+void Betweenness_kill(Betweenness *this);
+
+BetweennessJob *_BetweennessJob_new(Graph *pGraph, int bShouldSquare);
+void _BetweennessJob_kill(BetweennessJob *pJob);
+
+void _Betweenness_search(void *pArgs, int thread, int start, int end);
+int _Betweenness_isPrecise(BetweennessJob *pJob, int n, int sampleCount, double epsilon);
+void _Betweenness_finish(Betweenness *this, BetweennessJob *pJob, double start);
+int Betweenness_getTop(Betweenness *this, int k, int *pTop);
+double Betweenness_getNormalized(Betweenness *this, int node);
+
+/**
+ * Allocates memory for the scores.
+ *
+ * @return  { Betweenness * }   The memory for the scores.
+ */
+Betweenness *_Betweenness_alloc() {
+  Betweenness *pBetweenness = calloc(1, sizeof(*pBetweenness));
+
+  return pBetweenness;
+}
+
+/**
+ * Initializes the scores of a graph to zero.
+ *
+ * @param   { Betweenness * }   this    The scores to initialize.
+ * @param   { Graph * }         pGraph  The graph to score.
+ * @return  { Betweenness * }           The initialized scores.
+ */
+Betweenness *_Betweenness_init(Betweenness *this, Graph *pGraph) {
+
+  // Nothing is between anything yet
+  this->nodeCount = pGraph->nodeCount;
+  this->pScores = calloc(pGraph->nodeCount + 1, sizeof(double));
+  this->sourceCount = 0;
+  this->bExact = 0;
+  this->epsilon = 0;
+  this->bPrecise = 0;
+  this->edgeCount = 0;
+  this->seconds = 0;
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with the scores.
+ *
+ * @param   { Betweenness * }   this  The scores to free.
+ */
+void Betweenness_kill(Betweenness *this) {
+  free(this->pScores);
+  free(this);
+}
+
+/**
+ * Creates the shared state of the searches, with the sources shuffled.
+ * The buffers of each thread are cleared, since every search cleans up after itself.
+ *
+ * @param   { Graph * }             pGraph          The graph to score.
+ * @param   { int }                 bShouldSquare   Whether to sum the squares of the dependencies too.
+ * @return  { BetweennessJob * }                    The shared state.
+ */
+BetweennessJob *_BetweennessJob_new(Graph *pGraph, int bShouldSquare) {
+  int n = pGraph->nodeCount;
+  BetweennessJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+
+  // Shuffle the sources (Fisher-Yates with xorshift), so any prefix is a uniform sample
+  uint64_t seed = 0x9e3779b97f4a7c15ULL;
+  pJob->pSources = malloc((n + 1) * sizeof(int));
+
+  for(int i = 0; i < n; i++)
+    pJob->pSources[i] = i;
+
+  for(int i = n - 1; i > 0; i--) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+
+    int j = seed % (i + 1);
+    int temp = pJob->pSources[i];
+    pJob->pSources[i] = pJob->pSources[j];
+    pJob->pSources[j] = temp;
+  }
+
+  // Give each thread its buffers
+  for(int t = 0; t < Thread_getCount(); t++) {
+    pJob->pDistances[t] = malloc((n + 1) * sizeof(int));
+    pJob->pPaths[t] = calloc(n + 1, sizeof(double));
+    pJob->pDependencies[t] = calloc(n + 1, sizeof(double));
+    pJob->pOrders[t] = malloc((n + 1) * sizeof(int));
+    pJob->pSums[t] = calloc(n + 1, sizeof(double));
+    pJob->pSquares[t] = bShouldSquare ? calloc(n + 1, sizeof(double)) : NULL;
+
+    for(int i = 0; i < n; i++)
+      pJob->pDistances[t][i] = BETWEENNESS_UNVISITED;
+  }
+
+  return pJob;
+}
+
+/**
+ * Frees the shared state of the searches.
+ *
+ * @param   { BetweennessJob * }  pJob  The state to free.
+ */
+void _BetweennessJob_kill(BetweennessJob *pJob) {
+  for(int t = 0; t < Thread_getCount(); t++) {
+    free(pJob->pDistances[t]);
+    free(pJob->pPaths[t]);
+    free(pJob->pDependencies[t]);
+    free(pJob->pOrders[t]);
+    free(pJob->pSums[t]);
+    free(pJob->pSquares[t]);
+  }
+
+  free(pJob->pSources);
+  free(pJob);
+}
+
+/**
+ * Runs Brandes' algorithm from the sources within the given range.
+ * A search counts the shortest paths to every node, then walks back in order of decreasing distance,
+ * passing each node's dependency on to its neighbors one level closer. Only the reached nodes are reset.
+ *
+ * @param   { void * }  pArgs   The shared BetweennessJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first source to search, counted from the offset.
+ * @param   { int }     end     One past the last source to search.
+ */
+void _Betweenness_search(void *pArgs, int thread, int start, int end) {
+  BetweennessJob *pJob = pArgs;
+  Graph *pGraph = pJob->pGraph;
+  int *pDistances = pJob->pDistances[thread];
+  double *pPaths = pJob->pPaths[thread];
+  double *pDependencies = pJob->pDependencies[thread];
+  int *pOrder = pJob->pOrders[thread];
+  double *pSums = pJob->pSums[thread];
+  double *pSquares = pJob->pSquares[thread];
+  long edgeCount = 0;
+
+  // One search per source
+  for(int i = start; i < end; i++) {
+    int s = pJob->pSources[pJob->offset + i];
+    int count = 0;
+
+    // Seed the source
+    pDistances[s] = 0;
+    pPaths[s] = 1;
+    pOrder[count++] = s;
+
+    // Count the shortest paths; the order doubles as the queue
+    for(int head = 0; head < count; head++) {
+      int u = pOrder[head];
+      int *pAdjs = Graph_getAdjs(pGraph, u);
+      int degree = Graph_getDegree(pGraph, u);
+
+      edgeCount += degree;
+
+      for(int j = 0; j < degree; j++) {
+        int v = pAdjs[j];
+
+        // First time here
+        if(pDistances[v] == BETWEENNESS_UNVISITED) {
+          pDistances[v] = pDistances[u] + 1;
+          pOrder[count++] = v;
+        }
+
+        // Another way in at the same level
+        if(pDistances[v] == pDistances[u] + 1)
+          pPaths[v] += pPaths[u];
+      }
+    }
+
+    // Sum the dependencies back up, farthest first
+    for(int head = count - 1; head > 0; head--) {
+      int w = pOrder[head];
+      int *pAdjs = Graph_getAdjs(pGraph, w);
+      int degree = Graph_getDegree(pGraph, w);
+      double factor = (1 + pDependencies[w]) / pPaths[w];
+
+      for(int j = 0; j < degree; j++) {
+        int v = pAdjs[j];
+
+        // Only the level closer to the source
+        if(pDistances[v] == pDistances[w] - 1)
+          pDependencies[v] += pPaths[v] * factor;
+      }
+
+      // Save it before the reset
+      pSums[w] += pDependencies[w];
+
+      if(pSquares != NULL)
+        pSquares[w] += pDependencies[w] * pDependencies[w];
+    }
+
+    // Forget the search
+    for(int head = 0; head < count; head++) {
+      int u = pOrder[head];
+      pDistances[u] = BETWEENNESS_UNVISITED;
+      pPaths[u] = 0;
+      pDependencies[u] = 0;
+    }
+  }
+
+  pJob->edgeCounts[thread] += edgeCount;
+}
+
+/**
+ * Checks whether the scores sampled so far are likely within the bound of the true ones.
+ * Each source gives every node a dependency of at most n - 2, so those are scaled to [0, 1] and the normalized
+ * score is their mean. The standard error of that mean must be at most half the bound for every node,
+ * which puts each one within the bound with about 95% confidence.
+ *
+ * @param   { BetweennessJob * }  pJob          The state of the searches.
+ * @param   { int }               n             How many nodes there are.
+ * @param   { int }               sampleCount   How many sources were searched.
+ * @param   { double }            epsilon       The bound on the normalized scores.
+ * @return  { int }                             Whether or not every node is within the bound.
+ */
+int _Betweenness_isPrecise(BetweennessJob *pJob, int n, int sampleCount, double epsilon) {
+  double scale = n > 2 ? 1.0 / (n - 2) : 0;
+
+  // Too few to trust
+  if(sampleCount < 2)
+    return 0;
+
+  // Check every node
+  for(int v = 0; v < n; v++) {
+    double sum = 0;
+    double squares = 0;
+
+    for(int t = 0; t < Thread_getCount(); t++) {
+      sum += pJob->pSums[t][v];
+      squares += pJob->pSquares[t][v];
+    }
+
+    // The sample variance of the scaled dependencies
+    double mean = sum * scale / sampleCount;
+    double variance = (squares * scale * scale / sampleCount - mean * mean) * sampleCount / (sampleCount - 1);
+
+    // Compare squares, so no root is needed: (2 * stderr)^2 <= epsilon^2
+    if(4 * variance / sampleCount > epsilon * epsilon)
+      return 0;
+  }
+
+  return 1;
+}
+
+/**
+ * Sums up what each thread found, then scales the scores to the whole graph.
+ * Every pair is found from both of its ends when all sources are searched, so the sums are halved.
+ * A sample of k sources is scaled up by n / k.
+ *
+ * @param   { Betweenness * }     this    The scores to fill in.
+ * @param   { BetweennessJob * }  pJob    The state of the searches.
+ * @param   { double }            start   When the computation started.
+ */
+void _Betweenness_finish(Betweenness *this, BetweennessJob *pJob, double start) {
+  int n = this->nodeCount;
+  double scale = this->sourceCount ? (double) n / this->sourceCount / 2 : 0;
+
+  // Add up the threads
+  for(int t = 0; t < Thread_getCount(); t++) {
+    for(int v = 0; v < n; v++)
+      this->pScores[v] += pJob->pSums[t][v];
+
+    this->edgeCount += pJob->edgeCounts[t];
+  }
+
+  // Scale to the whole graph
+  for(int v = 0; v < n; v++)
+    this->pScores[v] *= scale;
+
+  this->seconds = Timer_now() - start;
+}
+
+/**
+ * Computes the exact betweenness of every node, searching from every source.
+ * This takes one breadth-first search per node.
+ *
+ * @param   { Graph * }         pGraph  The graph to score.
+ * @return  { Betweenness * }           The scores.
+ */
+Betweenness *Betweenness_newExact(Graph *pGraph) {
+  double start = Timer_now();
+  Betweenness *this = _Betweenness_init(_Betweenness_alloc(), pGraph);
+  BetweennessJob *pJob = _BetweennessJob_new(pGraph, 0);
+
+  // Every source
+  Thread_parallelFor(pGraph->nodeCount, BETWEENNESS_CHUNK, _Betweenness_search, pJob);
+  this->sourceCount = pGraph->nodeCount;
+  this->bExact = 1;
+
+  _Betweenness_finish(this, pJob, start);
+  _BetweennessJob_kill(pJob);
+
+  return this;
+}
+
+/**
+ * Estimates the betweenness of every node from a uniform sample of sources.
+ * Asking for at least as many sources as there are nodes gives the exact scores.
+ *
+ * @param   { Graph * }         pGraph        The graph to score.
+ * @param   { int }             sampleCount   How many sources to search.
+ * @return  { Betweenness * }                 The estimated scores.
+ */
+Betweenness *Betweenness_newSampled(Graph *pGraph, int sampleCount) {
+
+  // That's all of them
+  if(sampleCount >= pGraph->nodeCount)
+    return Betweenness_newExact(pGraph);
+
+  double start = Timer_now();
+  Betweenness *this = _Betweenness_init(_Betweenness_alloc(), pGraph);
+  BetweennessJob *pJob = _BetweennessJob_new(pGraph, 0);
+
+  // The sources are shuffled, so the first few are a sample
+  Thread_parallelFor(sampleCount, BETWEENNESS_CHUNK, _Betweenness_search, pJob);
+  this->sourceCount = sampleCount;
+
+  _Betweenness_finish(this, pJob, start);
+  _BetweennessJob_kill(pJob);
+
+  return this;
+}
+
+/**
+ * Estimates the betweenness of every node, sampling sources until the error is likely small enough.
+ * The sample doubles each round, and stops once every normalized score is within epsilon with about 95% confidence,
+ * or once it hits the maximum. Running out of sources gives the exact scores.
+ *
+ * @param   { Graph * }         pGraph      The graph to score.
+ * @param   { double }          epsilon     The bound on the error of the normalized scores.
+ * @param   { int }             maxSamples  The most sources to search.
+ * @return  { Betweenness * }               The estimated scores.
+ */
+Betweenness *Betweenness_newAdaptive(Graph *pGraph, double epsilon, int maxSamples) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Betweenness *this = _Betweenness_init(_Betweenness_alloc(), pGraph);
+  BetweennessJob *pJob = _BetweennessJob_new(pGraph, 1);
+
+  // Can't go past the sources there are
+  if(maxSamples > n)
+    maxSamples = n;
+
+  this->epsilon = epsilon;
+
+  // Sample in rounds, each as big as everything before it
+  while(this->sourceCount < maxSamples && !this->bPrecise) {
+    int next = this->sourceCount < BETWEENNESS_MIN_SAMPLES ? BETWEENNESS_MIN_SAMPLES : this->sourceCount * 2;
+
+    if(next > maxSamples)
+      next = maxSamples;
+
+    // Only search the new sources
+    pJob->offset = this->sourceCount;
+    Thread_parallelFor(next - this->sourceCount, BETWEENNESS_CHUNK, _Betweenness_search, pJob);
+
+    this->sourceCount = next;
+    this->bPrecise = _Betweenness_isPrecise(pJob, n, this->sourceCount, epsilon);
+  }
+
+  // Every source was searched
+  this->bExact = this->sourceCount == n;
+  this->bPrecise |= this->bExact;
+
+  _Betweenness_finish(this, pJob, start);
+  _BetweennessJob_kill(pJob);
+
+  return this;
+}
+
+/**
+ * Gives the score of a node as a fraction of the pairs it could lie between.
+ *
+ * @param   { Betweenness * }   this  The scores to read.
+ * @param   { int }             node  The node to check.
+ * @return  { double }                The normalized score, between 0 and 1.
+ */
+double Betweenness_getNormalized(Betweenness *this, int node) {
+  double pairs = (double) (this->nodeCount - 1) * (this->nodeCount - 2) / 2;
+
+  return pairs > 0 ? this->pScores[node] / pairs : 0;
+}
+
+/**
+ * Finds the nodes with the highest scores, best first.
+ *
+ * @param   { Betweenness * }   this  The scores to rank.
+ * @param   { int }             k     How many nodes to find.
+ * @param   { int * }           pTop  Where to write the nodes; must hold k entries.
+ * @return  { int }                   How many nodes were written.
+ */
+int Betweenness_getTop(Betweenness *this, int k, int *pTop) {
+  return TopK_select(this->pScores, this->nodeCount, k, pTop);
+}
+
+#endif
@@ -0,0 +1,389 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 20:12:40
+ * @ Modified time: 2026-10-19 08:47:05
+ * @ Description:
+ *
+ * Global centrality scores by power iteration: PageRank and eigenvector centrality.
+ * Each iteration pulls the scores of a node's neighbors over the compact graph, so nodes can be split across threads
+ * without any two threads writing to the same score.
+ */
+
+#ifndef CENTRALITY_C
+#define CENTRALITY_C
+
+#include "../graph.c"
+#include "../../utils/thread.c"
+#include "../../utils/timer.c"
+#include "../../utils/topk.c"
+
+#include <stdlib.h>
+
+// The defaults of the iterations
+#define CENTRALITY_DAMPING 0.85
+#define CENTRALITY_TOLERANCE 1e-9
+#define CENTRALITY_MAX_ITERATIONS 200
+
+// How many nodes each thread claims at a time
+#define CENTRALITY_CHUNK 1024
+
+// The scores are doubles unless built with -DCENTRALITY_FLOAT
+// Floats halve the memory traffic, but can't reach tolerances much below 1e-7
+#ifdef CENTRALITY_FLOAT
+typedef float CentralityScore;
+#else
+typedef double CentralityScore;
+#endif
+
+typedef struct Centrality Centrality;
+typedef struct CentralityJob CentralityJob;
+
+/**
+ * The scores of every node, and how the iterations went.
+ */
+struct Centrality {
+
+  // How many nodes there are, and their scores
+  int nodeCount;
+  CentralityScore *pScores;
+
+  // How many iterations ran, and the change over the last one
+  int iterations;
+  double residual;
+  int bConverged;
+
+  // How long everything took
+  double seconds;
+};
+
+/**
+ * The state shared by the threads running an iteration.
+ */
+struct CentralityJob {
+
+  // The graph being scored
+  Graph *pGraph;
+
+  // The scores before and after the iteration, and what each node passes on
+  CentralityScore *pScores;
+  CentralityScore *pNext;
+  CentralityScore *pShares;
+
+  // What every node gets regardless of its neighbors, and how much the neighbors' part is scaled by
+  double base;
+  double damping;
+
+  // Whether each node keeps its own score, which damps the oscillations of eigenvector iterations
+  int bShouldKeep;
+
+  // The sums of each thread
+  double sums[THREAD_MAX_COUNT];
+  double totals[THREAD_MAX_COUNT];
+};
+
+/**
+ * The centrality interface.
+ */
+Centrality *_Centrality_alloc();
+Centrality *_Centrality_init(Centrality *this, int nodeCount);
+Centrality *Centrality_newPageRank(Graph *pGraph, double damping, double tolerance, int maxIterations);
+Centrality *Centrality_newEigenvector(Graph *pGraph, double tolerance, int maxIterations);
+void Centrality_kill(Centrality *this);
+
+void _Centrality_share(void *pArgs, int thread, int start, int end);
+void _Centrality_pull(void *pArgs, int thread, int start, int end);
+void _Centrality_scale(void *pArgs, int thread, int start, int end);
+double _Centrality_sum(CentralityJob *pJob, double *pSums);
+int Centrality_getTop(Centrality *this, int k, int *pTop);
+
+/**
+ * Allocates memory for the scores.
+ *
+ * @return  { Centrality * }  The memory for the scores.
+ */
+Centrality *_Centrality_alloc() {
+  Centrality *pCentrality = calloc(1, sizeof(*pCentrality));
+
+  return pCentrality;
+}
+
+/**
+ * Initializes the scores to a uniform distribution.
+ *
+ * @param   { Centrality * }  this        The scores to initialize.
+ * @param   { int }           nodeCount   How many nodes there are.
+ * @return  { Centrality * }              The initialized scores.
+ */
+Centrality *_Centrality_init(Centrality *this, int nodeCount) {
+
+  // Start out uniform
+  this->nodeCount = nodeCount;
+  this->pScores = malloc((nodeCount + 1) * sizeof(CentralityScore));
+
+  for(int i = 0; i < nodeCount; i++)
+    this->pScores[i] = (CentralityScore) 1 / nodeCount;
+
+  // Nothing ran yet
+  this->iterations = 0;
+  this->residual = 0;
+  this->bConverged = 0;
+  this->seconds = 0;
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with the scores.
+ *
+ * @param   { Centrality * }  this  The scores to free.
+ */
+void Centrality_kill(Centrality *this) {
+  free(this->pScores);
+  free(this);
+}
+
+/**
+ * Computes what each node within the given range passes on to each of its neighbors.
+ * Also sums the scores of the nodes with no neighbors, since theirs has nowhere to go.
+ *
+ * @param   { void * }  pArgs   The shared CentralityJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to compute.
+ * @param   { int }     end     One past the last node to compute.
+ */
+void _Centrality_share(void *pArgs, int thread, int start, int end) {
+  CentralityJob *pJob = pArgs;
+  double dangling = 0;
+
+  // Split each score evenly among the neighbors
+  for(int u = start; u < end; u++) {
+    int degree = Graph_getDegree(pJob->pGraph, u);
+
+    if(degree)
+      pJob->pShares[u] = pJob->pScores[u] / degree;
+    else
+      dangling += pJob->pScores[u];
+  }
+
+  pJob->sums[thread] += dangling;
+}
+
+/**
+ * Pulls the shares of the neighbors into the new scores of the nodes within the given range.
+ * Also sums the new scores, for normalizing.
+ *
+ * @param   { void * }  pArgs   The shared CentralityJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to update.
+ * @param   { int }     end     One past the last node to update.
+ */
+void _Centrality_pull(void *pArgs, int thread, int start, int end) {
+  CentralityJob *pJob = pArgs;
+  Graph *pGraph = pJob->pGraph;
+  CentralityScore *pShares = pJob->pShares;
+  double total = 0;
+
+  // Gather for each node
+  for(int v = start; v < end; v++) {
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+    double sum = pJob->bShouldKeep ? pJob->pScores[v] : 0;
+
+    for(int j = 0; j < degree; j++)
+      sum += pShares[pAdjs[j]];
+
+    pJob->pNext[v] = pJob->base + pJob->damping * sum;
+    total += pJob->pNext[v];
+  }
+
+  pJob->totals[thread] += total;
+}
+
+/**
+ * Scales the new scores of the nodes within the given range, then measures how far they moved.
+ * The scale is passed through the base of the job.
+ *
+ * @param   { void * }  pArgs   The shared CentralityJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to scale.
+ * @param   { int }     end     One past the last node to scale.
+ */
+void _Centrality_scale(void *pArgs, int thread, int start, int end) {
+  CentralityJob *pJob = pArgs;
+  double change = 0;
+
+  // Scale and compare
+  for(int v = start; v < end; v++) {
+    pJob->pNext[v] *= pJob->base;
+    change += pJob->pNext[v] > pJob->pScores[v] ? pJob->pNext[v] - pJob->pScores[v] : pJob->pScores[v] - pJob->pNext[v];
+  }
+
+  pJob->sums[thread] += change;
+}
+
+/**
+ * Adds up and clears the per-thread sums of a job.
+ *
+ * @param   { CentralityJob * }   pJob    The job to read.
+ * @param   { double * }          pSums   Which of its sums to add up.
+ * @return  { double }                    The total.
+ */
+double _Centrality_sum(CentralityJob *pJob, double *pSums) {
+  double total = 0;
+
+  for(int t = 0; t < THREAD_MAX_COUNT; t++) {
+    total += pSums[t];
+    pSums[t] = 0;
+  }
+
+  return total;
+}
+
+/**
+ * Ranks the nodes by PageRank.
+ * A random surfer follows a random edge with the given probability, and jumps to a random node otherwise.
+ * Nodes without edges spread their score over everyone. Stops once the scores move by less than the tolerance in total.
+ *
+ * @param   { Graph * }       pGraph          The graph to score.
+ * @param   { double }        damping         How likely the surfer is to follow an edge.
+ * @param   { double }        tolerance       How little the scores must move, summed over all nodes, to stop.
+ * @param   { int }           maxIterations   How many iterations to run at most.
+ * @return  { Centrality * }                  The scores, which sum to 1.
+ */
+Centrality *Centrality_newPageRank(Graph *pGraph, double damping, double tolerance, int maxIterations) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Centrality *this = _Centrality_init(_Centrality_alloc(), n);
+
+  // The shared state
+  CentralityJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+  pJob->pScores = this->pScores;
+  pJob->pNext = malloc((n + 1) * sizeof(CentralityScore));
+  pJob->pShares = malloc((n + 1) * sizeof(CentralityScore));
+  pJob->damping = damping;
+  pJob->bShouldKeep = 0;
+
+  // Iterate until the scores settle
+  while(this->iterations < maxIterations && !this->bConverged) {
+
+    // What each node passes on, and what's lost to nodes with no edges
+    Thread_parallelFor(n, CENTRALITY_CHUNK, _Centrality_share, pJob);
+    double dangling = _Centrality_sum(pJob, pJob->sums);
+
+    // Everyone gets the random jumps and the lost score
+    pJob->base = ((1 - damping) + damping * dangling) / n;
+    Thread_parallelFor(n, CENTRALITY_CHUNK, _Centrality_pull, pJob);
+    _Centrality_sum(pJob, pJob->totals);
+
+    // The scores already sum to 1, so only measure the change
+    pJob->base = 1;
+    Thread_parallelFor(n, CENTRALITY_CHUNK, _Centrality_scale, pJob);
+    this->residual = _Centrality_sum(pJob, pJob->sums);
+
+    // Swap the buffers
+    CentralityScore *pTemp = pJob->pScores;
+    pJob->pScores = pJob->pNext;
+    pJob->pNext = pTemp;
+
+    this->iterations++;
+    this->bConverged = this->residual < tolerance;
+  }
+
+  // Keep whichever buffer ended up with the scores
+  this->pScores = pJob->pScores;
+  free(pJob->pNext);
+  free(pJob->pShares);
+  free(pJob);
+
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+/**
+ * Ranks the nodes by eigenvector centrality: each node scores in proportion to the sum of its neighbors' scores.
+ * Each iteration multiplies by the adjacency matrix plus the identity, which has the same leading eigenvector
+ * but doesn't oscillate on bipartite parts of the graph. Stops once the scores move by less than the tolerance in total.
+ * The scores are scaled to sum to 1 like PageRank's, rather than to unit length, so the two can be compared.
+ *
+ * @param   { Graph * }       pGraph          The graph to score.
+ * @param   { double }        tolerance       How little the scores must move, summed over all nodes, to stop.
+ * @param   { int }           maxIterations   How many iterations to run at most.
+ * @return  { Centrality * }                  The scores, which sum to 1.
+ */
+Centrality *Centrality_newEigenvector(Graph *pGraph, double tolerance, int maxIterations) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Centrality *this = _Centrality_init(_Centrality_alloc(), n);
+
+  // The shared state; nodes pass on their whole score
+  CentralityJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+  pJob->pScores = this->pScores;
+  pJob->pNext = malloc((n + 1) * sizeof(CentralityScore));
+  pJob->pShares = this->pScores;
+  pJob->base = 0;
+  pJob->damping = 1;
+  pJob->bShouldKeep = 1;
+
+  // Iterate until the scores settle
+  while(this->iterations < maxIterations && !this->bConverged) {
+
+    // Multiply
+    pJob->base = 0;
+    pJob->pShares = pJob->pScores;
+    Thread_parallelFor(n, CENTRALITY_CHUNK, _Centrality_pull, pJob);
+    double total = _Centrality_sum(pJob, pJob->totals);
+
+    // Then scale it back down
+    pJob->base = total > 0 ? 1 / total : 0;
+    Thread_parallelFor(n, CENTRALITY_CHUNK, _Centrality_scale, pJob);
+    this->residual = _Centrality_sum(pJob, pJob->sums);
+
+    // Swap the buffers
+    CentralityScore *pTemp = pJob->pScores;
+    pJob->pScores = pJob->pNext;
+    pJob->pNext = pTemp;
+
+    this->iterations++;
+    this->bConverged = this->residual < tolerance;
+  }
+
+  // Keep whichever buffer ended up with the scores
+  this->pScores = pJob->pScores;
+  free(pJob->pNext);
+  free(pJob);
+
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+/**
+ * Finds the nodes with the highest scores, best first.
+ *
+ * @param   { Centrality * }  this  The scores to rank.
+ * @param   { int }           k     How many nodes to find.
+ * @param   { int * }         pTop  Where to write the nodes; must hold k entries.
+ * @return  { int }                 How many nodes were written.
+ */
+int Centrality_getTop(Centrality *this, int k, int *pTop) {
+
+// Float scores have to be widened first
+#ifdef CENTRALITY_FLOAT
+  double *pScores = malloc((this->nodeCount + 1) * sizeof(double));
+
+  for(int i = 0; i < this->nodeCount; i++)
+    pScores[i] = this->pScores[i];
+
+  int count = TopK_select(pScores, this->nodeCount, k, pTop);
+  free(pScores);
+
+  return count;
+#else
+  return TopK_select(this->pScores, this->nodeCount, k, pTop);
+#endif
+}
+
+#endif
@@ -0,0 +1,658 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 07:12:05
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ *
+ * Enumerates the maximal cliques of the graph (Bron and Kerbosch, with the pivoting of Tomita et al.).
+ * Every clique is found from whichever of its members comes first in a degeneracy ordering (Eppstein et al.),
+ * so each node only has to search among its own neighbors, and at most the degeneracy of them come after it.
+ * Within that neighborhood the candidate and excluded sets are bitsets, so every step is a few word operations.
+ * The nodes are searched from in parallel, and the cliques are handed out in small batches as they're found.
+ */
+
+#ifndef CLIQUES_C
+#define CLIQUES_C
+
+#include "../graph.c"
+#include "./cores.c"
+#include "../../utils/thread.c"
+#include "../../utils/timer.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// How many nodes each thread searches from at a time; the work per node varies a lot
+#define CLIQUES_CHUNK 4
+
+// How many ids a thread collects before handing its cliques over
+#define CLIQUES_FLUSH 4096
+
+// Local nodes not in the neighborhood being searched
+#define CLIQUES_OUTSIDE (-1)
+
+typedef struct Cliques Cliques;
+typedef struct CliquesWorker CliquesWorker;
+
+/**
+ * Called for every maximal clique found, one at a time.
+ * It receives the shared arguments, the members of the clique, and how many there are.
+ */
+typedef void (*CliqueVisit)(void *pArgs, int *pClique, int size);
+
+/**
+ * The state of a single thread searching for cliques.
+ */
+struct CliquesWorker {
+
+  // The local index of every node in the neighborhood being searched, and the node of each local index
+  int *pLocal;
+  int *pNodes;
+  int localCount;
+  int wordCount;
+
+  // The neighbors of every local node, as bitsets over the neighborhood
+  uint64_t *pAdjacency;
+  long adjacencyLimit;
+
+  // The candidates, the excluded and the branches of each level of the search
+  uint64_t *pSets;
+  long setLimit;
+
+  // The clique being grown
+  int *pClique;
+  int size;
+
+  // The cliques waiting to be handed over, each as its size followed by its members
+  int *pBuffer;
+  int bufferCount;
+
+  // How many maximal cliques it found, of each size, and how many calls it took
+  long cliqueCount;
+  long *pSizeCounts;
+  long callCount;
+};
+
+/**
+ * The maximal cliques of a graph.
+ */
+struct Cliques {
+
+  // The graph, and how many nodes it has
+  Graph *pGraph;
+  int nodeCount;
+
+  // A degeneracy ordering, where each node is in it, and the most neighbors any node has after itself
+  int *pOrder;
+  int *pRanks;
+  int degeneracy;
+
+  // What to do with each clique, and how big one has to be to be handed over
+  CliqueVisit pVisit;
+  void *pArgs;
+  int minSize;
+
+  // Whether only the largest clique is being looked for
+  int bMaximum;
+
+  // The largest clique found so far
+  int maxSize;
+  int *pMaximum;
+
+  // Keeps the threads from handing over cliques or a new largest clique at the same time
+  pthread_mutex_t lock;
+
+  // How many maximal cliques the last search found, of each size up to degeneracy + 1, and how many were handed over
+  long cliqueCount;
+  long *pSizeCounts;
+  long visitCount;
+
+  // How many recursive calls the last search made, and how long it took
+  long callCount;
+  double seconds;
+
+  // The state of each thread
+  CliquesWorker *pWorkers[THREAD_MAX_COUNT];
+};
+
+/**
+ * The cliques interface.
+ */
+Cliques *_Cliques_alloc();
+Cliques *_Cliques_init(Cliques *this, Graph *pGraph);
+Cliques *Cliques_new(Graph *pGraph);
+void Cliques_kill(Cliques *this);
+
+CliquesWorker *_Cliques_getWorker(Cliques *this, int thread);
+void _Cliques_prepare(Cliques *this, CliquesWorker *pWorker, int root, int bEveryNeighbor);
+void _Cliques_report(Cliques *this, CliquesWorker *pWorker);
+void _Cliques_flush(Cliques *this, CliquesWorker *pWorker);
+void _Cliques_expand(Cliques *this, CliquesWorker *pWorker, int depth);
+void _Cliques_reset(Cliques *this, CliqueVisit pVisit, void *pArgs, int minSize, int bMaximum);
+void _Cliques_finish(Cliques *this, double start);
+void _Cliques_search(void *pArgs, int thread, int start, int end);
+long Cliques_enumerate(Cliques *this, int minSize, CliqueVisit pVisit, void *pArgs);
+long Cliques_enumerateWith(Cliques *this, int node, int minSize, CliqueVisit pVisit, void *pArgs);
+int Cliques_findMaximum(Cliques *this);
+
+/**
+ * Counts the members of a bitset.
+ *
+ * @param   { uint64_t * }  pSet        The bitset to count.
+ * @param   { int }         wordCount   How many words it has.
+ * @return  { int }                     How many bits are set.
+ */
+static inline int _Cliques_count(uint64_t *pSet, int wordCount) {
+  int count = 0;
+
+  for(int w = 0; w < wordCount; w++)
+    count += __builtin_popcountll(pSet[w]);
+
+  return count;
+}
+
+/**
+ * Allocates memory for the cliques.
+ *
+ * @return  { Cliques * }   The memory for the cliques.
+ */
+Cliques *_Cliques_alloc() {
+  Cliques *pCliques = calloc(1, sizeof(*pCliques));
+
+  return pCliques;
+}
+
+/**
+ * Initializes the cliques of a graph, ordering its nodes by peeling it.
+ *
+ * @param   { Cliques * }   this    The cliques to initialize.
+ * @param   { Graph * }     pGraph  The graph to search.
+ * @return  { Cliques * }           The initialized cliques.
+ */
+Cliques *_Cliques_init(Cliques *this, Graph *pGraph) {
+  int n = pGraph->nodeCount;
+
+  this->pGraph = pGraph;
+  this->nodeCount = n;
+
+  // The peeling order is a degeneracy ordering, and the highest core is the degeneracy
+  Cores *pCores = Cores_new(pGraph);
+  this->pOrder = pCores->pOrder;
+  this->degeneracy = pCores->maxCore;
+  pCores->pOrder = NULL;
+  Cores_kill(pCores);
+
+  this->pRanks = malloc((n + 1) * sizeof(int));
+
+  for(int i = 0; i < n; i++)
+    this->pRanks[this->pOrder[i]] = i;
+
+  // No clique is bigger than the degeneracy plus one
+  this->pMaximum = malloc((this->degeneracy + 2) * sizeof(int));
+  this->pSizeCounts = calloc(this->degeneracy + 2, sizeof(long));
+  this->maxSize = 0;
+
+  pthread_mutex_init(&this->lock, NULL);
+
+  return this;
+}
+
+/**
+ * Creates the cliques of a graph, ready to be searched.
+ *
+ * @param   { Graph * }     pGraph  The graph to search.
+ * @return  { Cliques * }           The new cliques.
+ */
+Cliques *Cliques_new(Graph *pGraph) {
+  return _Cliques_init(_Cliques_alloc(), pGraph);
+}
+
+/**
+ * Frees the memory associated with the cliques.
+ *
+ * @param   { Cliques * }   this  The cliques to free.
+ */
+void Cliques_kill(Cliques *this) {
+
+  // The state of each thread
+  for(int t = 0; t < THREAD_MAX_COUNT; t++) {
+    CliquesWorker *pWorker = this->pWorkers[t];
+
+    if(pWorker == NULL)
+      continue;
+
+    free(pWorker->pLocal);
+    free(pWorker->pNodes);
+    free(pWorker->pAdjacency);
+    free(pWorker->pSets);
+    free(pWorker->pClique);
+    free(pWorker->pBuffer);
+    free(pWorker->pSizeCounts);
+    free(pWorker);
+  }
+
+  pthread_mutex_destroy(&this->lock);
+
+  free(this->pOrder);
+  free(this->pRanks);
+  free(this->pMaximum);
+  free(this->pSizeCounts);
+  free(this);
+}
+
+/**
+ * Gets the state of a thread, making it the first time.
+ * The clique being grown holds the node searched from plus the rest of its neighborhood at most.
+ *
+ * @param   { Cliques * }         this    The cliques being searched.
+ * @param   { int }               thread  The index of the thread.
+ * @return  { CliquesWorker * }           The state of the thread.
+ */
+CliquesWorker *_Cliques_getWorker(Cliques *this, int thread) {
+
+  // Already made
+  if(this->pWorkers[thread] != NULL)
+    return this->pWorkers[thread];
+
+  CliquesWorker *pWorker = calloc(1, sizeof(*pWorker));
+  pWorker->pLocal = malloc((this->nodeCount + 1) * sizeof(int));
+  pWorker->pNodes = malloc((this->nodeCount + 1) * sizeof(int));
+  pWorker->pClique = malloc((this->nodeCount + 1) * sizeof(int));
+  pWorker->pBuffer = malloc((CLIQUES_FLUSH + this->nodeCount + 1) * sizeof(int));
+  pWorker->pSizeCounts = calloc(this->degeneracy + 2, sizeof(long));
+
+  for(int v = 0; v < this->nodeCount; v++)
+    pWorker->pLocal[v] = CLIQUES_OUTSIDE;
+
+  this->pWorkers[thread] = pWorker;
+
+  return pWorker;
+}
+
+/**
+ * Sets up the search from a node: its neighbors become the local nodes, with their adjacencies among each other
+ * as bitsets. Neighbors after the node in the ordering are the candidates, and the ones before are excluded,
+ * since every clique with them was already found from them. The first level of the search is left ready.
+ *
+ * @param   { Cliques * }         this            The cliques being searched.
+ * @param   { CliquesWorker * }   pWorker         The state of the running thread.
+ * @param   { int }               root            The node to search from.
+ * @param   { int }               bEveryNeighbor  Whether every neighbor is a candidate, regardless of the ordering.
+ */
+void _Cliques_prepare(Cliques *this, CliquesWorker *pWorker, int root, int bEveryNeighbor) {
+  Graph *pGraph = this->pGraph;
+  int *pAdjs = Graph_getAdjs(pGraph, root);
+  int degree = Graph_getDegree(pGraph, root);
+
+  // Number the neighbors
+  pWorker->localCount = degree;
+  pWorker->wordCount = (degree + 63) >> 6;
+
+  for(int i = 0; i < degree; i++) {
+    pWorker->pLocal[pAdjs[i]] = i;
+    pWorker->pNodes[i] = pAdjs[i];
+  }
+
+  // Make room for the adjacencies and for as many levels as there are candidates
+  int wordCount = pWorker->wordCount;
+  long adjacencySize = (long) degree * wordCount;
+  long setSize = (long) (degree + 2) * 3 * wordCount;
+
+  if(pWorker->pAdjacency == NULL || adjacencySize > pWorker->adjacencyLimit) {
+    pWorker->adjacencyLimit = adjacencySize;
+    pWorker->pAdjacency = realloc(pWorker->pAdjacency, (adjacencySize + 1) * sizeof(uint64_t));
+  }
+
+  if(pWorker->pSets == NULL || setSize > pWorker->setLimit) {
+    pWorker->setLimit = setSize;
+    pWorker->pSets = realloc(pWorker->pSets, (setSize + 1) * sizeof(uint64_t));
+  }
+
+  // The adjacencies within the neighborhood
+  memset(pWorker->pAdjacency, 0, adjacencySize * sizeof(uint64_t));
+
+  for(int i = 0; i < degree; i++) {
+    uint64_t *pRow = pWorker->pAdjacency + (long) i * wordCount;
+    int *pNeighbors = Graph_getAdjs(pGraph, pAdjs[i]);
+    int neighborCount = Graph_getDegree(pGraph, pAdjs[i]);
+
+    for(int j = 0; j < neighborCount; j++) {
+      int local = pWorker->pLocal[pNeighbors[j]];
+
+      if(local != CLIQUES_OUTSIDE)
+        pRow[local >> 6] |= 1ULL << (local & 63);
+    }
+  }
+
+  // Forget the numbering for the next node
+  for(int i = 0; i < degree; i++)
+    pWorker->pLocal[pAdjs[i]] = CLIQUES_OUTSIDE;
+
+  // The first level: candidates and excluded
+  uint64_t *pCandidates = pWorker->pSets;
+  uint64_t *pExcluded = pCandidates + wordCount;
+
+  memset(pCandidates, 0, 2 * wordCount * sizeof(uint64_t));
+
+  for(int i = 0; i < degree; i++) {
+    if(bEveryNeighbor || this->pRanks[pAdjs[i]] > this->pRanks[root])
+      pCandidates[i >> 6] |= 1ULL << (i & 63);
+    else
+      pExcluded[i >> 6] |= 1ULL << (i & 63);
+  }
+
+  // The clique starts with the node itself
+  pWorker->pClique[0] = root;
+  pWorker->size = 1;
+}
+
+/**
+ * Records the clique being grown, which is maximal.
+ * When only the largest clique is wanted, it replaces the largest so far if it's bigger.
+ * Otherwise it's queued to be handed over, if it's big enough.
+ *
+ * @param   { Cliques * }         this      The cliques being searched.
+ * @param   { CliquesWorker * }   pWorker   The state of the running thread.
+ */
+void _Cliques_report(Cliques *this, CliquesWorker *pWorker) {
+  int size = pWorker->size;
+
+  pWorker->cliqueCount++;
+  pWorker->pSizeCounts[size]++;
+
+  // A new largest clique
+  if(this->bMaximum) {
+    if(size <= __atomic_load_n(&this->maxSize, __ATOMIC_RELAXED))
+      return;
+
+    pthread_mutex_lock(&this->lock);
+
+    if(size > this->maxSize) {
+      memcpy(this->pMaximum, pWorker->pClique, size * sizeof(int));
+      __atomic_store_n(&this->maxSize, size, __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_unlock(&this->lock);
+    return;
+  }
+
+  // Too small to hand over
+  if(size < this->minSize)
+    return;
+
+  // Queue it, and hand the queue over once it's full
+  pWorker->pBuffer[pWorker->bufferCount++] = size;
+  memcpy(pWorker->pBuffer + pWorker->bufferCount, pWorker->pClique, size * sizeof(int));
+  pWorker->bufferCount += size;
+
+  if(pWorker->bufferCount >= CLIQUES_FLUSH)
+    _Cliques_flush(this, pWorker);
+}
+
+/**
+ * Hands the queued cliques of a thread over, one thread at a time.
+ *
+ * @param   { Cliques * }         this      The cliques being searched.
+ * @param   { CliquesWorker * }   pWorker   The state of the thread.
+ */
+void _Cliques_flush(Cliques *this, CliquesWorker *pWorker) {
+
+  // Nothing queued
+  if(!pWorker->bufferCount)
+    return;
+
+  pthread_mutex_lock(&this->lock);
+
+  for(int i = 0; i < pWorker->bufferCount; i += pWorker->pBuffer[i] + 1) {
+    this->pVisit(this->pArgs, pWorker->pBuffer + i + 1, pWorker->pBuffer[i]);
+    this->visitCount++;
+  }
+
+  pthread_mutex_unlock(&this->lock);
+
+  pWorker->bufferCount = 0;
+}
+
+/**
+ * Grows the clique by every candidate in turn, from the given level of the search.
+ * The pivot is the candidate or excluded node with the most candidates around it; its neighbors are skipped,
+ * since any maximal clique with one of them either has the pivot or is found through a candidate that isn't one.
+ * When there are no candidates left the clique can't grow, and it's maximal unless an excluded node could join it.
+ *
+ * @param   { Cliques * }         this      The cliques being searched.
+ * @param   { CliquesWorker * }   pWorker   The state of the running thread.
+ * @param   { int }               depth     The level of the search, whose sets are ready.
+ */
+void _Cliques_expand(Cliques *this, CliquesWorker *pWorker, int depth) {
+  int wordCount = pWorker->wordCount;
+  uint64_t *pCandidates = pWorker->pSets + (long) depth * 3 * wordCount;
+  uint64_t *pExcluded = pCandidates + wordCount;
+  uint64_t *pBranches = pExcluded + wordCount;
+  uint64_t *pNext = pBranches + wordCount;
+
+  pWorker->callCount++;
+
+  // Can't grow anymore
+  int candidateCount = _Cliques_count(pCandidates, wordCount);
+
+  if(!candidateCount) {
+    if(!_Cliques_count(pExcluded, wordCount))
+      _Cliques_report(this, pWorker);
+
+    return;
+  }
+
+  // Can't beat the largest so far
+  if(this->bMaximum && pWorker->size + candidateCount <= __atomic_load_n(&this->maxSize, __ATOMIC_RELAXED))
+    return;
+
+  // Pick the pivot
+  int pivot = -1;
+  int pivotCount = -1;
+
+  for(int w = 0; w < wordCount; w++) {
+    uint64_t word = pCandidates[w] | pExcluded[w];
+
+    while(word) {
+      int u = (w << 6) + __builtin_ctzll(word);
+      uint64_t *pRow = pWorker->pAdjacency + (long) u * wordCount;
+      int count = 0;
+      word &= word - 1;
+
+      for(int x = 0; x < wordCount; x++)
+        count += __builtin_popcountll(pCandidates[x] & pRow[x]);
+
+      if(count > pivotCount) {
+        pivot = u;
+        pivotCount = count;
+      }
+    }
+  }
+
+  // Branch on the candidates away from the pivot
+  uint64_t *pPivotRow = pWorker->pAdjacency + (long) pivot * wordCount;
+
+  for(int w = 0; w < wordCount; w++)
+    pBranches[w] = pCandidates[w] & ~pPivotRow[w];
+
+  for(int w = 0; w < wordCount; w++) {
+    while(pBranches[w]) {
+      int v = (w << 6) + __builtin_ctzll(pBranches[w]);
+      uint64_t bit = 1ULL << (v & 63);
+      uint64_t *pRow = pWorker->pAdjacency + (long) v * wordCount;
+      pBranches[w] &= pBranches[w] - 1;
+
+      // The next level keeps only what's next to the new member
+      for(int x = 0; x < wordCount; x++) {
+        pNext[x] = pCandidates[x] & pRow[x];
+        pNext[wordCount + x] = pExcluded[x] & pRow[x];
+      }
+
+      pWorker->pClique[pWorker->size++] = pWorker->pNodes[v];
+      _Cliques_expand(this, pWorker, depth + 1);
+      pWorker->size--;
+
+      // Every clique with it was just found
+      pCandidates[w] &= ~bit;
+      pExcluded[w] |= bit;
+    }
+  }
+}
+
+/**
+ * Clears what the last search found and sets up the next one.
+ *
+ * @param   { Cliques * }     this      The cliques to search.
+ * @param   { CliqueVisit }   pVisit    What to do with each clique; may be NULL when only the largest is wanted.
+ * @param   { void * }        pArgs     The arguments passed to pVisit.
+ * @param   { int }           minSize   How big a clique has to be to be handed over.
+ * @param   { int }           bMaximum  Whether only the largest clique is wanted.
+ */
+void _Cliques_reset(Cliques *this, CliqueVisit pVisit, void *pArgs, int minSize, int bMaximum) {
+  this->pVisit = pVisit;
+  this->pArgs = pArgs;
+  this->minSize = minSize;
+  this->bMaximum = bMaximum;
+  this->maxSize = 0;
+  this->visitCount = 0;
+
+  for(int t = 0; t < THREAD_MAX_COUNT; t++) {
+    CliquesWorker *pWorker = this->pWorkers[t];
+
+    if(pWorker == NULL)
+      continue;
+
+    pWorker->cliqueCount = 0;
+    pWorker->callCount = 0;
+    memset(pWorker->pSizeCounts, 0, (this->degeneracy + 2) * sizeof(long));
+  }
+}
+
+/**
+ * Hands over what's still queued and adds up what every thread found.
+ *
+ * @param   { Cliques * }   this    The cliques that were searched.
+ * @param   { double }      start   When the search started.
+ */
+void _Cliques_finish(Cliques *this, double start) {
+  this->cliqueCount = 0;
+  this->callCount = 0;
+  memset(this->pSizeCounts, 0, (this->degeneracy + 2) * sizeof(long));
+
+  for(int t = 0; t < THREAD_MAX_COUNT; t++) {
+    CliquesWorker *pWorker = this->pWorkers[t];
+
+    if(pWorker == NULL)
+      continue;
+
+    _Cliques_flush(this, pWorker);
+
+    this->cliqueCount += pWorker->cliqueCount;
+    this->callCount += pWorker->callCount;
+
+    for(int s = 0; s <= this->degeneracy + 1; s++)
+      this->pSizeCounts[s] += pWorker->pSizeCounts[s];
+  }
+
+  this->seconds = Timer_now() - start;
+}
+
+/**
+ * Searches from the nodes within the given range, densest first.
+ * The last nodes of the ordering are in the densest core, so their searches are the longest,
+ * and when only the largest clique is wanted they find a big one early to prune the rest with.
+ *
+ * @param   { void * }  pArgs   The cliques being searched.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first position to search from, counted from the end of the ordering.
+ * @param   { int }     end     One past the last position.
+ */
+void _Cliques_search(void *pArgs, int thread, int start, int end) {
+  Cliques *this = pArgs;
+  CliquesWorker *pWorker = _Cliques_getWorker(this, thread);
+
+  for(int i = start; i < end; i++) {
+    int root = this->pOrder[this->nodeCount - 1 - i];
+
+    // Its cliques can't beat the largest so far
+    if(this->bMaximum) {
+      int laterCount = 0;
+      int *pAdjs = Graph_getAdjs(this->pGraph, root);
+      int degree = Graph_getDegree(this->pGraph, root);
+
+      for(int j = 0; j < degree; j++)
+        laterCount += this->pRanks[pAdjs[j]] > this->pRanks[root];
+
+      if(laterCount + 1 <= __atomic_load_n(&this->maxSize, __ATOMIC_RELAXED))
+        continue;
+    }
+
+    _Cliques_prepare(this, pWorker, root, 0);
+    _Cliques_expand(this, pWorker, 0);
+  }
+}
+
+/**
+ * Finds every maximal clique, handing each one at least as big as asked to pVisit.
+ * The cliques come out in no particular order, but pVisit is only ever called by one thread at a time.
+ *
+ * @param   { Cliques * }     this      The cliques to search.
+ * @param   { int }           minSize   How big a clique has to be to be handed over.
+ * @param   { CliqueVisit }   pVisit    What to do with each clique.
+ * @param   { void * }        pArgs     The arguments passed to pVisit.
+ * @return  { long }                    How many cliques were handed over.
+ */
+long Cliques_enumerate(Cliques *this, int minSize, CliqueVisit pVisit, void *pArgs) {
+  double start = Timer_now();
+
+  _Cliques_reset(this, pVisit, pArgs, minSize, 0);
+  Thread_parallelFor(this->nodeCount, CLIQUES_CHUNK, _Cliques_search, this);
+  _Cliques_finish(this, start);
+
+  return this->visitCount;
+}
+
+/**
+ * Finds every maximal clique a node is in, handing each one at least as big as asked to pVisit.
+ * These all live within the node's neighborhood, so the ordering doesn't matter and a single search covers them.
+ *
+ * @param   { Cliques * }     this      The cliques to search.
+ * @param   { int }           node      The node the cliques have to contain.
+ * @param   { int }           minSize   How big a clique has to be to be handed over.
+ * @param   { CliqueVisit }   pVisit    What to do with each clique.
+ * @param   { void * }        pArgs     The arguments passed to pVisit.
+ * @return  { long }                    How many cliques were handed over.
+ */
+long Cliques_enumerateWith(Cliques *this, int node, int minSize, CliqueVisit pVisit, void *pArgs) {
+  double start = Timer_now();
+  CliquesWorker *pWorker = _Cliques_getWorker(this, 0);
+
+  _Cliques_reset(this, pVisit, pArgs, minSize, 0);
+  _Cliques_prepare(this, pWorker, node, 1);
+  _Cliques_expand(this, pWorker, 0);
+  _Cliques_finish(this, start);
+
+  return this->visitCount;
+}
+
+/**
+ * Finds a largest clique, leaving its members in pMaximum.
+ * Branches that can't beat the largest clique so far are cut, so far fewer cliques are looked at.
+ * The counts of cliques found only cover the ones that were looked at.
+ *
+ * @param   { Cliques * }   this  The cliques to search.
+ * @return  { int }               How many members the largest clique has.
+ */
+int Cliques_findMaximum(Cliques *this) {
+  double start = Timer_now();
+
+  _Cliques_reset(this, NULL, NULL, 0, 1);
+  Thread_parallelFor(this->nodeCount, CLIQUES_CHUNK, _Cliques_search, this);
+  _Cliques_finish(this, start);
+
+  return this->maxSize;
+}
+
+#endif
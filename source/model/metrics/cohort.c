@@ -0,0 +1,181 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 09:52:18
+ * @ Modified time: 2026-10-19 09:52:18
+ * @ Description:
+ *
+ * Distances and closeness for a group of people, such as a dorm or a class year.
+ * Everyone in the group is searched from at once with the multi-source search, so the adjacency scans are shared
+ * instead of repeated per member. Only the distances between members are kept, not a row per member over everyone.
+ */
+
+#ifndef COHORT_C
+#define COHORT_C
+
+#include "../graph.c"
+#include "../search/bfs.c"
+#include "../search/msbfs.c"
+#include "../../utils/timer.c"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct Cohort Cohort;
+
+/**
+ * The members of a group, how far apart they are, and how close each is to everyone else.
+ */
+struct Cohort {
+
+  // The members, and the position of every node among them (or -1)
+  int *pMembers;
+  int memberCount;
+  int *pPositions;
+
+  // Row i holds the distances from member i to every member, BFS_UNVISITED when unreachable
+  int *pDistances;
+
+  // How many nodes each member reaches, the sum of the distances to them, and the sum of their inverses
+  int *pReached;
+  long *pTotals;
+  double *pHarmonic;
+
+  // How many adjacencies the searches scanned, and how long they took
+  long edgeCount;
+  double seconds;
+};
+
+/**
+ * The cohort interface.
+ */
+Cohort *_Cohort_alloc();
+Cohort *_Cohort_init(Cohort *this, Graph *pGraph, int *pMembers, int memberCount);
+Cohort *Cohort_new(Graph *pGraph, int *pMembers, int memberCount);
+void Cohort_kill(Cohort *this);
+
+void _Cohort_visit(void *pArgs, int source, int node, int distance);
+double Cohort_getCloseness(Cohort *this, int member);
+
+/**
+ * Allocates memory for a cohort.
+ *
+ * @return  { Cohort * }  The memory for the cohort.
+ */
+Cohort *_Cohort_alloc() {
+  Cohort *pCohort = calloc(1, sizeof(*pCohort));
+
+  return pCohort;
+}
+
+/**
+ * Initializes a cohort with its members and nothing measured yet.
+ * Members that appear more than once keep their first position.
+ *
+ * @param   { Cohort * }  this          The cohort to initialize.
+ * @param   { Graph * }   pGraph        The graph the members belong to.
+ * @param   { int * }     pMembers      The indices of the members.
+ * @param   { int }       memberCount   How many indices there are.
+ * @return  { Cohort * }                The initialized cohort.
+ */
+Cohort *_Cohort_init(Cohort *this, Graph *pGraph, int *pMembers, int memberCount) {
+  int n = pGraph->nodeCount;
+
+  // Keep each member once
+  this->pMembers = malloc((memberCount + 1) * sizeof(int));
+  this->pPositions = malloc((n + 1) * sizeof(int));
+  this->memberCount = 0;
+
+  memset(this->pPositions, 0xff, n * sizeof(int));
+
+  for(int i = 0; i < memberCount; i++) {
+    if(this->pPositions[pMembers[i]] >= 0)
+      continue;
+
+    this->pPositions[pMembers[i]] = this->memberCount;
+    this->pMembers[this->memberCount++] = pMembers[i];
+  }
+
+  // Nothing measured yet
+  long size = (long) this->memberCount * this->memberCount;
+  this->pDistances = malloc((size + 1) * sizeof(int));
+  this->pReached = calloc(this->memberCount + 1, sizeof(int));
+  this->pTotals = calloc(this->memberCount + 1, sizeof(long));
+  this->pHarmonic = calloc(this->memberCount + 1, sizeof(double));
+  this->edgeCount = 0;
+  this->seconds = 0;
+
+  memset(this->pDistances, 0xff, size * sizeof(int));
+
+  return this;
+}
+
+/**
+ * Records a visit of one of the searches.
+ * Each search only writes to the row of its own member, so the searches can run on separate threads.
+ *
+ * @param   { void * }  pArgs     The cohort.
+ * @param   { int }     source    The position of the member searched from.
+ * @param   { int }     node      The node reached.
+ * @param   { int }     distance  Its distance from the member.
+ */
+void _Cohort_visit(void *pArgs, int source, int node, int distance) {
+  Cohort *this = pArgs;
+  int position = this->pPositions[node];
+
+  // Everyone reached counts towards closeness
+  this->pReached[source]++;
+  this->pTotals[source] += distance;
+
+  if(distance > 0)
+    this->pHarmonic[source] += 1.0 / distance;
+
+  // Only the members get a column in the table
+  if(position >= 0)
+    this->pDistances[(long) source * this->memberCount + position] = distance;
+}
+
+/**
+ * Measures the distances between the given members and how close each is to everyone else.
+ *
+ * @param   { Graph * }   pGraph        The graph the members belong to.
+ * @param   { int * }     pMembers      The indices of the members.
+ * @param   { int }       memberCount   How many indices there are.
+ * @return  { Cohort * }                The measured cohort.
+ */
+Cohort *Cohort_new(Graph *pGraph, int *pMembers, int memberCount) {
+  Cohort *this = _Cohort_init(_Cohort_alloc(), pGraph, pMembers, memberCount);
+  double start = Timer_now();
+
+  this->edgeCount = MSBFS_run(pGraph, this->pMembers, this->memberCount, _Cohort_visit, this);
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with a cohort.
+ *
+ * @param   { Cohort * }  this  The cohort to free.
+ */
+void Cohort_kill(Cohort *this) {
+  free(this->pMembers);
+  free(this->pPositions);
+  free(this->pDistances);
+  free(this->pReached);
+  free(this->pTotals);
+  free(this->pHarmonic);
+  free(this);
+}
+
+/**
+ * Gets the closeness of a member within its component: how many others it reaches over their total distance.
+ *
+ * @param   { Cohort * }  this    The measured cohort.
+ * @param   { int }       member  The position of the member.
+ * @return  { double }            Its closeness, or 0 if it reaches no one.
+ */
+double Cohort_getCloseness(Cohort *this, int member) {
+  return this->pTotals[member] ? (this->pReached[member] - 1) / (double) this->pTotals[member] : 0;
+}
+
+#endif
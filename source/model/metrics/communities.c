@@ -0,0 +1,881 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 03:44:10
+ * @ Modified time: 2026-10-19 08:55:38
+ * @ Description:
+ *
+ * Splits the graph into communities, either by Louvain's method or by label propagation.
+ * Louvain moves nodes between communities while modularity goes up, then merges each community into a single node
+ * and starts over on the smaller graph. Label propagation lets each node take the most common label among its
+ * neighbors, which is faster but usually scores lower.
+ * Both move nodes in place across threads; each thread tallies the neighboring communities in its own scratch array.
+ */
+
+#ifndef COMMUNITIES_C
+#define COMMUNITIES_C
+
+#include "../graph.c"
+#include "../../utils/thread.c"
+#include "../../utils/timer.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// When to stop moving nodes within a level
+#define COMMUNITIES_TOLERANCE 1e-6
+#define COMMUNITIES_MAX_PASSES 32
+#define COMMUNITIES_MAX_LEVELS 16
+
+// When to stop propagating labels: fewer than one in this many nodes changed
+#define COMMUNITIES_LABEL_STOP 1000
+#define COMMUNITIES_MAX_ITERATIONS 64
+
+// How many nodes each thread claims at a time
+#define COMMUNITIES_CHUNK 256
+
+typedef struct Communities Communities;
+typedef struct CommunitiesLevel CommunitiesLevel;
+typedef struct CommunitiesJob CommunitiesJob;
+
+/**
+ * The community of every node.
+ * Communities are numbered by decreasing size, so community 0 is always the largest.
+ */
+struct Communities {
+
+  // How many nodes and communities there are
+  int nodeCount;
+  int count;
+
+  // The community of each node, and the size of each community
+  int *pLabels;
+  int *pSizes;
+
+  // How good the split is
+  double modularity;
+
+  // How many levels or iterations it took, and how long
+  int rounds;
+  double seconds;
+};
+
+/**
+ * A weighted graph, for the levels of Louvain's method.
+ * Each node of a level is a community of the level below, and the weights count the edges between them.
+ */
+struct CommunitiesLevel {
+
+  // How many nodes there are
+  int nodeCount;
+
+  // The neighbors of node i are adjs[offsets[i]] up to adjs[offsets[i + 1]], each with a weight
+  int *pOffsets;
+  int *pAdjs;
+  long *pWeights;
+
+  // Twice the weight of the edges merged into each node, and the total weight each node touches
+  long *pLoops;
+  long *pVolumes;
+};
+
+/**
+ * The state shared by the threads.
+ */
+struct CommunitiesJob {
+
+  // The level being worked on, and twice its total weight
+  CommunitiesLevel *pLevel;
+  double total;
+
+  // The community of each node, and the total volume of each community
+  int *pCommunities;
+  long *pTotals;
+
+  // What each thread tallies the neighboring communities in, and which ones it touched
+  long *pTallies[THREAD_MAX_COUNT];
+  int *pTouched[THREAD_MAX_COUNT];
+
+  // Which round of label propagation this is
+  int round;
+
+  // The sums of each thread
+  long moves[THREAD_MAX_COUNT];
+  double sums[THREAD_MAX_COUNT];
+
+  // When merging: the community each node goes to, the nodes of each community, and the merged level
+  int *pMap;
+  int *pMembers;
+  int *pMemberStarts;
+  CommunitiesLevel *pNext;
+};
+
+/**
+ * The communities interface.
+ */
+Communities *_Communities_alloc();
+Communities *_Communities_init(Communities *this, int nodeCount);
+Communities *Communities_newLouvain(Graph *pGraph);
+Communities *Communities_newLabelPropagation(Graph *pGraph);
+void Communities_kill(Communities *this);
+
+CommunitiesLevel *_CommunitiesLevel_new(Graph *pGraph);
+void _CommunitiesLevel_kill(CommunitiesLevel *pLevel);
+
+CommunitiesJob *_CommunitiesJob_new(int nodeCount);
+void _CommunitiesJob_kill(CommunitiesJob *pJob);
+long _CommunitiesJob_sumMoves(CommunitiesJob *pJob);
+
+int _Communities_tally(CommunitiesJob *pJob, int thread, int u);
+void _Communities_clear(CommunitiesJob *pJob, int thread, int touchedCount);
+void _Communities_move(void *pArgs, int thread, int start, int end);
+void _Communities_internal(void *pArgs, int thread, int start, int end);
+double _Communities_modularity(CommunitiesJob *pJob);
+void _Communities_countMerged(void *pArgs, int thread, int start, int end);
+void _Communities_fillMerged(void *pArgs, int thread, int start, int end);
+int _Communities_compact(int *pLabels, int count, int *pMap);
+CommunitiesLevel *_Communities_merge(CommunitiesJob *pJob, int *pMap, int mergedCount);
+static inline unsigned int _Communities_hash(int u, int label, int round);
+void _Communities_propagate(void *pArgs, int thread, int start, int end);
+void _Communities_finish(Communities *this, CommunitiesLevel *pLevel, CommunitiesJob *pJob, double start);
+
+/**
+ * Allocates memory for the communities.
+ *
+ * @return  { Communities * }   The memory for the communities.
+ */
+Communities *_Communities_alloc() {
+  Communities *pCommunities = calloc(1, sizeof(*pCommunities));
+
+  return pCommunities;
+}
+
+/**
+ * Initializes the communities with every node on its own.
+ *
+ * @param   { Communities * }   this        The communities to initialize.
+ * @param   { int }             nodeCount   How many nodes there are.
+ * @return  { Communities * }               The initialized communities.
+ */
+Communities *_Communities_init(Communities *this, int nodeCount) {
+
+  // Everyone starts alone
+  this->nodeCount = nodeCount;
+  this->count = nodeCount;
+  this->pLabels = malloc((nodeCount + 1) * sizeof(int));
+  this->pSizes = NULL;
+
+  for(int i = 0; i < nodeCount; i++)
+    this->pLabels[i] = i;
+
+  // Nothing ran yet
+  this->modularity = 0;
+  this->rounds = 0;
+  this->seconds = 0;
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with the communities.
+ *
+ * @param   { Communities * }   this  The communities to free.
+ */
+void Communities_kill(Communities *this) {
+  free(this->pLabels);
+  free(this->pSizes);
+  free(this);
+}
+
+/**
+ * Creates the first level from the graph, where every edge weighs 1.
+ *
+ * @param   { Graph * }             pGraph  The graph to copy.
+ * @return  { CommunitiesLevel * }          The first level.
+ */
+CommunitiesLevel *_CommunitiesLevel_new(Graph *pGraph) {
+  int n = pGraph->nodeCount;
+  CommunitiesLevel *pLevel = calloc(1, sizeof(*pLevel));
+
+  // Same layout as the graph
+  pLevel->nodeCount = n;
+  pLevel->pOffsets = malloc((n + 1) * sizeof(int));
+  pLevel->pAdjs = malloc((pGraph->adjCount + 1) * sizeof(int));
+  pLevel->pWeights = malloc((pGraph->adjCount + 1) * sizeof(long));
+  pLevel->pLoops = calloc(n + 1, sizeof(long));
+  pLevel->pVolumes = malloc((n + 1) * sizeof(long));
+
+  memcpy(pLevel->pOffsets, pGraph->offsets, (n + 1) * sizeof(int));
+  memcpy(pLevel->pAdjs, pGraph->adjs, pGraph->adjCount * sizeof(int));
+
+  for(int i = 0; i < pGraph->adjCount; i++)
+    pLevel->pWeights[i] = 1;
+
+  for(int u = 0; u < n; u++)
+    pLevel->pVolumes[u] = Graph_getDegree(pGraph, u);
+
+  return pLevel;
+}
+
+/**
+ * Frees a level.
+ *
+ * @param   { CommunitiesLevel * }  pLevel  The level to free.
+ */
+void _CommunitiesLevel_kill(CommunitiesLevel *pLevel) {
+  free(pLevel->pOffsets);
+  free(pLevel->pAdjs);
+  free(pLevel->pWeights);
+  free(pLevel->pLoops);
+  free(pLevel->pVolumes);
+  free(pLevel);
+}
+
+/**
+ * Creates the shared state, with scratch arrays big enough for the first level.
+ * The tallies are kept cleared between uses.
+ *
+ * @param   { int }               nodeCount   How many nodes the first level has.
+ * @return  { CommunitiesJob * }              The shared state.
+ */
+CommunitiesJob *_CommunitiesJob_new(int nodeCount) {
+  CommunitiesJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pCommunities = malloc((nodeCount + 1) * sizeof(int));
+  pJob->pTotals = malloc((nodeCount + 1) * sizeof(long));
+  pJob->pMap = malloc((nodeCount + 1) * sizeof(int));
+  pJob->pMembers = malloc((nodeCount + 1) * sizeof(int));
+  pJob->pMemberStarts = malloc((nodeCount + 2) * sizeof(int));
+
+  for(int t = 0; t < Thread_getCount(); t++) {
+    pJob->pTallies[t] = calloc(nodeCount + 1, sizeof(long));
+    pJob->pTouched[t] = malloc((nodeCount + 1) * sizeof(int));
+  }
+
+  return pJob;
+}
+
+/**
+ * Frees the shared state.
+ *
+ * @param   { CommunitiesJob * }  pJob  The state to free.
+ */
+void _CommunitiesJob_kill(CommunitiesJob *pJob) {
+  for(int t = 0; t < Thread_getCount(); t++) {
+    free(pJob->pTallies[t]);
+    free(pJob->pTouched[t]);
+  }
+
+  free(pJob->pCommunities);
+  free(pJob->pTotals);
+  free(pJob->pMap);
+  free(pJob->pMembers);
+  free(pJob->pMemberStarts);
+  free(pJob);
+}
+
+/**
+ * Adds up and clears the per-thread move counts.
+ *
+ * @param   { CommunitiesJob * }  pJob  The state to read.
+ * @return  { long }                    How many nodes moved.
+ */
+long _CommunitiesJob_sumMoves(CommunitiesJob *pJob) {
+  long moves = 0;
+
+  for(int t = 0; t < THREAD_MAX_COUNT; t++) {
+    moves += pJob->moves[t];
+    pJob->moves[t] = 0;
+  }
+
+  return moves;
+}
+
+/**
+ * Tallies the weight from a node to each of the communities around it, leaving out its own loops.
+ * The communities touched are listed in the thread's scratch.
+ *
+ * @param   { CommunitiesJob * }  pJob    The shared state.
+ * @param   { int }               thread  The index of the running thread.
+ * @param   { int }               u       The node to tally around.
+ * @return  { int }                       How many communities were touched.
+ */
+int _Communities_tally(CommunitiesJob *pJob, int thread, int u) {
+  CommunitiesLevel *pLevel = pJob->pLevel;
+  long *pTally = pJob->pTallies[thread];
+  int *pTouched = pJob->pTouched[thread];
+  int count = 0;
+
+  for(int j = pLevel->pOffsets[u]; j < pLevel->pOffsets[u + 1]; j++) {
+    int c = __atomic_load_n(&pJob->pCommunities[pLevel->pAdjs[j]], __ATOMIC_RELAXED);
+
+    // First time seeing this one
+    if(!pTally[c])
+      pTouched[count++] = c;
+
+    pTally[c] += pLevel->pWeights[j];
+  }
+
+  return count;
+}
+
+/**
+ * Clears what the last tally touched.
+ *
+ * @param   { CommunitiesJob * }  pJob          The shared state.
+ * @param   { int }               thread        The index of the running thread.
+ * @param   { int }               touchedCount  How many communities the tally touched.
+ */
+void _Communities_clear(CommunitiesJob *pJob, int thread, int touchedCount) {
+  for(int i = 0; i < touchedCount; i++)
+    pJob->pTallies[thread][pJob->pTouched[thread][i]] = 0;
+}
+
+/**
+ * Moves each node within the given range to the neighboring community that raises modularity the most.
+ * Taking node u with volume k out of its community, joining community d gains w(u, d) - k * tot(d) / 2m,
+ * up to a constant factor. Moves happen right away, so later nodes see them; the volumes are updated atomically.
+ *
+ * @param   { void * }  pArgs   The shared CommunitiesJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to move.
+ * @param   { int }     end     One past the last node to move.
+ */
+void _Communities_move(void *pArgs, int thread, int start, int end) {
+  CommunitiesJob *pJob = pArgs;
+  long *pTally = pJob->pTallies[thread];
+  int *pTouched = pJob->pTouched[thread];
+  long moves = 0;
+
+  for(int u = start; u < end; u++) {
+    int c = pJob->pCommunities[u];
+    double volume = pJob->pLevel->pVolumes[u];
+    int count = _Communities_tally(pJob, thread, u);
+
+    // Staying put, without counting itself in its community
+    double own = __atomic_load_n(&pJob->pTotals[c], __ATOMIC_RELAXED) - volume;
+    double bestGain = pTally[c] - volume * own / pJob->total;
+    int best = c;
+
+    // Look for better
+    for(int i = 0; i < count; i++) {
+      int d = pTouched[i];
+      double gain = pTally[d] - volume * __atomic_load_n(&pJob->pTotals[d], __ATOMIC_RELAXED) / pJob->total;
+
+      // Ties between other communities go to the lower id, so the threads agree
+      if(d != c && (gain > bestGain || (gain == bestGain && best != c && d < best))) {
+        bestGain = gain;
+        best = d;
+      }
+    }
+
+    _Communities_clear(pJob, thread, count);
+
+    // Move it over
+    if(best != c) {
+      __atomic_fetch_sub(&pJob->pTotals[c], (long) volume, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&pJob->pTotals[best], (long) volume, __ATOMIC_RELAXED);
+      __atomic_store_n(&pJob->pCommunities[u], best, __ATOMIC_RELAXED);
+      moves++;
+    }
+  }
+
+  pJob->moves[thread] += moves;
+}
+
+/**
+ * Sums the weight that stays inside the community of each node within the given range, loops included.
+ *
+ * @param   { void * }  pArgs   The shared CommunitiesJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to sum.
+ * @param   { int }     end     One past the last node to sum.
+ */
+void _Communities_internal(void *pArgs, int thread, int start, int end) {
+  CommunitiesJob *pJob = pArgs;
+  CommunitiesLevel *pLevel = pJob->pLevel;
+  long internal = 0;
+
+  for(int u = start; u < end; u++) {
+    int c = pJob->pCommunities[u];
+    internal += pLevel->pLoops[u];
+
+    for(int j = pLevel->pOffsets[u]; j < pLevel->pOffsets[u + 1]; j++)
+      if(pJob->pCommunities[pLevel->pAdjs[j]] == c)
+        internal += pLevel->pWeights[j];
+  }
+
+  pJob->sums[thread] += internal;
+}
+
+/**
+ * Computes the modularity of the current communities of the level:
+ * the fraction of the weight inside communities, minus what a random graph with the same volumes would have there.
+ *
+ * @param   { CommunitiesJob * }  pJob  The shared state.
+ * @return  { double }                  The modularity, between -0.5 and 1.
+ */
+double _Communities_modularity(CommunitiesJob *pJob) {
+  int n = pJob->pLevel->nodeCount;
+  double internal = 0;
+  double expected = 0;
+
+  // Nothing to split
+  if(pJob->total == 0)
+    return 0;
+
+  // The weight inside
+  Thread_parallelFor(n, COMMUNITIES_CHUNK, _Communities_internal, pJob);
+
+  for(int t = 0; t < THREAD_MAX_COUNT; t++) {
+    internal += pJob->sums[t];
+    pJob->sums[t] = 0;
+  }
+
+  // What chance would put there
+  for(int c = 0; c < n; c++)
+    expected += (double) pJob->pTotals[c] * pJob->pTotals[c];
+
+  return internal / pJob->total - expected / (pJob->total * pJob->total);
+}
+
+/**
+ * Numbers the labels that are in use from 0, in order of first appearance.
+ *
+ * @param   { int * }   pLabels   The label of each node, from 0 up to count.
+ * @param   { int }     count     How many nodes there are.
+ * @param   { int * }   pMap      Where to write the new number of each label; must hold count entries.
+ * @return  { int }               How many labels are in use.
+ */
+int _Communities_compact(int *pLabels, int count, int *pMap) {
+  int used = 0;
+
+  for(int i = 0; i < count; i++)
+    pMap[i] = -1;
+
+  for(int i = 0; i < count; i++)
+    if(pMap[pLabels[i]] < 0)
+      pMap[pLabels[i]] = used++;
+
+  return used;
+}
+
+/**
+ * Counts how many other merged nodes each merged node within the given range is linked to.
+ *
+ * @param   { void * }  pArgs   The shared CommunitiesJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first merged node to count.
+ * @param   { int }     end     One past the last merged node to count.
+ */
+void _Communities_countMerged(void *pArgs, int thread, int start, int end) {
+  CommunitiesJob *pJob = pArgs;
+  CommunitiesLevel *pLevel = pJob->pLevel;
+  long *pTally = pJob->pTallies[thread];
+  int *pTouched = pJob->pTouched[thread];
+
+  for(int c = start; c < end; c++) {
+    int count = 0;
+
+    // Tally the merged neighbors of every member
+    for(int i = pJob->pMemberStarts[c]; i < pJob->pMemberStarts[c + 1]; i++) {
+      int u = pJob->pMembers[i];
+
+      for(int j = pLevel->pOffsets[u]; j < pLevel->pOffsets[u + 1]; j++) {
+        int d = pJob->pMap[pLevel->pAdjs[j]];
+
+        if(d != c && !pTally[d]) {
+          pTally[d] = 1;
+          pTouched[count++] = d;
+        }
+      }
+    }
+
+    _Communities_clear(pJob, thread, count);
+    pJob->pNext->pOffsets[c + 1] = count;
+  }
+}
+
+/**
+ * Fills in the edges, loops and volumes of each merged node within the given range.
+ * Edges between two members become part of the loop of their merged node.
+ *
+ * @param   { void * }  pArgs   The shared CommunitiesJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first merged node to fill.
+ * @param   { int }     end     One past the last merged node to fill.
+ */
+void _Communities_fillMerged(void *pArgs, int thread, int start, int end) {
+  CommunitiesJob *pJob = pArgs;
+  CommunitiesLevel *pLevel = pJob->pLevel;
+  CommunitiesLevel *pNext = pJob->pNext;
+  long *pTally = pJob->pTallies[thread];
+  int *pTouched = pJob->pTouched[thread];
+
+  for(int c = start; c < end; c++) {
+    long loops = 0;
+    long volume = 0;
+    int count = 0;
+
+    // Tally the weight to every merged neighbor
+    for(int i = pJob->pMemberStarts[c]; i < pJob->pMemberStarts[c + 1]; i++) {
+      int u = pJob->pMembers[i];
+      loops += pLevel->pLoops[u];
+      volume += pLevel->pVolumes[u];
+
+      for(int j = pLevel->pOffsets[u]; j < pLevel->pOffsets[u + 1]; j++) {
+        int d = pJob->pMap[pLevel->pAdjs[j]];
+
+        // Stays inside
+        if(d == c) {
+          loops += pLevel->pWeights[j];
+          continue;
+        }
+
+        if(!pTally[d])
+          pTouched[count++] = d;
+
+        pTally[d] += pLevel->pWeights[j];
+      }
+    }
+
+    // Write them out
+    int next = pNext->pOffsets[c];
+
+    for(int i = 0; i < count; i++) {
+      pNext->pAdjs[next + i] = pTouched[i];
+      pNext->pWeights[next + i] = pTally[pTouched[i]];
+    }
+
+    _Communities_clear(pJob, thread, count);
+    pNext->pLoops[c] = loops;
+    pNext->pVolumes[c] = volume;
+  }
+}
+
+/**
+ * Merges each community of the current level into a single node of a new level.
+ *
+ * @param   { CommunitiesJob * }    pJob          The shared state.
+ * @param   { int * }               pMap          The merged node each community becomes.
+ * @param   { int }                 mergedCount   How many merged nodes there are.
+ * @return  { CommunitiesLevel * }                The merged level.
+ */
+CommunitiesLevel *_Communities_merge(CommunitiesJob *pJob, int *pMap, int mergedCount) {
+  CommunitiesLevel *pLevel = pJob->pLevel;
+  int n = pLevel->nodeCount;
+
+  // Where each node goes
+  for(int u = 0; u < n; u++)
+    pJob->pMap[u] = pMap[pJob->pCommunities[u]];
+
+  // Group the members of each merged node, by counting then summing
+  for(int c = 0; c <= mergedCount; c++)
+    pJob->pMemberStarts[c] = 0;
+
+  for(int u = 0; u < n; u++)
+    pJob->pMemberStarts[pJob->pMap[u] + 1]++;
+
+  for(int c = 0; c < mergedCount; c++)
+    pJob->pMemberStarts[c + 1] += pJob->pMemberStarts[c];
+
+  for(int u = 0; u < n; u++)
+    pJob->pMembers[pJob->pMemberStarts[pJob->pMap[u]]++] = u;
+
+  // Shift the starts back after the placing moved them along
+  for(int c = mergedCount; c > 0; c--)
+    pJob->pMemberStarts[c] = pJob->pMemberStarts[c - 1];
+
+  pJob->pMemberStarts[0] = 0;
+
+  // Size the new level, then fill it in
+  CommunitiesLevel *pNext = calloc(1, sizeof(*pNext));
+  pNext->nodeCount = mergedCount;
+  pNext->pOffsets = calloc(mergedCount + 1, sizeof(int));
+  pNext->pLoops = calloc(mergedCount + 1, sizeof(long));
+  pNext->pVolumes = calloc(mergedCount + 1, sizeof(long));
+  pJob->pNext = pNext;
+
+  Thread_parallelFor(mergedCount, COMMUNITIES_CHUNK, _Communities_countMerged, pJob);
+
+  for(int c = 0; c < mergedCount; c++)
+    pNext->pOffsets[c + 1] += pNext->pOffsets[c];
+
+  pNext->pAdjs = malloc((pNext->pOffsets[mergedCount] + 1) * sizeof(int));
+  pNext->pWeights = malloc((pNext->pOffsets[mergedCount] + 1) * sizeof(long));
+
+  Thread_parallelFor(mergedCount, COMMUNITIES_CHUNK, _Communities_fillMerged, pJob);
+
+  return pNext;
+}
+
+/**
+ * Numbers the communities by decreasing size, then scores them against the original graph.
+ *
+ * @param   { Communities * }       this    The communities to finish.
+ * @param   { CommunitiesLevel * }  pLevel  The first level, built from the graph.
+ * @param   { CommunitiesJob * }    pJob    The shared state.
+ * @param   { double }              start   When the computation started.
+ */
+void _Communities_finish(Communities *this, CommunitiesLevel *pLevel, CommunitiesJob *pJob, double start) {
+  int n = this->nodeCount;
+
+  // Number the labels in use, and size them
+  int *pMap = malloc((n + 1) * sizeof(int));
+  this->count = _Communities_compact(this->pLabels, n, pMap);
+
+  int *pSizes = calloc(this->count + 1, sizeof(int));
+  for(int u = 0; u < n; u++)
+    pSizes[this->pLabels[u] = pMap[this->pLabels[u]]]++;
+
+  // Order them by decreasing size, counting sort on the size
+  int *pOrder = malloc((this->count + 1) * sizeof(int));
+  int *pStarts = calloc(n + 2, sizeof(int));
+
+  for(int c = 0; c < this->count; c++)
+    pStarts[n - pSizes[c] + 1]++;
+
+  for(int s = 0; s <= n; s++)
+    pStarts[s + 1] += pStarts[s];
+
+  for(int c = 0; c < this->count; c++)
+    pOrder[c] = pStarts[n - pSizes[c]]++;
+
+  // Relabel
+  this->pSizes = malloc((this->count + 1) * sizeof(int));
+
+  for(int c = 0; c < this->count; c++)
+    this->pSizes[pOrder[c]] = pSizes[c];
+
+  for(int u = 0; u < n; u++)
+    this->pLabels[u] = pOrder[this->pLabels[u]];
+
+  // Score the result on the graph
+  pJob->pLevel = pLevel;
+  pJob->total = 0;
+
+  for(int u = 0; u < n; u++) {
+    pJob->pCommunities[u] = this->pLabels[u];
+    pJob->pTotals[u] = 0;
+    pJob->total += pLevel->pVolumes[u];
+  }
+
+  for(int u = 0; u < n; u++)
+    pJob->pTotals[this->pLabels[u]] += pLevel->pVolumes[u];
+
+  this->modularity = _Communities_modularity(pJob);
+
+  // Garbage collection
+  free(pMap);
+  free(pSizes);
+  free(pOrder);
+  free(pStarts);
+
+  this->seconds = Timer_now() - start;
+}
+
+/**
+ * Finds communities with Louvain's method.
+ * Each level moves nodes until modularity stops going up, then merges every community into one node.
+ * The levels stop once nothing moves, and every node of the graph ends up in the community its merged node is in.
+ *
+ * @param   { Graph * }         pGraph  The graph to split.
+ * @return  { Communities * }           The communities.
+ */
+Communities *Communities_newLouvain(Graph *pGraph) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Communities *this = _Communities_init(_Communities_alloc(), n);
+  CommunitiesJob *pJob = _CommunitiesJob_new(n);
+  CommunitiesLevel *pFirst = _CommunitiesLevel_new(pGraph);
+  CommunitiesLevel *pLevel = pFirst;
+  int *pMap = malloc((n + 1) * sizeof(int));
+
+  // Twice the total weight never changes between levels
+  pJob->total = 0;
+  for(int u = 0; u < n; u++)
+    pJob->total += pFirst->pVolumes[u];
+
+  while(this->rounds < COMMUNITIES_MAX_LEVELS) {
+    int levelCount = pLevel->nodeCount;
+    pJob->pLevel = pLevel;
+
+    // Everyone starts alone
+    for(int u = 0; u < levelCount; u++) {
+      pJob->pCommunities[u] = u;
+      pJob->pTotals[u] = pLevel->pVolumes[u];
+    }
+
+    // Move nodes while it helps
+    double modularity = _Communities_modularity(pJob);
+
+    for(int pass = 0; pass < COMMUNITIES_MAX_PASSES; pass++) {
+      Thread_parallelFor(levelCount, COMMUNITIES_CHUNK, _Communities_move, pJob);
+      long moves = _CommunitiesJob_sumMoves(pJob);
+      double next = _Communities_modularity(pJob);
+
+      // Settled
+      if(!moves || next - modularity < COMMUNITIES_TOLERANCE)
+        break;
+
+      modularity = next;
+    }
+
+    // Nothing merged, so we're done
+    int mergedCount = _Communities_compact(pJob->pCommunities, levelCount, pMap);
+    this->rounds++;
+
+    if(mergedCount == levelCount)
+      break;
+
+    // Carry the communities down to the nodes of the graph
+    for(int u = 0; u < n; u++)
+      this->pLabels[u] = pMap[pJob->pCommunities[this->pLabels[u]]];
+
+    // Merge, and go again on the smaller graph
+    CommunitiesLevel *pNext = _Communities_merge(pJob, pMap, mergedCount);
+
+    if(pLevel != pFirst)
+      _CommunitiesLevel_kill(pLevel);
+
+    pLevel = pNext;
+  }
+
+  // Garbage collection
+  if(pLevel != pFirst)
+    _CommunitiesLevel_kill(pLevel);
+
+  free(pMap);
+
+  _Communities_finish(this, pFirst, pJob, start);
+  _CommunitiesLevel_kill(pFirst);
+  _CommunitiesJob_kill(pJob);
+
+  return this;
+}
+
+/**
+ * Scrambles a node, a label and a round into an arbitrary number, for breaking ties.
+ *
+ * @param   { int }           u       The node choosing.
+ * @param   { int }           label   The label being considered.
+ * @param   { int }           round   The round of propagation.
+ * @return  { unsigned int }          The scrambled value.
+ */
+static inline unsigned int _Communities_hash(int u, int label, int round) {
+  unsigned int h = u * 0x9e3779b1u ^ label * 0x85ebca6bu ^ round * 0xc2b2ae35u;
+
+  // The finalizer of murmur hash
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+
+  return h;
+}
+
+/**
+ * Lets each node within the given range of the shuffled order take the label with the most weight among its neighbors.
+ * A node only switches when another label strictly beats its own. Other ties are broken by a hash of the node,
+ * the label and the round, since always favoring the same labels lets one of them swallow the graph.
+ *
+ * @param   { void * }  pArgs   The shared CommunitiesJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   Where in the order to start.
+ * @param   { int }     end     One past where in the order to stop.
+ */
+void _Communities_propagate(void *pArgs, int thread, int start, int end) {
+  CommunitiesJob *pJob = pArgs;
+  long *pTally = pJob->pTallies[thread];
+  int *pTouched = pJob->pTouched[thread];
+  long moves = 0;
+
+  for(int i = start; i < end; i++) {
+    int u = pJob->pMembers[i];
+    int c = pJob->pCommunities[u];
+    int count = _Communities_tally(pJob, thread, u);
+    int best = c;
+
+    // Find the heaviest label
+    for(int j = 0; j < count; j++) {
+      int d = pTouched[j];
+
+      if(pTally[d] > pTally[best] || (pTally[d] == pTally[best] && best != c && 
+        _Communities_hash(u, d, pJob->round) < _Communities_hash(u, best, pJob->round)))
+        best = d;
+    }
+
+    _Communities_clear(pJob, thread, count);
+
+    // Take it
+    if(best != c) {
+      __atomic_store_n(&pJob->pCommunities[u], best, __ATOMIC_RELAXED);
+      moves++;
+    }
+  }
+
+  pJob->moves[thread] += moves;
+}
+
+/**
+ * Finds communities by label propagation (Raghavan, Albert and Kumara).
+ * Every node starts with its own label, and each round takes the most common one around it, in a fresh random order.
+ * Labels change in place, so a round already sees the labels taken earlier in it.
+ * Stops once hardly any node changes; dense groups end up sharing a label. On very dense graphs a single label
+ * can end up spreading almost everywhere, in which case Louvain's method does much better.
+ *
+ * @param   { Graph * }         pGraph  The graph to split.
+ * @return  { Communities * }           The communities.
+ */
+Communities *Communities_newLabelPropagation(Graph *pGraph) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Communities *this = _Communities_init(_Communities_alloc(), n);
+  CommunitiesJob *pJob = _CommunitiesJob_new(n);
+  CommunitiesLevel *pLevel = _CommunitiesLevel_new(pGraph);
+  pJob->pLevel = pLevel;
+
+  // Everyone starts alone
+  for(int u = 0; u < n; u++) {
+    pJob->pCommunities[u] = u;
+    pJob->pMembers[u] = u;
+  }
+
+  // Spread the labels until they settle
+  uint64_t seed = 0x9e3779b97f4a7c15ULL;
+
+  while(this->rounds < COMMUNITIES_MAX_ITERATIONS) {
+    pJob->round = this->rounds;
+
+    // Shuffle the order (Fisher-Yates with xorshift)
+    for(int i = n - 1; i > 0; i--) {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+
+      int j = seed % (i + 1);
+      int temp = pJob->pMembers[i];
+      pJob->pMembers[i] = pJob->pMembers[j];
+      pJob->pMembers[j] = temp;
+    }
+
+    Thread_parallelFor(n, COMMUNITIES_CHUNK, _Communities_propagate, pJob);
+    long moves = _CommunitiesJob_sumMoves(pJob);
+    this->rounds++;
+
+    if(moves * COMMUNITIES_LABEL_STOP <= n)
+      break;
+  }
+
+  // The labels are the communities
+  for(int u = 0; u < n; u++)
+    this->pLabels[u] = pJob->pCommunities[u];
+
+  _Communities_finish(this, pLevel, pJob, start);
+  _CommunitiesLevel_kill(pLevel);
+  _CommunitiesJob_kill(pJob);
+
+  return this;
+}
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 22:38:50
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ * 
+ * The connected components of the model.
+ * Two nodes can only be connected if they share a component, which can be checked in constant time.
+ */
+
+#ifndef COMPONENTS_C
+#define COMPONENTS_C
+
+#include "../structs/unionfind.c"
+
+#include <stdlib.h>
+
+typedef struct Components Components;
+
+/**
+ * Labels each node with its component.
+ * Components are numbered by decreasing size, so component 0 is always the largest.
+ */
+struct Components {
+
+  // How many components and nodes there are
+  int count;
+  int nodeCount;
+
+  // The component of each node, and the size of each component
+  int *pLabels;
+  int *pSizes;
+};
+
+/**
+ * The components interface.
+ */
+Components *_Components_alloc();
+Components *_Components_init(Components *this, UnionFind *pUnionFind);
+Components *Components_new(UnionFind *pUnionFind);
+void Components_kill(Components *this);
+
+int Components_isConnectable(Components *this, int a, int b);
+
+/**
+ * Orders (size, root) pairs by decreasing size, then by root.
+ * 
+ * @param   { const void * }  a   The first pair.
+ * @param   { const void * }  b   The second pair.
+ * @return  { int }               The ordering of the two pairs.
+*/
+static int _Components_compareSize(const void *a, const void *b) {
+  const int *pA = a;
+  const int *pB = b;
+
+  if(pA[0] != pB[0])
+    return pB[0] - pA[0];
+
+  return pA[1] - pB[1];
+}
+
+/**
+ * Allocates memory for the components.
+ * 
+ * @return  { Components * }  The memory for the components.
+*/
+Components *_Components_alloc() {
+  Components *pComponents = calloc(1, sizeof(*pComponents));
+
+  return pComponents;
+}
+
+/**
+ * Reads the components off a union-find whose elements are the node indices.
+ * 
+ * @param   { Components * }  this        The components to initialize.
+ * @param   { UnionFind * }   pUnionFind  The sets built while loading.
+ * @return  { Components * }              The initialized components.
+*/
+Components *_Components_init(Components *this, UnionFind *pUnionFind) {
+
+  // Grab the sizes
+  int n = pUnionFind->count;
+  this->nodeCount = n;
+  this->count = pUnionFind->setCount;
+  this->pLabels = malloc((n + 1) * sizeof(int));
+  this->pSizes = calloc(this->count + 1, sizeof(int));
+
+  // Count how big each root's set is, using the labels as scratch
+  int *pRootSizes = calloc(n + 1, sizeof(int));
+
+  for(int v = 0; v < n; v++) {
+    this->pLabels[v] = UnionFind_find(pUnionFind, v);
+    pRootSizes[this->pLabels[v]]++;
+  }
+
+  // Sort the roots by size
+  int *pPairs = malloc(2 * (this->count + 1) * sizeof(int));
+  int c = 0;
+
+  for(int v = 0; v < n; v++) {
+    if(!pRootSizes[v])
+      continue;
+
+    pPairs[2 * c] = pRootSizes[v];
+    pPairs[2 * c + 1] = v;
+    c++;
+  }
+
+  qsort(pPairs, c, 2 * sizeof(int), _Components_compareSize);
+
+  // Renumber the roots by their rank, reusing the size array
+  for(int i = 0; i < c; i++) {
+    pRootSizes[pPairs[2 * i + 1]] = i;
+    this->pSizes[i] = pPairs[2 * i];
+  }
+
+  for(int v = 0; v < n; v++)
+    this->pLabels[v] = pRootSizes[this->pLabels[v]];
+
+  // Garbage collection
+  free(pRootSizes);
+  free(pPairs);
+
+  return this;
+}
+
+/**
+ * Creates the components from a union-find.
+ * 
+ * @param   { UnionFind * }   pUnionFind  The sets built while loading.
+ * @return  { Components * }              The new components.
+*/
+Components *Components_new(UnionFind *pUnionFind) {
+  return _Components_init(_Components_alloc(), pUnionFind);
+}
+
+/**
+ * Frees the memory associated with the components.
+ * 
+ * @param   { Components * }  this  The components to free.
+*/
+void Components_kill(Components *this) {
+  free(this->pLabels);
+  free(this->pSizes);
+  free(this);
+}
+
+/**
+ * Checks whether two nodes are in the same component.
+ * If they aren't, there is no path between them.
+ * 
+ * @param   { Components * }  this  The components to check.
+ * @param   { int }           a     The index of the first node.
+ * @param   { int }           b     The index of the second node.
+ * @return  { int }                 Whether or not a path could exist.
+*/
+int Components_isConnectable(Components *this, int a, int b) {
+  return this->pLabels[a] == this->pLabels[b];
+}
+
+#endif
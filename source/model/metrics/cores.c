@@ -0,0 +1,399 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 03:02:18
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ *
+ * The core number of every node: the largest k such that the node is in a subgraph where everyone has k neighbors.
+ * Found by peeling off the lowest-degree node over and over, which takes linear time with nodes bucketed by degree.
+ * The parallel version peels a whole degree at a time instead, splitting each round across threads.
+ */
+
+#ifndef CORES_C
+#define CORES_C
+
+#include "../graph.c"
+#include "../../utils/thread.c"
+#include "../../utils/timer.c"
+
+#include <stdlib.h>
+#include <string.h>
+
+// How many nodes each thread claims at a time
+#define CORES_CHUNK 256
+
+// How many nodes it takes for the parallel version to be worth it
+#define CORES_PARALLEL_MIN (1 << 16)
+
+// Nodes that haven't been peeled yet
+#define CORES_UNPEELED (-1)
+
+typedef struct Cores Cores;
+typedef struct CoresJob CoresJob;
+
+/**
+ * The core number of every node.
+ */
+struct Cores {
+
+  // How many nodes there are, and the core of each
+  int nodeCount;
+  int *pCores;
+
+  // The highest core, and how many nodes have each core number up to it
+  int maxCore;
+  int *pCounts;
+
+  // The order the nodes were peeled in, so each has at most maxCore neighbors after it
+  // Only the sequential peel keeps it; it's NULL otherwise
+  int *pOrder;
+
+  // How long the peeling took
+  double seconds;
+};
+
+/**
+ * The state shared by the threads peeling a graph.
+ */
+struct CoresJob {
+
+  // The graph, and the degree each node has left
+  Graph *pGraph;
+  int *pDegrees;
+
+  // The core each node was peeled at
+  int *pCores;
+
+  // The nodes still in the graph
+  int *pRemaining;
+
+  // The nodes being peeled this round, and the ones found for the next
+  int *pFrontier;
+  int *pNext;
+  int nextCount;
+
+  // The degree being peeled
+  int level;
+};
+
+/**
+ * The cores interface.
+ */
+Cores *_Cores_alloc();
+Cores *_Cores_init(Cores *this, int nodeCount);
+Cores *Cores_new(Graph *pGraph);
+Cores *Cores_newParallel(Graph *pGraph);
+void Cores_kill(Cores *this);
+
+void _Cores_count(Cores *this);
+void _Cores_find(void *pArgs, int thread, int start, int end);
+void _Cores_peel(void *pArgs, int thread, int start, int end);
+int Cores_getSize(Cores *this, int k);
+
+/**
+ * Allocates memory for the cores.
+ *
+ * @return  { Cores * }   The memory for the cores.
+ */
+Cores *_Cores_alloc() {
+  Cores *pCores = calloc(1, sizeof(*pCores));
+
+  return pCores;
+}
+
+/**
+ * Initializes the cores of a graph with nothing peeled.
+ *
+ * @param   { Cores * }   this        The cores to initialize.
+ * @param   { int }       nodeCount   How many nodes there are.
+ * @return  { Cores * }               The initialized cores.
+ */
+Cores *_Cores_init(Cores *this, int nodeCount) {
+  this->nodeCount = nodeCount;
+  this->pCores = malloc((nodeCount + 1) * sizeof(int));
+  this->maxCore = 0;
+  this->pCounts = NULL;
+  this->pOrder = NULL;
+  this->seconds = 0;
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with the cores.
+ *
+ * @param   { Cores * }   this  The cores to free.
+ */
+void Cores_kill(Cores *this) {
+  free(this->pCores);
+  free(this->pCounts);
+  free(this->pOrder);
+  free(this);
+}
+
+/**
+ * Counts how many nodes have each core number, once all of them are known.
+ *
+ * @param   { Cores * }   this  The cores to count.
+ */
+void _Cores_count(Cores *this) {
+
+  // Find the highest core
+  this->maxCore = 0;
+  for(int i = 0; i < this->nodeCount; i++)
+    if(this->pCores[i] > this->maxCore)
+      this->maxCore = this->pCores[i];
+
+  // Then count each
+  this->pCounts = calloc(this->maxCore + 1, sizeof(int));
+  for(int i = 0; i < this->nodeCount; i++)
+    this->pCounts[this->pCores[i]]++;
+}
+
+/**
+ * Computes the core numbers by peeling (Batagelj and Zaversnik).
+ * Nodes are kept sorted by their remaining degree in one flat array, with the start of each degree saved.
+ * Taking the nodes in that order, each one lowers the degree of its higher neighbors, which only has to
+ * swap them to the front of their bucket and move the bucket's start. Everything is O(n + m).
+ *
+ * @param   { Graph * }   pGraph  The graph to peel.
+ * @return  { Cores * }           The cores.
+ */
+Cores *Cores_new(Graph *pGraph) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Cores *this = _Cores_init(_Cores_alloc(), n);
+
+  // The remaining degrees are the cores once everything is peeled
+  int *pDegrees = this->pCores;
+  int maxDegree = 0;
+
+  for(int v = 0; v < n; v++) {
+    pDegrees[v] = Graph_getDegree(pGraph, v);
+
+    if(pDegrees[v] > maxDegree)
+      maxDegree = pDegrees[v];
+  }
+
+  // Where each degree starts, by counting then summing
+  int *pStarts = calloc(maxDegree + 2, sizeof(int));
+  int *pOrder = malloc((n + 1) * sizeof(int));
+  int *pPositions = malloc((n + 1) * sizeof(int));
+
+  for(int v = 0; v < n; v++)
+    pStarts[pDegrees[v] + 1]++;
+
+  for(int d = 0; d < maxDegree; d++)
+    pStarts[d + 1] += pStarts[d];
+
+  // Lay the nodes out by degree
+  for(int v = 0; v < n; v++) {
+    pPositions[v] = pStarts[pDegrees[v]]++;
+    pOrder[pPositions[v]] = v;
+  }
+
+  // Shift the starts back after the placing moved them along
+  for(int d = maxDegree; d > 0; d--)
+    pStarts[d] = pStarts[d - 1];
+
+  pStarts[0] = 0;
+
+  // Peel the lowest remaining node each time
+  for(int i = 0; i < n; i++) {
+    int v = pOrder[i];
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+
+    for(int j = 0; j < degree; j++) {
+      int u = pAdjs[j];
+
+      // Already peeled, or at the same level
+      if(pDegrees[u] <= pDegrees[v])
+        continue;
+
+      // Swap it with the first node of its bucket, then shrink the bucket past it
+      int d = pDegrees[u];
+      int first = pOrder[pStarts[d]];
+
+      if(first != u) {
+        pOrder[pPositions[u]] = first;
+        pOrder[pStarts[d]] = u;
+        pPositions[first] = pPositions[u];
+        pPositions[u] = pStarts[d];
+      }
+
+      pStarts[d]++;
+      pDegrees[u]--;
+    }
+  }
+
+  // Garbage collection; the order is kept
+  free(pStarts);
+  free(pPositions);
+
+  this->pOrder = pOrder;
+  _Cores_count(this);
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+/**
+ * Finds the remaining nodes within the given range whose degree has dropped to the level being peeled.
+ *
+ * @param   { void * }  pArgs   The shared CoresJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first remaining node to check.
+ * @param   { int }     end     One past the last remaining node to check.
+ */
+void _Cores_find(void *pArgs, int thread, int start, int end) {
+  CoresJob *pJob = pArgs;
+
+  for(int i = start; i < end; i++) {
+    int v = pJob->pRemaining[i];
+
+    // Down to this level and not claimed yet
+    if(pJob->pCores[v] == CORES_UNPEELED && pJob->pDegrees[v] <= pJob->level) {
+      pJob->pCores[v] = pJob->level;
+      pJob->pNext[__atomic_fetch_add(&pJob->nextCount, 1, __ATOMIC_RELAXED)] = v;
+    }
+  }
+}
+
+/**
+ * Peels the nodes of the frontier within the given range, lowering the degrees of their neighbors.
+ * A neighbor whose degree drops to the level is peeled in the next round of the same level.
+ * Only the thread that brings it down to exactly the level claims it, so nobody is peeled twice.
+ *
+ * @param   { void * }  pArgs   The shared CoresJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node of the frontier to peel.
+ * @param   { int }     end     One past the last node to peel.
+ */
+void _Cores_peel(void *pArgs, int thread, int start, int end) {
+  CoresJob *pJob = pArgs;
+  Graph *pGraph = pJob->pGraph;
+  int level = pJob->level;
+
+  for(int i = start; i < end; i++) {
+    int v = pJob->pFrontier[i];
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+
+    for(int j = 0; j < degree; j++) {
+      int u = pAdjs[j];
+
+      // Already at or below the level, so it's peeled or about to be
+      if(__atomic_load_n(&pJob->pDegrees[u], __ATOMIC_RELAXED) <= level)
+        continue;
+
+      // Take one away, and claim it if that's what brought it down
+      int left = __atomic_sub_fetch(&pJob->pDegrees[u], 1, __ATOMIC_RELAXED);
+
+      if(left == level) {
+        pJob->pCores[u] = level;
+        pJob->pNext[__atomic_fetch_add(&pJob->nextCount, 1, __ATOMIC_RELAXED)] = u;
+      }
+
+      // Went past the level because of another thread; put it back
+      else if(left < level)
+        __atomic_fetch_add(&pJob->pDegrees[u], 1, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+/**
+ * Computes the core numbers by peeling a whole level at a time, across threads.
+ * Each level starts with a scan of the remaining nodes for those at that degree, then peels them in rounds
+ * until no more drop to the level. The remaining nodes are compacted whenever half of them are gone,
+ * so the scans cost O(n) per level at most and far less once most of the graph is peeled.
+ *
+ * @param   { Graph * }   pGraph  The graph to peel.
+ * @return  { Cores * }           The cores.
+ */
+Cores *Cores_newParallel(Graph *pGraph) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Cores *this = _Cores_init(_Cores_alloc(), n);
+
+  // The shared state
+  CoresJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+  pJob->pCores = this->pCores;
+  pJob->pDegrees = malloc((n + 1) * sizeof(int));
+  pJob->pRemaining = malloc((n + 1) * sizeof(int));
+  pJob->pFrontier = malloc((n + 1) * sizeof(int));
+  pJob->pNext = malloc((n + 1) * sizeof(int));
+
+  for(int v = 0; v < n; v++) {
+    pJob->pDegrees[v] = Graph_getDegree(pGraph, v);
+    pJob->pCores[v] = CORES_UNPEELED;
+    pJob->pRemaining[v] = v;
+  }
+
+  // Peel one level at a time
+  int remainingCount = n;
+  int compactedCount = n;
+  int peeledCount = 0;
+
+  for(pJob->level = 0; peeledCount < n; pJob->level++) {
+
+    // Find whoever is down to this level
+    pJob->nextCount = 0;
+    Thread_parallelFor(remainingCount, CORES_CHUNK, _Cores_find, pJob);
+
+    // Peel in rounds until nobody else drops to it
+    while(pJob->nextCount) {
+      int *pTemp = pJob->pFrontier;
+      pJob->pFrontier = pJob->pNext;
+      pJob->pNext = pTemp;
+
+      int frontierCount = pJob->nextCount;
+      peeledCount += frontierCount;
+      pJob->nextCount = 0;
+
+      Thread_parallelFor(frontierCount, CORES_CHUNK, _Cores_peel, pJob);
+    }
+
+    // Drop the peeled nodes from the scans once half of them are gone
+    if(n - peeledCount < compactedCount / 2) {
+      int kept = 0;
+
+      for(int i = 0; i < remainingCount; i++)
+        if(pJob->pCores[pJob->pRemaining[i]] == CORES_UNPEELED)
+          pJob->pRemaining[kept++] = pJob->pRemaining[i];
+
+      remainingCount = compactedCount = kept;
+    }
+  }
+
+  // Garbage collection
+  free(pJob->pDegrees);
+  free(pJob->pRemaining);
+  free(pJob->pFrontier);
+  free(pJob->pNext);
+  free(pJob);
+
+  _Cores_count(this);
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+/**
+ * Counts the nodes of the k-core, which are those with a core number of at least k.
+ *
+ * @param   { Cores * }   this  The cores to read.
+ * @param   { int }       k     The core to size.
+ * @return  { int }             How many nodes are in the k-core.
+ */
+int Cores_getSize(Cores *this, int k) {
+  int size = 0;
+
+  for(int c = k < 0 ? 0 : k; c <= this->maxCore; c++)
+    size += this->pCounts[c];
+
+  return size;
+}
+
+#endif
@@ -0,0 +1,257 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 02:31:52
+ * @ Modified time: 2026-10-19 02:31:52
+ * @ Description:
+ *
+ * Degree statistics that are kept up to date while the edges come in.
+ * Every update is constant time, so the summary is ready the moment loading finishes.
+ */
+
+#ifndef DEGREES_C
+#define DEGREES_C
+
+#include <stdlib.h>
+#include <string.h>
+
+// How many of the highest-degree nodes are tracked
+#define DEGREES_TOP_COUNT 10
+
+typedef struct Degrees Degrees;
+
+/**
+ * The degree of every node, and running aggregates over all of them.
+ */
+struct Degrees {
+
+  // The degree of each node, and how many fit
+  int *pDegrees;
+  int count;
+  int limit;
+
+  // How many nodes have each degree, up to the highest one so far
+  int *pHistogram;
+  int histogramLimit;
+  int maxDegree;
+
+  // The sums of the degrees and of their squares
+  long sum;
+  double squares;
+
+  // The highest-degree nodes, highest first
+  int pTop[DEGREES_TOP_COUNT];
+  int topCount;
+};
+
+/**
+ * The degrees interface.
+ */
+Degrees *_Degrees_alloc();
+Degrees *_Degrees_init(Degrees *this, int limit);
+Degrees *Degrees_new(int limit);
+void Degrees_kill(Degrees *this);
+
+int Degrees_add(Degrees *this);
+void _Degrees_increment(Degrees *this, int i);
+void Degrees_link(Degrees *this, int a, int b);
+
+int Degrees_getMin(Degrees *this);
+double Degrees_getMean(Degrees *this);
+double Degrees_getVariance(Degrees *this);
+double Degrees_getFriendMean(Degrees *this);
+
+/**
+ * Allocates memory for the degrees.
+ *
+ * @return  { Degrees * }   The memory for the degrees.
+ */
+Degrees *_Degrees_alloc() {
+  Degrees *pDegrees = calloc(1, sizeof(*pDegrees));
+
+  return pDegrees;
+}
+
+/**
+ * Initializes the degrees with no nodes.
+ *
+ * @param   { Degrees * }   this    The degrees to initialize.
+ * @param   { int }         limit   How many nodes to make room for at first.
+ * @return  { Degrees * }           The initialized degrees.
+ */
+Degrees *_Degrees_init(Degrees *this, int limit) {
+
+  // Make room
+  this->limit = limit < 16 ? 16 : limit;
+  this->pDegrees = malloc(this->limit * sizeof(int));
+  this->histogramLimit = 16;
+  this->pHistogram = calloc(this->histogramLimit, sizeof(int));
+
+  // Nothing in it yet
+  this->count = 0;
+  this->maxDegree = 0;
+  this->sum = 0;
+  this->squares = 0;
+  this->topCount = 0;
+
+  return this;
+}
+
+/**
+ * Creates new degrees with no nodes.
+ *
+ * @param   { int }         limit   How many nodes to make room for at first.
+ * @return  { Degrees * }           The new degrees.
+ */
+Degrees *Degrees_new(int limit) {
+  return _Degrees_init(_Degrees_alloc(), limit);
+}
+
+/**
+ * Frees the memory associated with the degrees.
+ *
+ * @param   { Degrees * }   this  The degrees to free.
+ */
+void Degrees_kill(Degrees *this) {
+  free(this->pDegrees);
+  free(this->pHistogram);
+  free(this);
+}
+
+/**
+ * Adds a node with no edges.
+ *
+ * @param   { Degrees * }   this  The degrees to add to.
+ * @return  { int }               The index of the new node.
+ */
+int Degrees_add(Degrees *this) {
+
+  // Grow if needed
+  if(this->count == this->limit) {
+    this->limit <<= 1;
+    this->pDegrees = realloc(this->pDegrees, this->limit * sizeof(int));
+  }
+
+  // No edges yet
+  this->pDegrees[this->count] = 0;
+  this->pHistogram[0]++;
+
+  // Fill the top while there's room; it has no edges, so it goes last
+  if(this->topCount < DEGREES_TOP_COUNT)
+    this->pTop[this->topCount++] = this->count;
+
+  return this->count++;
+}
+
+/**
+ * Gives a node one more edge, updating every aggregate along the way.
+ * Degrees only go up, so a node enters the top by passing its last entry, and then only ever moves up.
+ *
+ * @param   { Degrees * }   this  The degrees to update.
+ * @param   { int }         i     The node that gained an edge.
+ */
+void _Degrees_increment(Degrees *this, int i) {
+  long d = this->pDegrees[i]++;
+
+  // The moments, since (d + 1)^2 - d^2 = 2d + 1
+  this->sum++;
+  this->squares += 2 * d + 1;
+
+  // Grow the histogram if needed
+  if(d + 1 == this->histogramLimit) {
+    this->pHistogram = realloc(this->pHistogram, 2 * this->histogramLimit * sizeof(int));
+    memset(this->pHistogram + this->histogramLimit, 0, this->histogramLimit * sizeof(int));
+    this->histogramLimit *= 2;
+  }
+
+  // Move it up a bin
+  this->pHistogram[d]--;
+  this->pHistogram[d + 1]++;
+
+  if(d + 1 > this->maxDegree)
+    this->maxDegree = d + 1;
+
+  // Not high enough to matter to the top
+  int last = this->topCount - 1;
+
+  if(last < 0 || d + 1 <= this->pDegrees[this->pTop[last]] - (this->pTop[last] == i))
+    return;
+
+  // Find it in the top, or take the last spot
+  int j = last;
+  while(j > 0 && this->pTop[j] != i)
+    j--;
+
+  if(this->pTop[j] != i)
+    j = last;
+
+  // Then bubble it up
+  for(; j > 0 && this->pDegrees[this->pTop[j - 1]] < d + 1; j--)
+    this->pTop[j] = this->pTop[j - 1];
+
+  this->pTop[j] = i;
+}
+
+/**
+ * Records an edge between two nodes.
+ * The caller makes sure the edge is new; an edge from a node to itself counts once.
+ *
+ * @param   { Degrees * }   this  The degrees to update.
+ * @param   { int }         a     One end of the edge.
+ * @param   { int }         b     The other end of the edge.
+ */
+void Degrees_link(Degrees *this, int a, int b) {
+  _Degrees_increment(this, a);
+
+  if(a != b)
+    _Degrees_increment(this, b);
+}
+
+/**
+ * Gets the lowest degree, from the first bin of the histogram that isn't empty.
+ *
+ * @param   { Degrees * }   this  The degrees to read.
+ * @return  { int }               The lowest degree, or 0 if there are no nodes.
+ */
+int Degrees_getMin(Degrees *this) {
+  int d = 0;
+
+  while(d < this->maxDegree && !this->pHistogram[d])
+    d++;
+
+  return d;
+}
+
+/**
+ * Gets the mean degree.
+ *
+ * @param   { Degrees * }   this  The degrees to read.
+ * @return  { double }            The mean degree.
+ */
+double Degrees_getMean(Degrees *this) {
+  return this->count ? (double) this->sum / this->count : 0;
+}
+
+/**
+ * Gets the variance of the degrees.
+ *
+ * @param   { Degrees * }   this  The degrees to read.
+ * @return  { double }            The variance of the degrees.
+ */
+double Degrees_getVariance(Degrees *this) {
+  double mean = Degrees_getMean(this);
+
+  return this->count ? this->squares / this->count - mean * mean : 0;
+}
+
+/**
+ * Gets the mean degree of a friend: picking a random edge end, how many friends does it have on average?
+ * This is never below the mean degree, which is why your friends seem to have more friends than you.
+ *
+ * @param   { Degrees * }   this  The degrees to read.
+ * @return  { double }            The mean degree of a friend.
+ */
+double Degrees_getFriendMean(Degrees *this) {
+  return this->sum ? this->squares / this->sum : 0;
+}
+
+#endif
@@ -0,0 +1,392 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 04:21:37
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ *
+ * The exact diameter, radius and eccentricities of the graph, without a search from every node.
+ * Each search bounds the eccentricities of everyone else, and on social graphs a handful of them settle everything.
+ * Eccentricities are measured within each node's own component.
+ */
+
+#ifndef ECCENTRICITY_C
+#define ECCENTRICITY_C
+
+#include "../graph.c"
+#include "./components.c"
+#include "../search/bfs.c"
+#include "../../utils/timer.c"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct Eccentricity Eccentricity;
+
+/**
+ * The extremes of the distances in the graph, and how much searching it took to pin them down.
+ */
+struct Eccentricity {
+
+  // How many nodes there are, and the eccentricity of each when all of them were asked for
+  int nodeCount;
+  int *pEccentricities;
+
+  // The longest shortest path, and two nodes it runs between
+  int diameter;
+  int source;
+  int target;
+
+  // The smallest eccentricity within the largest component, and a node that has it
+  // These are -1 when only the diameter was asked for
+  int radius;
+  int center;
+
+  // How many searches it took, how many adjacencies they scanned, and how long
+  int bfsCount;
+  long edgeCount;
+  double seconds;
+
+  // The scratch shared by the searches
+  int *pDistances;
+};
+
+/**
+ * The eccentricity interface.
+ */
+Eccentricity *_Eccentricity_alloc();
+Eccentricity *_Eccentricity_init(Eccentricity *this, int nodeCount);
+Eccentricity *Eccentricity_newDiameter(Graph *pGraph, Components *pComponents);
+Eccentricity *Eccentricity_newAll(Graph *pGraph, Components *pComponents);
+void Eccentricity_kill(Eccentricity *this);
+
+int _Eccentricity_search(Eccentricity *this, Graph *pGraph, int source, int *pFarthest);
+int _Eccentricity_sweep(Eccentricity *this, Graph *pGraph, Components *pComponents, int component, int start);
+void _Eccentricity_bound(Eccentricity *this, Graph *pGraph, Components *pComponents, int component);
+
+/**
+ * Allocates memory for the eccentricities.
+ *
+ * @return  { Eccentricity * }  The memory for the eccentricities.
+ */
+Eccentricity *_Eccentricity_alloc() {
+  Eccentricity *pEccentricity = calloc(1, sizeof(*pEccentricity));
+
+  return pEccentricity;
+}
+
+/**
+ * Initializes the eccentricities with nothing searched yet.
+ *
+ * @param   { Eccentricity * }  this        The eccentricities to initialize.
+ * @param   { int }             nodeCount   How many nodes there are.
+ * @return  { Eccentricity * }              The initialized eccentricities.
+ */
+Eccentricity *_Eccentricity_init(Eccentricity *this, int nodeCount) {
+  this->nodeCount = nodeCount;
+  this->pEccentricities = NULL;
+  this->pDistances = malloc((nodeCount + 1) * sizeof(int));
+
+  // Nothing found yet
+  this->diameter = 0;
+  this->source = -1;
+  this->target = -1;
+  this->radius = -1;
+  this->center = -1;
+  this->bfsCount = 0;
+  this->edgeCount = 0;
+  this->seconds = 0;
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with the eccentricities.
+ *
+ * @param   { Eccentricity * }  this  The eccentricities to free.
+ */
+void Eccentricity_kill(Eccentricity *this) {
+  free(this->pEccentricities);
+  free(this->pDistances);
+  free(this);
+}
+
+/**
+ * Runs a single search, counting it, and keeps the diameter up to date with what it found.
+ * Leaves the distances from the source in pDistances.
+ *
+ * @param   { Eccentricity * }  this        The eccentricities being computed.
+ * @param   { Graph * }         pGraph      The graph to search.
+ * @param   { int }             source      The node to search from.
+ * @param   { int * }           pFarthest   Where to write a node farthest from the source; may be NULL.
+ * @return  { int }                         The eccentricity of the source.
+ */
+int _Eccentricity_search(Eccentricity *this, Graph *pGraph, int source, int *pFarthest) {
+  BFSStats stats;
+  int eccentricity = BFS_distancesParallel(pGraph, source, this->pDistances, &stats);
+
+  this->bfsCount++;
+  this->edgeCount += stats.edgeCount;
+
+  // Find who's at the end
+  int farthest = source;
+
+  for(int v = 0; v < pGraph->nodeCount && eccentricity > 0; v++) {
+    if(this->pDistances[v] == eccentricity) {
+      farthest = v;
+      break;
+    }
+  }
+
+  // A longer path than any so far
+  if(eccentricity > this->diameter || this->source < 0) {
+    this->diameter = eccentricity;
+    this->source = source;
+    this->target = farthest;
+  }
+
+  if(pFarthest != NULL)
+    *pFarthest = farthest;
+
+  return eccentricity;
+}
+
+/**
+ * Computes the diameter of a component by iterative fringe upper bounding (Crescenzi et al.).
+ * A 4-sweep first picks a central node u and a good lower bound. Every node at distance i from u has an
+ * eccentricity of at most 2i, so going through the fringes of u from the farthest in, the diameter is settled
+ * as soon as the lower bound reaches 2(i - 1). The result is folded into this->diameter.
+ *
+ * @param   { Eccentricity * }  this          The eccentricities being computed.
+ * @param   { Graph * }         pGraph        The graph to search.
+ * @param   { Components * }    pComponents   The components of the graph.
+ * @param   { int }             component     The component to measure.
+ * @param   { int }             start         A node of the component with the highest degree.
+ * @return  { int }                           The diameter of the component.
+ */
+int _Eccentricity_sweep(Eccentricity *this, Graph *pGraph, Components *pComponents, int component, int start) {
+  int n = pGraph->nodeCount;
+  int size = pComponents->pSizes[component];
+  int lower = 0;
+  int a, b;
+
+  // Two double sweeps, each starting from the middle of the last path found
+  int *pParents = malloc((n + 1) * sizeof(int));
+  int middle = start;
+
+  for(int sweep = 0; sweep < 2; sweep++) {
+    _Eccentricity_search(this, pGraph, middle, &a);
+
+    // The path from a to the farthest node, walked halfway back
+    BFSStats stats;
+    int eccentricity = BFS_tree(pGraph, a, pParents, this->pDistances, &stats);
+    this->bfsCount++;
+    this->edgeCount += stats.edgeCount;
+
+    for(b = 0; b < n; b++)
+      if(this->pDistances[b] == eccentricity)
+        break;
+
+    if(eccentricity > lower)
+      lower = eccentricity;
+
+    if(eccentricity > this->diameter) {
+      this->diameter = eccentricity;
+      this->source = a;
+      this->target = b;
+    }
+
+    for(middle = b; this->pDistances[middle] > eccentricity / 2; middle = pParents[middle]);
+  }
+
+  free(pParents);
+
+  // Bucket the component by distance from the middle
+  int eccentricity = _Eccentricity_search(this, pGraph, middle, NULL);
+  int *pStarts = calloc(eccentricity + 2, sizeof(int));
+  int *pSorted = malloc((size + 1) * sizeof(int));
+
+  if(eccentricity > lower)
+    lower = eccentricity;
+
+  for(int v = 0; v < n; v++)
+    if(this->pDistances[v] >= 0)
+      pStarts[this->pDistances[v] + 1]++;
+
+  for(int i = 0; i <= eccentricity; i++)
+    pStarts[i + 1] += pStarts[i];
+
+  // Then place them, with the starts shifting along to the end of each bucket
+  for(int v = 0; v < n; v++)
+    if(this->pDistances[v] >= 0)
+      pSorted[pStarts[this->pDistances[v]]++] = v;
+
+  // Go through the fringes from the outside in, until the nodes left can't be farther apart
+  for(int i = eccentricity; i > 0 && lower < 2 * i; i--) {
+    for(int j = pStarts[i - 1]; j < pStarts[i] && lower < 2 * i; j++) {
+      int e = _Eccentricity_search(this, pGraph, pSorted[j], NULL);
+
+      if(e > lower)
+        lower = e;
+    }
+  }
+
+  // Garbage collection
+  free(pStarts);
+  free(pSorted);
+
+  return lower;
+}
+
+/**
+ * Computes the diameter of the graph, measuring the components from the largest down.
+ * A component with no more nodes than the diameter so far can't have a longer path, so it's skipped.
+ *
+ * @param   { Graph * }           pGraph        The graph to measure.
+ * @param   { Components * }      pComponents   The components of the graph.
+ * @return  { Eccentricity * }                  The diameter, and the searches it took.
+ */
+Eccentricity *Eccentricity_newDiameter(Graph *pGraph, Components *pComponents) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Eccentricity *this = _Eccentricity_init(_Eccentricity_alloc(), n);
+
+  // The best place to start each component is its highest-degree node
+  int *pStarts = malloc((pComponents->count + 1) * sizeof(int));
+
+  for(int c = 0; c < pComponents->count; c++)
+    pStarts[c] = -1;
+
+  for(int v = 0; v < n; v++) {
+    int c = pComponents->pLabels[v];
+
+    if(pStarts[c] < 0 || Graph_getDegree(pGraph, v) > Graph_getDegree(pGraph, pStarts[c]))
+      pStarts[c] = v;
+  }
+
+  // Measure every component that could still hold the longest path
+  for(int c = 0; c < pComponents->count; c++)
+    if(pComponents->pSizes[c] - 1 > this->diameter)
+      _Eccentricity_sweep(this, pGraph, pComponents, c, pStarts[c]);
+
+  // Nothing but isolated nodes
+  if(this->source < 0 && n) {
+    this->source = 0;
+    this->target = 0;
+  }
+
+  free(pStarts);
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+/**
+ * Computes the eccentricity of every node in a component by bounding them (Takes and Kosters).
+ * Searching from v shows that every w is at least max(d(v, w), e(v) - d(v, w)) and at most e(v) + d(v, w)
+ * from its farthest node. The search alternates between the node with the highest upper bound and the one
+ * with the lowest lower bound, favoring those with more friends, until every bound has closed.
+ *
+ * @param   { Eccentricity * }  this          The eccentricities being computed.
+ * @param   { Graph * }         pGraph        The graph to search.
+ * @param   { Components * }    pComponents   The components of the graph.
+ * @param   { int }             component     The component to measure.
+ */
+void _Eccentricity_bound(Eccentricity *this, Graph *pGraph, Components *pComponents, int component) {
+  int n = pGraph->nodeCount;
+  int size = pComponents->pSizes[component];
+
+  // The nodes still open, and their bounds
+  int *pOpen = malloc((size + 1) * sizeof(int));
+  int *pLower = malloc((n + 1) * sizeof(int));
+  int *pUpper = this->pEccentricities;
+  int openCount = 0;
+
+  for(int v = 0; v < n; v++) {
+    if(pComponents->pLabels[v] != component)
+      continue;
+
+    pOpen[openCount++] = v;
+    pLower[v] = 0;
+    pUpper[v] = size - 1;
+  }
+
+  // Search until every bound closes
+  for(int step = 0; openCount; step++) {
+    int best = pOpen[0];
+
+    // Alternate between the highest upper bound and the lowest lower bound
+    for(int i = 1; i < openCount; i++) {
+      int v = pOpen[i];
+      int better = step & 1 ?
+        pLower[v] < pLower[best] || (pLower[v] == pLower[best] && Graph_getDegree(pGraph, v) > Graph_getDegree(pGraph, best)) :
+        pUpper[v] > pUpper[best] || (pUpper[v] == pUpper[best] && Graph_getDegree(pGraph, v) > Graph_getDegree(pGraph, best));
+
+      if(better)
+        best = v;
+    }
+
+    int e = _Eccentricity_search(this, pGraph, best, NULL);
+
+    // Tighten everyone's bounds, and close those that meet
+    for(int i = 0; i < openCount; i++) {
+      int w = pOpen[i];
+      int d = this->pDistances[w];
+
+      if(d > pLower[w])
+        pLower[w] = d;
+      if(e - d > pLower[w])
+        pLower[w] = e - d;
+      if(e + d < pUpper[w])
+        pUpper[w] = e + d;
+
+      if(pLower[w] == pUpper[w])
+        pOpen[i--] = pOpen[--openCount];
+    }
+  }
+
+  // Garbage collection
+  free(pOpen);
+  free(pLower);
+}
+
+/**
+ * Computes the eccentricity of every node, along with the diameter and the radius.
+ * Isolated nodes are settled without a search, and the radius is taken within the largest component.
+ *
+ * @param   { Graph * }           pGraph        The graph to measure.
+ * @param   { Components * }      pComponents   The components of the graph.
+ * @return  { Eccentricity * }                  The eccentricities, and the searches they took.
+ */
+Eccentricity *Eccentricity_newAll(Graph *pGraph, Components *pComponents) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  Eccentricity *this = _Eccentricity_init(_Eccentricity_alloc(), n);
+  this->pEccentricities = calloc(n + 1, sizeof(int));
+
+  // Bound each component with more than one node
+  for(int c = 0; c < pComponents->count && pComponents->pSizes[c] > 1; c++)
+    _Eccentricity_bound(this, pGraph, pComponents, c);
+
+  // Find the center of the largest component
+  for(int v = 0; v < n; v++) {
+    if(pComponents->pLabels[v])
+      continue;
+
+    if(this->center < 0 || this->pEccentricities[v] < this->radius) {
+      this->radius = this->pEccentricities[v];
+      this->center = v;
+    }
+  }
+
+  // Nothing but isolated nodes
+  if(this->source < 0 && n) {
+    this->source = 0;
+    this->target = 0;
+  }
+
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+#endif
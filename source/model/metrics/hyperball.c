@@ -0,0 +1,400 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 05:02:26
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ *
+ * Approximates how many nodes lie within each distance of every node (HyperANF, or HyperBall).
+ * Each node keeps a HyperLogLog counter of the nodes within t hops, and a round of unions with its neighbors'
+ * counters moves that to t + 1. That gives the distance distribution of the whole graph and the harmonic
+ * centrality of every node in a handful of linear passes, with no distances stored anywhere.
+ */
+
+#ifndef HYPERBALL_C
+#define HYPERBALL_C
+
+#include "../graph.c"
+#include "../../utils/math.c"
+#include "../../utils/thread.c"
+#include "../../utils/timer.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// How many registers each counter has, as a power of 2
+// With 64 of them a counter fills a cache line and is off by about 13% on its own, much less once summed
+#define HYPERBALL_LOG_REGISTERS 6
+#define HYPERBALL_REGISTERS (1 << HYPERBALL_LOG_REGISTERS)
+
+// The bias correction for that many registers
+#define HYPERBALL_ALPHA 0.709
+
+// When to give up if the balls keep growing
+#define HYPERBALL_MAX_DEPTH 64
+
+// The share of pairs the effective diameter covers
+#define HYPERBALL_QUANTILE 0.9
+
+// How many nodes each thread claims at a time
+#define HYPERBALL_CHUNK 256
+
+/**
+ * The registers of a single counter.
+ * Unions are register-wise maxima, which map to byte-wise vector instructions.
+ * The reduced alignment lets us keep these in plain malloc'd arrays.
+ */
+typedef uint8_t HyperBallCounter __attribute__((vector_size(HYPERBALL_REGISTERS), aligned(1)));
+
+typedef struct HyperBall HyperBall;
+typedef struct HyperBallJob HyperBallJob;
+
+/**
+ * The distance distribution of the graph, and the harmonic centrality of every node.
+ */
+struct HyperBall {
+
+  // How many nodes there are
+  int nodeCount;
+
+  // The counter of each node, and the ones being built for the next round
+  HyperBallCounter *pCounters;
+  HyperBallCounter *pNext;
+
+  // The estimated size of each ball so far, and whether it grew in the last round
+  double *pSizes;
+  char *pChanged;
+
+  // The estimated harmonic centrality of each node: the sum of 1 / d over everyone it reaches
+  double *pHarmonic;
+
+  // The estimated number of pairs within t hops of each other, counting each node with itself
+  double pNeighborhood[HYPERBALL_MAX_DEPTH + 1];
+  int depth;
+
+  // How long it took
+  double seconds;
+};
+
+/**
+ * The state shared by the threads running a round.
+ */
+struct HyperBallJob {
+
+  // The graph and the counters
+  Graph *pGraph;
+  HyperBall *pBall;
+
+  // The round being run
+  int round;
+
+  // The sum of the sizes, and how many balls grew, for each thread
+  double sums[THREAD_MAX_COUNT];
+  int changes[THREAD_MAX_COUNT];
+};
+
+/**
+ * The hyperball interface.
+ */
+HyperBall *_HyperBall_alloc();
+HyperBall *_HyperBall_init(HyperBall *this, int nodeCount);
+HyperBall *HyperBall_new(Graph *pGraph);
+void HyperBall_kill(HyperBall *this);
+
+double _HyperBall_estimate(HyperBallCounter *pCounter);
+void _HyperBall_step(void *pArgs, int thread, int start, int end);
+
+double HyperBall_getPairs(HyperBall *this);
+double HyperBall_getWithin(HyperBall *this, int t);
+double HyperBall_getAverageDistance(HyperBall *this);
+double HyperBall_getEffectiveDiameter(HyperBall *this, double quantile);
+
+// The linear-counting estimate for each number of empty registers, and 2^-k for each register value
+double HYPERBALL_LINEAR[HYPERBALL_REGISTERS + 1];
+double HYPERBALL_POWERS[256];
+
+/**
+ * Allocates memory for the hyperball.
+ *
+ * @return  { HyperBall * }   The memory for the hyperball.
+ */
+HyperBall *_HyperBall_alloc() {
+  HyperBall *pHyperBall = calloc(1, sizeof(*pHyperBall));
+
+  return pHyperBall;
+}
+
+/**
+ * Initializes the hyperball with every ball holding only its own node.
+ *
+ * @param   { HyperBall * }   this        The hyperball to initialize.
+ * @param   { int }           nodeCount   How many nodes there are.
+ * @return  { HyperBall * }               The initialized hyperball.
+ */
+HyperBall *_HyperBall_init(HyperBall *this, int nodeCount) {
+  this->nodeCount = nodeCount;
+  this->pCounters = calloc(nodeCount + 1, sizeof(HyperBallCounter));
+  this->pNext = calloc(nodeCount + 1, sizeof(HyperBallCounter));
+  this->pSizes = malloc((nodeCount + 1) * sizeof(double));
+  this->pChanged = malloc(nodeCount + 1);
+  this->pHarmonic = calloc(nodeCount + 1, sizeof(double));
+  this->depth = 0;
+  this->seconds = 0;
+
+  // The tables, filled once
+  for(int k = 0; k < 256; k++)
+    HYPERBALL_POWERS[k] = k ? HYPERBALL_POWERS[k - 1] / 2 : 1;
+
+  for(int v = 1; v <= HYPERBALL_REGISTERS; v++)
+    HYPERBALL_LINEAR[v] = HYPERBALL_REGISTERS * Math_log((double) HYPERBALL_REGISTERS / v);
+
+  // Add each node to its own counter
+  for(int v = 0; v < nodeCount; v++) {
+
+    // Mix the index (splitmix64)
+    uint64_t h = (uint64_t) v + 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+
+    // The low bits pick the register, and the rest give the position of the first 1
+    uint64_t rest = h >> HYPERBALL_LOG_REGISTERS;
+    int rank = rest ? __builtin_ctzll(rest) + 1 : 64 - HYPERBALL_LOG_REGISTERS + 1;
+
+    this->pCounters[v][h & (HYPERBALL_REGISTERS - 1)] = rank;
+    this->pSizes[v] = 1;
+    this->pChanged[v] = 1;
+  }
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with the hyperball.
+ *
+ * @param   { HyperBall * }   this  The hyperball to free.
+ */
+void HyperBall_kill(HyperBall *this) {
+  free(this->pCounters);
+  free(this->pNext);
+  free(this->pSizes);
+  free(this->pChanged);
+  free(this->pHarmonic);
+  free(this);
+}
+
+/**
+ * Estimates how many nodes a counter has seen.
+ * Small counts with empty registers left fall back to linear counting, which is more accurate there.
+ *
+ * @param   { HyperBallCounter * }  pCounter  The counter to read.
+ * @return  { double }                        The estimated count.
+ */
+double _HyperBall_estimate(HyperBallCounter *pCounter) {
+  double sum = 0;
+  int zeros = 0;
+
+  for(int j = 0; j < HYPERBALL_REGISTERS; j++) {
+    sum += HYPERBALL_POWERS[(*pCounter)[j]];
+    zeros += !(*pCounter)[j];
+  }
+
+  double estimate = HYPERBALL_ALPHA * HYPERBALL_REGISTERS * HYPERBALL_REGISTERS / sum;
+
+  // Small range
+  if(estimate <= 2.5 * HYPERBALL_REGISTERS && zeros)
+    return HYPERBALL_LINEAR[zeros];
+
+  return estimate;
+}
+
+/**
+ * Grows the balls of the nodes within the given range by one hop.
+ * A node's new counter is the union of its own with those of its neighbors, but only the neighbors
+ * whose balls grew last round can add anything. The growth of each ball is added to the node's harmonic
+ * centrality, since those nodes are exactly round hops away.
+ *
+ * @param   { void * }  pArgs   The shared HyperBallJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to grow.
+ * @param   { int }     end     One past the last node to grow.
+ */
+void _HyperBall_step(void *pArgs, int thread, int start, int end) {
+  HyperBallJob *pJob = pArgs;
+  HyperBall *pBall = pJob->pBall;
+  Graph *pGraph = pJob->pGraph;
+  double sum = 0;
+  int changes = 0;
+
+  for(int v = start; v < end; v++) {
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+    HyperBallCounter counter = pBall->pCounters[v];
+    int bGrew = 0;
+
+    // Take the maximum of each register
+    for(int j = 0; j < degree; j++) {
+      int u = pAdjs[j];
+
+      if(!pBall->pChanged[u])
+        continue;
+
+      HyperBallCounter other = pBall->pCounters[u];
+      HyperBallCounter mask = (HyperBallCounter) (other > counter);
+      counter = (other & mask) | (counter & ~mask);
+    }
+
+    pBall->pNext[v] = counter;
+
+    // See how much it grew
+    double size = pBall->pSizes[v];
+
+    for(int j = 0; j < HYPERBALL_REGISTERS && !bGrew; j++)
+      bGrew = counter[j] != pBall->pCounters[v][j];
+
+    if(bGrew) {
+      double next = _HyperBall_estimate(&counter);
+
+      // The estimate can dip where it switches methods; the ball never shrinks
+      if(next > size) {
+        pBall->pHarmonic[v] += (next - size) / pJob->round;
+        size = next;
+      }
+
+      changes++;
+    }
+
+    pBall->pSizes[v] = size;
+    sum += size;
+  }
+
+  pJob->sums[thread] += sum;
+  pJob->changes[thread] += changes;
+}
+
+/**
+ * Runs rounds of unions until no ball grows, recording the neighborhood function along the way.
+ * The changed flags are only flipped between rounds, so every thread reads the last round's counters.
+ *
+ * @param   { Graph * }       pGraph  The graph to measure.
+ * @return  { HyperBall * }           The distance distribution and harmonic centralities.
+ */
+HyperBall *HyperBall_new(Graph *pGraph) {
+  double start = Timer_now();
+  int n = pGraph->nodeCount;
+  HyperBall *this = _HyperBall_init(_HyperBall_alloc(), n);
+  HyperBallJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+  pJob->pBall = this;
+
+  // Everyone starts with themselves
+  this->pNeighborhood[0] = n;
+
+  for(int t = 1; t <= HYPERBALL_MAX_DEPTH; t++) {
+    pJob->round = t;
+    memset(pJob->sums, 0, sizeof(pJob->sums));
+    memset(pJob->changes, 0, sizeof(pJob->changes));
+
+    Thread_parallelFor(n, HYPERBALL_CHUNK, _HyperBall_step, pJob);
+
+    // Sum up the threads
+    double sum = 0;
+    int changes = 0;
+
+    for(int i = 0; i < THREAD_MAX_COUNT; i++) {
+      sum += pJob->sums[i];
+      changes += pJob->changes[i];
+    }
+
+    // Nothing grew, so every ball is its whole component
+    if(!changes)
+      break;
+
+    // The next round reads what this one wrote
+    for(int v = 0; v < n; v++)
+      this->pChanged[v] = memcmp(&this->pNext[v], &this->pCounters[v], sizeof(HyperBallCounter)) != 0;
+
+    HyperBallCounter *pTemp = this->pCounters;
+    this->pCounters = this->pNext;
+    this->pNext = pTemp;
+
+    this->pNeighborhood[t] = sum;
+    this->depth = t;
+  }
+
+  free(pJob);
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+/**
+ * Gets the estimated number of ordered pairs of different nodes that can reach each other.
+ *
+ * @param   { HyperBall * }   this  The hyperball to read.
+ * @return  { double }              How many pairs are connected.
+ */
+double HyperBall_getPairs(HyperBall *this) {
+  return this->pNeighborhood[this->depth] - this->nodeCount;
+}
+
+/**
+ * Gets the share of connected pairs that are at most t hops apart.
+ *
+ * @param   { HyperBall * }   this  The hyperball to read.
+ * @param   { int }           t     The most hops.
+ * @return  { double }              The share of pairs within t hops.
+ */
+double HyperBall_getWithin(HyperBall *this, int t) {
+  double pairs = HyperBall_getPairs(this);
+
+  if(t > this->depth)
+    t = this->depth;
+
+  return pairs > 0 ? (this->pNeighborhood[t] - this->nodeCount) / pairs : 1;
+}
+
+/**
+ * Gets the average distance between two connected nodes.
+ * The number of pairs exactly t apart is N(t) - N(t - 1).
+ *
+ * @param   { HyperBall * }   this  The hyperball to read.
+ * @return  { double }              The average distance.
+ */
+double HyperBall_getAverageDistance(HyperBall *this) {
+  double pairs = HyperBall_getPairs(this);
+  double sum = 0;
+
+  for(int t = 1; t <= this->depth; t++)
+    sum += t * (this->pNeighborhood[t] - this->pNeighborhood[t - 1]);
+
+  return pairs > 0 ? sum / pairs : 0;
+}
+
+/**
+ * Gets the effective diameter: the distance within which the given share of connected pairs lie.
+ * It's interpolated between the hops on either side, as is usual.
+ *
+ * @param   { HyperBall * }   this      The hyperball to read.
+ * @param   { double }        quantile  The share of pairs to cover.
+ * @return  { double }                  The effective diameter.
+ */
+double HyperBall_getEffectiveDiameter(HyperBall *this, double quantile) {
+  int t = 1;
+
+  // Nobody can reach anybody
+  if(!this->depth)
+    return 0;
+
+  // Find the first hop that covers enough
+  while(t < this->depth && HyperBall_getWithin(this, t) < quantile)
+    t++;
+
+  // Then interpolate from the one before
+  double before = HyperBall_getWithin(this, t - 1);
+  double after = HyperBall_getWithin(this, t);
+
+  return after > before ? t - 1 + (quantile - before) / (after - before) : t;
+}
+
+#endif
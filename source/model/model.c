@@ -1,7 +1,7 @@
 /**
  * @ Author: Mo David
  * @ Create Time: 2024-07-19 10:37:54
- * @ Modified time: 2024-07-29 03:45:07
+ * @ Modified time: 2026-10-19 10:33:48
  * @ Description:
  * 
  * Handles converting the data into the model within memory.
@@ -13,6 +13,8 @@
 
 #include "../utils/bmp.c"
 #include "../utils/color.c"
+#include "../utils/timer.c"
+#include "../utils/topk.c"
 
 #include "./structs/hashmap.c"
 #include "./structs/stack.c"
@@ -21,8 +23,51 @@
 #include "../io/file.c"
 #include "./record.c"
 #include "./node.c"
+#include "./graph.c"
+
+#include "./structs/unionfind.c"
+#include "./structs/sparse.c"
+#include "./metrics/components.c"
+#include "./metrics/degrees.c"
+#include "./metrics/cores.c"
+#include "./metrics/cliques.c"
+#include "./metrics/triangles.c"
+#include "./metrics/centrality.c"
+#include "./metrics/betweenness.c"
+#include "./metrics/communities.c"
+#include "./metrics/eccentricity.c"
+#include "./metrics/hyperball.c"
+#include "./metrics/cohort.c"
+
+#include "./search/bfs.c"
+#include "./search/msbfs.c"
+#include "./search/query.c"
+#include "./search/batch.c"
+#include "./search/landmarks.c"
+#include "./search/cache.c"
+#include "./search/neighborhood.c"
+#include "./search/paths.c"
+#include "./search/personalrank.c"
+#include "./search/suggest.c"
+#include "./search/minhash.c"
 
 #define MODEL_EMPTY "no model"
+#define MODEL_STREAM "-"
+
+// How much memory cached shortest-path trees may take by default
+// MODEL_CACHE_MB overrides this at runtime, up to MODEL_CACHE_MAX_MB
+#define MODEL_CACHE_BUDGET (64L << 20)
+#define MODEL_CACHE_ENV "MODEL_CACHE_MB"
+#define MODEL_CACHE_MAX_MB (1L << 16)
+
+// How many of the top nodes the summaries list
+#define MODEL_TOP_COUNT 10
+
+// Files of ids restrict paths to those ids, or keep paths off them when prefixed with this
+// Matches NODE_ID_LENGTH so ids are never truncated differently from the model
+#define MODEL_MASK_NEGATE '!'
+#define MODEL_MASK_FORMAT "%64s"
+
 struct Model {
 
   // The path to the active dataset
@@ -35,8 +80,77 @@ struct Model {
   Node **nodePointers;
   int nodeCount;
 
+  // A compact copy of the adjacencies, built after loading
+  // The traversals run on this instead of the hashmaps
+  Graph *graph;
+
+  // The connected components of the graph
+  // The union-find only lives while the data is being loaded
+  Components *components;
+  UnionFind *unionFind;
+
+  // The degree statistics, kept up to date as the edges come in
+  Degrees *degrees;
+
+  // The core numbers, computed the first time they're asked for
+  Cores *cores;
+
+  // The clique search, with the nodes ordered the first time it's asked for
+  Cliques *cliques;
+
+  // The last communities found, so suggestions can say which ones stay within a community
+  Communities *communities;
+
+  // Recycles the state of connection queries
+  // Queries only read the model, so these can be used from several threads
+  QueryPool *queries;
+
+  // An optional distance index; connection queries use it when present
+  Landmarks *landmarks;
+
+  // The shortest-path trees of recently queried sources
+  TreeCache *trees;
+
+  // Recycles the state of k-hop neighborhood queries, so they can run from several threads too
+  NeighborhoodPool *neighborhoods;
+
+  // Recycles the state of shortest-path counting
+  PathsPool *paths;
+
+  // Recycles the state of personalized rank queries
+  PersonalRankPool *personalRanks;
+
+  // Recycles the state of friend suggestions
+  SuggestPool *suggestions;
+
+  // The friend-list signatures, made or read the first time they're asked for
+  MinHash *minhash;
+
 } Model;
 
+/**
+ * Decides whether a node passes some condition.
+ * It receives the shared arguments and the node to check.
+ */
+typedef int (*ModelPredicate)(void *pArgs, Node *pNode);
+
+/**
+ * The state shared by the threads compiling a predicate into a mask.
+ */
+typedef struct ModelMaskJob {
+  ModelPredicate pPredicate;
+  void *pArgs;
+  Bitset *pMask;
+} ModelMaskJob;
+
+/**
+ * Where the entries of a streamed product go, and how many went.
+ */
+typedef struct ModelProductJob {
+  FILE *pFile;
+  long count;
+} ModelProductJob;
+
 /**
  * Initializes the model we're going to use.
  * 
@@ -49,11 +163,58 @@ void Model_init() {
 
   // No nodes yet
   Model.nodeCount = 0;
+  Model.graph = NULL;
+  Model.queries = NULL;
+  Model.landmarks = NULL;
+  Model.trees = NULL;
+  Model.components = NULL;
+  Model.unionFind = NULL;
+  Model.degrees = NULL;
+  Model.cores = NULL;
+  Model.cliques = NULL;
+  Model.communities = NULL;
+  Model.neighborhoods = NULL;
+  Model.paths = NULL;
+  Model.personalRanks = NULL;
+  Model.suggestions = NULL;
+  Model.minhash = NULL;
   
   // Make sure its empty to begin with
   strcpy(Model.activeDataset, MODEL_EMPTY);
 }
 
+/**
+ * Opens a file to write results to, or takes the standard output when the path is MODEL_STREAM.
+ * 
+ * @param   { File * }  pOutput     The file to open.
+ * @param   { char * }  outputPath  The path to write to, or "-" for the standard output.
+ * @return  { int }                 Whether or not the output could be opened.
+*/
+int _Model_openOutput(File *pOutput, char *outputPath) {
+  File_init(pOutput, outputPath);
+
+  // Use the standard output if asked
+  if(!strcmp(outputPath, MODEL_STREAM)) {
+    pOutput->pFile = stdout;
+    return 1;
+  }
+
+  return File_open(pOutput, "w");
+}
+
+/**
+ * Closes an output opened with _Model_openOutput.
+ * The standard output is only flushed, since it's still needed afterwards.
+ * 
+ * @param   { File * }  pOutput   The output to close.
+*/
+void _Model_closeOutput(File *pOutput) {
+  if(pOutput->pFile != stdout)
+    File_close(pOutput);
+  else
+    fflush(stdout);
+}
+
 /**
  * Adds a new node to the model.
  * The function also returns a reference to the created node.
@@ -69,6 +230,12 @@ Node *Model_addNode(char *id) {
   // Create a new node
   Node *pNode = Node_new(id, pRecord);
 
+  // Its index is its position in the node pointer array
+  // It starts out in a component of its own
+  pNode->index = Model.nodeCount;
+  UnionFind_add(Model.unionFind);
+  Degrees_add(Model.degrees);
+
   // Save the node in the hashmap
   HashMap_put(Model.nodes, id, pNode);
 
@@ -102,84 +269,216 @@ void Model_addAdj(char *sourceId, char *targetId) {
     pTargetNode = Model_addNode(targetId);
 
   // Add the target node to the source node as an adjacency
-  Node_addAdj(pSourceNode, pTargetNode);
+  // Repeated edges don't count towards the degrees
+  if(Node_addAdj(pSourceNode, pTargetNode))
+    Degrees_link(Model.degrees, pSourceNode->index, pTargetNode->index);
+
+  // The two are now in the same component
+  UnionFind_union(Model.unionFind, pSourceNode->index, pTargetNode->index);
 }
 
 /**
- * "Generates" the connection between two nodes.
- * By this, we mean that it initializes the "prev" variables of the nodes to the represent a connection between the nodes.
- * Returns whether or not a connection between the two nodes was found.
+ * Checks whether a path only passes through allowed nodes.
+ * The two ends are always allowed.
+ * 
+ * @param   { int * }     pPath     The path to check.
+ * @param   { int }       length    The number of nodes in the path.
+ * @param   { Bitset * }  pAllowed  The nodes allowed on the path; NULL for all of them.
+ * @return  { int }                 Whether or not the path is allowed.
+*/
+int _Model_isPathAllowed(int *pPath, int length, Bitset *pAllowed) {
+
+  // Anything goes
+  if(pAllowed == NULL)
+    return 1;
+
+  // Check everything in between
+  for(int i = 1; i < length - 1; i++)
+    if(!Bitset_get(pAllowed, pPath[i]))
+      return 0;
+
+  return 1;
+}
+
+/**
+ * Evaluates a predicate on the nodes within the given range.
+ * Ranges are multiples of the word size, so threads never write to the same word.
  * 
- * @param   { Node * }  pSourceNode   The source node of the connection.
- * @param   { Node * }  pTargetNode   The target node of the connection.
- * @return  { int }                   Whether or not a connection could be found.
+ * @param   { void * }  pArgs   The shared ModelMaskJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to check.
+ * @param   { int }     end     One past the last node to check.
 */
-int Model_generateConnection(Node *pSourceNode, Node *pTargetNode) {
+void _Model_compileMask(void *pArgs, int thread, int start, int end) {
+  ModelMaskJob *pJob = pArgs;
 
-  // We proceed to traverse the dataset if both nodes were fine
-  Queue *nodeQueue = Queue_new();
-  HashMap *visited = HashMap_new();
+  // Check each node
+  for(int i = start; i < end; i++)
+    if(pJob->pPredicate(pJob->pArgs, Model.nodePointers[i]))
+      Bitset_set(pJob->pMask, i);
+}
 
-  // A constant we use to know something has been visited
-  char *VISITED = "VISITED";
-  int success = 0;
+/**
+ * Compiles a predicate into a mask over the node indices.
+ * The predicate is run once per node, so searches only ever test a bit.
+ * 
+ * @param   { ModelPredicate }  pPredicate  The condition to check.
+ * @param   { void * }          pArgs       The arguments passed to the predicate.
+ * @return  { Bitset * }                    The nodes that passed.
+*/
+Bitset *Model_compileMask(ModelPredicate pPredicate, void *pArgs) {
 
-  // Push the source node unto the queue
-  Queue_add(nodeQueue, pSourceNode);
+  // Fill the mask in parallel
+  ModelMaskJob job = { pPredicate, pArgs, Bitset_new(Model.nodeCount) };
+  Thread_parallelFor(Model.nodeCount, BFS_CHUNK, _Model_compileMask, &job);
 
-  // Clear the prev of the node in case it was set in a previous traversal
-  Node_setPrev(pSourceNode, NULL);
+  return job.pMask;
+}
 
-  // While the queue isn't empty
-  while(Queue_getCount(nodeQueue) && !success) {
+/**
+ * Checks whether a node is (or isn't) in a set of ids.
+ * 
+ * @param   { void * }  pArgs   The set of ids, and whether to negate the answer.
+ * @param   { Node * }  pNode   The node to check.
+ * @return  { int }             Whether or not the node passed.
+*/
+int _Model_isListed(void *pArgs, Node *pNode) {
+  HashMap *pIds = ((void **) pArgs)[0];
+  int bShouldAvoid = *(int *) ((void **) pArgs)[1];
 
-    // Grab the head and its details
-    Node *pHead = Queue_remove(nodeQueue);
-    HashMap *adjNodes = pHead->adjNodes;
-    
-    // Grab the keys we need to iterate over
-    char **nextNodeKeys = adjNodes->keys;
+  return (HashMap_get(pIds, pNode->id) != NULL) != bShouldAvoid;
+}
 
-    // Check if we've reached the destination
-    if(pHead == pTargetNode) {
-      success = 1;
-      break;
-    }
+/**
+ * Reads a file of ids and compiles it into a mask.
+ * Starting the path with MODEL_MASK_NEGATE allows every node except those listed.
+ * 
+ * @param   { char * }    filepath  The path to the file of ids, optionally prefixed.
+ * @return  { Bitset * }            The allowed nodes, or NULL if the file couldn't be read.
+*/
+Bitset *Model_readMask(char *filepath) {
+
+  // Whether the ids are to be avoided instead
+  int bShouldAvoid = filepath[0] == MODEL_MASK_NEGATE;
+
+  // Try to open the file
+  File file;
+  File_init(&file, filepath + bShouldAvoid);
+
+  if(!File_open(&file, "r"))
+    return NULL;
+
+  // Collect the ids
+  HashMap *pIds = HashMap_new();
+  char id[NODE_ID_LENGTH + 1];
+
+  while(File_read(&file, MODEL_MASK_FORMAT, id) == 1)
+    HashMap_put(pIds, id, pIds);
+
+  File_close(&file);
+
+  // Then compile them
+  void *pArgs[2] = { pIds, &bShouldAvoid };
+  Bitset *pMask = Model_compileMask(_Model_isListed, pArgs);
+
+  // The entries point to the set itself, so there's no data to free
+  HashMap_kill(pIds, 0);
+
+  return pMask;
+}
+
+/**
+ * "Generates" the connection between two nodes.
+ * The path found is stored in the given query; the model itself is left untouched.
+ * Nodes in different components are turned away right away.
+ * Sources (or targets) that were queried recently have their shortest-path tree cached, and the path is read off that.
+ * Otherwise, if a distance index was built, the path is read off the index; if not, a bidirectional search finds it.
+ * A source that keeps missing gets its own tree built and cached, so later queries from it are hits.
+ * When limits are given, no tree is built; a bounded search is run instead, and the query's status says why it stopped.
+ * Returns whether or not a connection between the two nodes was found.
+ * 
+ * @param   { Query * }     pQuery        The query to store the path in.
+ * @param   { Node * }      pSourceNode   The source node of the connection.
+ * @param   { Node * }      pTargetNode   The target node of the connection.
+ * @param   { BFSLimits * } pLimits       The bounds of the search; NULL for none.
+ * @return  { int }                       Whether or not a connection could be found.
+*/
+int Model_generateConnection(Query *pQuery, Node *pSourceNode, Node *pTargetNode, BFSLimits *pLimits) {
+
+  // The indices of the two
+  int source = pSourceNode->index;
+  int target = pTargetNode->index;
 
-    // For each of the adjacent nodes
-    for(int i = 0; i < adjNodes->count; i++) {
+  // Nothing was searched unless we get to the search
+  pQuery->stats = (BFSStats) { 0 };
+  pQuery->stats.status = BFS_STATUS_NONE;
 
-      // Grab the key
-      char *key = nextNodeKeys[i];
+  // Different components can never be connected
+  if(!Components_isConnectable(Model.components, source, target)) {
+    pQuery->pathLength = 0;
+    return 0;
+  }
 
-      // Next node
-      Node *pNextNode = HashMap_get(adjNodes, key);
+  // Try the cached trees first; a repeated source may get one built if there's no index and no limits
+  pQuery->pathLength = TreeCache_getPath(Model.trees, source, target, Model.landmarks == NULL && pLimits == NULL, pQuery->pPath);
 
-      // Check if visited
-      if(HashMap_get(visited, pNextNode->id) == VISITED)
-        continue;
+  // Read the path off the distance index instead
+  if(pQuery->pathLength < 0 && Model.landmarks != NULL)
+    pQuery->pathLength = Landmarks_getPath(Model.landmarks, Model.graph, source, target, pQuery->pPath);
 
-      // Add the next node to visited
-      HashMap_put(visited, pNextNode->id, VISITED);
+  // Neither had it, so search within the limits, if any
+  if(pQuery->pathLength < 0)
+    return Query_connectWithin(pQuery, source, target, pLimits) > 0;
 
-      // Set the prev of the node
-      Node_setPrev(pNextNode, pHead);
+  // A known path is only good if it stays on the allowed nodes
+  // Any allowed path is at least as long, so one that does is still the shortest
+  if(pQuery->pathLength > 0 && pLimits != NULL && !_Model_isPathAllowed(pQuery->pPath, pQuery->pathLength, pLimits->pAllowed))
+    return Query_connectWithin(pQuery, source, target, pLimits) > 0;
 
-      // Append the node to the queue
-      Queue_add(nodeQueue, pNextNode);
+  // A known path can still be too long; it's the shortest, so nothing within the limit exists
+  // No search ran, so only its length is reported
+  if(pQuery->pathLength > 0) {
+    pQuery->stats.status = BFS_STATUS_FOUND;
+    pQuery->stats.depth = pQuery->pathLength - 1;
+
+    if(pLimits != NULL && pLimits->maxHops != BFS_NO_LIMIT && pQuery->pathLength - 1 > pLimits->maxHops) {
+      pQuery->stats.status = BFS_STATUS_LONGER;
+      pQuery->pathLength = 0;
     }
+  }
+
+  return pQuery->pathLength > 0;
+}
+
+/**
+ * Gets how many bytes the tree cache may take, from MODEL_CACHE_MB if it's set.
+ * Values that aren't a whole number of megabytes fall back to the default, and huge ones are clamped.
+ * 
+ * @return  { long }  The budget of the tree cache, in bytes.
+*/
+long Model_getCacheBudget() {
+  char *cacheEnv = getenv(MODEL_CACHE_ENV);
+  char *pEnd = NULL;
+
+  // Not set
+  if(cacheEnv == NULL)
+    return MODEL_CACHE_BUDGET;
+
+  long megabytes = strtol(cacheEnv, &pEnd, 10);
 
-    // Add the head to visited
-    HashMap_put(visited, pHead->id, VISITED);
+  // Not a number, or a negative one
+  if(pEnd == cacheEnv || *pEnd != 0 || megabytes < 0) {
+    fprintf(stderr, "\tIgnoring %s=%s; expected a number of megabytes.\n", MODEL_CACHE_ENV, cacheEnv);
+    return MODEL_CACHE_BUDGET;
   }
 
-  // Garbage collection
-  // We're only deleting the data structures, so the data itself should be safe
-  HashMap_kill(visited, 0);
-  Queue_kill(nodeQueue, 0);
+  // Too big to mean it
+  if(megabytes > MODEL_CACHE_MAX_MB) {
+    fprintf(stderr, "\tClamping %s=%s to %ld.\n", MODEL_CACHE_ENV, cacheEnv, MODEL_CACHE_MAX_MB);
+    megabytes = MODEL_CACHE_MAX_MB;
+  }
 
-  // Return whether or not it succeeded
-  return success;
+  return megabytes << 20;
 }
 
 /**
@@ -246,141 +545,1521 @@ void Model_printFriendList(char *id, int cols) {
 }
 
 /**
- * Displays whether or not there's a connection between the two nodes.
- * Prints the appropriate message when none exists, or when one of the nodes are invalid.
+ * Suggests new friends for a node, ranked by the friends they share.
+ * If communities were found, suggestions in the same community as the node are marked with a star.
  * 
- * @param   { char * }  sourceId  The id of the source node.
- * @param   { char * }  targetId  The id of the target node.
- * @param   { int }     cols      The number of cols for the formatting.
+ * @param   { char * }          id      The id of the node to inspect.
+ * @param   { SuggestMetric }   metric  How to score the people suggested.
+ * @param   { int }             k       How many people to suggest.
 */
-void Model_printConnection(char *sourceId, char *targetId, int cols) {
-  
-  // Grab the nodes we want
-  Node *pSourceNode = HashMap_get(Model.nodes, sourceId);
-  Node *pTargetNode = HashMap_get(Model.nodes, targetId);
+void Model_printSuggestions(char *id, SuggestMetric metric, int k) {
 
-  // If either id was invalid
-  if(pSourceNode == NULL || pTargetNode == NULL) {
-    printf("\tAt least one of the ids was invalid.\n");
+  // Grab the node we want
+  Node *pNode = HashMap_get(Model.nodes, id);
+
+  // The id was invalid
+  if(pNode == NULL) {
+    printf("\tInvalid id.\n");
     return;
   }
 
-  // Look for a connection
-  int success = Model_generateConnection(pSourceNode, pTargetNode);   
+  // Score everyone two hops out
+  Suggest *pSuggest = SuggestPool_acquire(Model.suggestions);
+  double start = Timer_now();
+  int count = Suggest_run(pSuggest, pNode->index, metric, k);
+  double seconds = Timer_now() - start;
 
-  // No path could be found
-  if(!success) {
-    printf("\tA path could not be found.\n");
-    return;
+  printf("\tTop %d suggestions for %s:\n", count, id);
+
+  // Whose community to compare against, if any split was made
+  int *pLabels = Model.communities != NULL ? Model.communities->pLabels : NULL;
+  int sameCount = 0;
+
+  for(int i = 0; i < count; i++) {
+    int v = pSuggest->pTop[i];
+    int bSame = pLabels != NULL && pLabels[v] == pLabels[pNode->index];
+
+    sameCount += bSame;
+    printf("\t  %d. %s: %.6g%s\n", i + 1, Model.nodePointers[v]->id, pSuggest->pTopScores[i], bSame ? " *" : "");
   }
 
-  // Create a new stack so we can reverse the order
-  Stack *pPathStack = Stack_new();
-  Node *pNode = pTargetNode; 
+  // How many of them stay within the community
+  if(pLabels != NULL)
+    printf("\n\t%d of %d are in community %d with %s.\n", sameCount, count, pLabels[pNode->index], id);
+
+  // The work it took
+  printf("\n\t%d people considered over %ld adjacencies in %.3f ms.\n", 
+    pSuggest->touchedCount, pSuggest->edgeCount, seconds * 1000);
+
+  SuggestPool_release(Model.suggestions, pSuggest);
+}
+
+/**
+ * Suggests new friends for every node at once, writing "id suggestion1 suggestion2 ..." lines.
+ * 
+ * @param   { SuggestMetric }   metric      How to score the people suggested.
+ * @param   { int }             k           How many people to suggest to each node.
+ * @param   { char * }          outputPath  Where to write the suggestions, or "-" for the standard output.
+ * @return  { int }                         Whether or not the file could be opened.
+*/
+int Model_writeSuggestions(SuggestMetric metric, int k, char *outputPath) {
+
+  // Open the output
+  File output;
+
+  if(!_Model_openOutput(&output, outputPath))
+    return 0;
+
+  // Suggest for everyone across threads
+  int *pResults = malloc(((long) Model.nodeCount * k + 1) * sizeof(int));
+  int *pCounts = malloc((Model.nodeCount + 1) * sizeof(int));
+  double start = Timer_now();
+  long total = Suggest_runAll(Model.graph, metric, k, pResults, pCounts);
+  double seconds = Timer_now() - start;
 
-  // Put the nodes unto the stack
-  while(pNode != NULL) {
+  // Then write them out in order
+  for(int v = 0; v < Model.nodeCount; v++) {
+    fprintf(output.pFile, "%s", Model.nodePointers[v]->id);
 
-    // Push the current node
-    Stack_push(pPathStack, pNode);
+    for(int i = 0; i < pCounts[v]; i++)
+      fprintf(output.pFile, " %s", Model.nodePointers[pResults[(long) v * k + i]]->id);
 
-    // Go to adjacent node
-    pNode = pNode->pPrevNode;
+    fprintf(output.pFile, "\n");
   }
 
-  // Print that a path was found, reassign pNode to stack top
-  printf("\tThe following path was found.\n\n");
-  pNode = Stack_pop(pPathStack);
+  _Model_closeOutput(&output);
 
-  // Very unconverntional for loop
-  for(int i = 0; pNode != NULL; i++) {
-    
-    // Column formatting
-    if(i % cols == 0)
-      printf("\n\t");
+  printf("\n\t%ld suggestions for %d nodes in %.3f ms (%.4f ms per node, %d threads).\n", 
+    total, Model.nodeCount, seconds * 1000, Model.nodeCount ? seconds * 1000 / Model.nodeCount : 0, Thread_getCount());
 
-    // Print the ids
-    printf("=> %s\t", pNode->id);
+  // Garbage collection
+  free(pResults);
+  free(pCounts);
+
+  return 1;
+}
+
+/**
+ * Gets where the friend-list signatures of the active dataset are saved.
+ * 
+ * @param   { char * }  out   Where to write the path.
+*/
+void Model_getMinHashPath(char *out) {
+  strcpy(out, Model.activeDataset);
+  strcat(out, MINHASH_EXTENSION);
+}
+
+/**
+ * Gets the friend-list signatures, reading them from beside the dataset the first time.
+ * If they were never saved, they're made in memory; Model_saveMinHash keeps them for next time.
+ * 
+ * @return  { MinHash * }   The signatures and their index.
+*/
+MinHash *Model_getMinHash() {
+
+  // Already there
+  if(Model.minhash != NULL)
+    return Model.minhash;
 
-    // Go to next in chain
-    pNode = Stack_pop(pPathStack);
+  // Try the saved ones first
+  char filepath[256 + sizeof(MINHASH_EXTENSION)];
+  Model_getMinHashPath(filepath);
+  Model.minhash = MinHash_load(Model.graph, filepath);
+
+  if(Model.minhash != NULL) {
+    printf("\tRead the signatures from %s in %.3f ms.\n\n", filepath, Model.minhash->seconds * 1000);
+    return Model.minhash;
   }
 
-  // Cleaner printing
-  printf("\n");
+  // Then make them
+  Model.minhash = MinHash_new(Model.graph);
+  printf("\tSigned %d nodes in %.3f ms.\n\n", Model.nodeCount, Model.minhash->seconds * 1000);
 
-  // Free the memory
-  // Don't free the data cuz we're editing live nodes
-  Stack_kill(pPathStack, 0);
+  return Model.minhash;
 }
 
 /**
- * Clears the contents of the model.
- * Makes sure to perform proper garbage collection.
+ * Saves the friend-list signatures beside the dataset, so they're read instead of made next time.
+ * Does nothing if they were never made, or already match a saved file.
 */
-void Model_clearData() {
+void Model_saveMinHash() {
 
-  // If it's already cleared or smth
-  if(!strcmp(Model.activeDataset, MODEL_EMPTY))
+  // Nothing to save
+  if(Model.minhash == NULL || Model.minhash->bSaved)
     return;
-  
-  // Kill the hashmap first
-  // We don't delete the data inside because we clean that up ourselves
-  HashMap_kill(Model.nodes, 0);
 
-  // We kill the associated data with each of the nodes
-  while(Model.nodeCount--)
-    Node_kill(Model.nodePointers[Model.nodeCount], 1);
+  // Where they go
+  char filepath[256 + sizeof(MINHASH_EXTENSION)];
+  Model_getMinHashPath(filepath);
 
-  // Free the nodePointers
-  free(Model.nodePointers);
+  if(MinHash_save(Model.minhash, filepath))
+    printf("\tSaved the signatures to %s.\n", filepath);
+  else
+    printf("\tCould not save the signatures to %s.\n", filepath);
+}
 
-  // Create a new hashmap
-  // Reset node count (although that's a bit redudant)
-  Model.nodes = HashMap_new();
-  Model.nodeCount = 0;
+/**
+ * Lists the people whose friend lists are most like that of a node.
+ * Only those sharing a bucket with it are compared, and their similarity is exact.
+ * 
+ * @param   { char * }  id  The id of the node to inspect.
+ * @param   { int }     k   How many people to list.
+*/
+void Model_printSimilar(char *id, int k) {
 
-  // Empty the activeDataset string
-  strcpy(Model.activeDataset, MODEL_EMPTY);
+  // Grab the node we want
+  Node *pNode = HashMap_get(Model.nodes, id);
+
+  // The id was invalid
+  if(pNode == NULL) {
+    printf("\tInvalid id.\n");
+    return;
+  }
+
+  // Look in its buckets
+  MinHash *pMinHash = Model_getMinHash();
+  int *pTop = malloc((k > 0 ? k : 1) * sizeof(int));
+  double *pScores = malloc((k > 0 ? k : 1) * sizeof(double));
+  double start = Timer_now();
+  int count = MinHash_getSimilar(pMinHash, Model.graph, pNode->index, k, pTop, pScores);
+  double seconds = Timer_now() - start;
+
+  printf("\tTop %d by similar friends to %s:\n", count, id);
+
+  for(int i = 0; i < count; i++)
+    printf("\t  %d. %s: %.4f\n", i + 1, Model.nodePointers[pTop[i]]->id, pScores[i]);
+
+  // The work it took
+  printf("\n\t%d of %d people compared in %.3f ms.\n", pMinHash->candidateCount, Model.nodeCount - 1, seconds * 1000);
+
+  // Garbage collection
+  free(pTop);
+  free(pScores);
 }
 
 /**
- * Reads the file and converts its data into our model.
+ * Writes every pair of people with friend lists at least as similar as the threshold, as "id1 id2 similarity" lines.
  * 
- * @param   { char * }  filepath  The path to the file to read.
- * @return  { int }               Whether or not the data was loaded.
+ * @param   { double }  threshold   How similar a pair has to be.
+ * @param   { char * }  outputPath  Where to write the pairs, or "-" for the standard output.
+ * @return  { int }                 Whether or not the file could be opened.
 */
-int Model_loadData(char *filepath) {
-  
-  // Create a file to the dataset
-  File file;
-  File_init(&file, filepath);
-  
-  // Try to open the file
-  if(!File_open(&file, "r"))
+int Model_writeSimilarPairs(double threshold, char *outputPath) {
+
+  // Open the output
+  File output;
+
+  if(!_Model_openOutput(&output, outputPath))
     return 0;
 
-  // Temporary variables for holding read data
-  char sourceId[32];
-  char targetId[32];
+  // Pair up the buckets
+  MinHash *pMinHash = Model_getMinHash();
+  MinHashPair *pPairs;
+  long candidateCount = 0;
+  double start = Timer_now();
+  long count = MinHash_getPairs(pMinHash, Model.graph, threshold, &pPairs, &candidateCount);
+  double seconds = Timer_now() - start;
 
-  // Metadata
-  int nodeCount;
-  int edgeCount;
+  for(long i = 0; i < count; i++)
+    fprintf(output.pFile, "%s %s %.4f\n", 
+      Model.nodePointers[pPairs[i].a]->id, Model.nodePointers[pPairs[i].b]->id, pPairs[i].jaccard);
 
-  // The first line only contains metadata
-  File_read(&file, "%d %d", &nodeCount, &edgeCount);
+  _Model_closeOutput(&output);
 
-  // Init the node pointer array
-  Model.nodePointers = calloc(nodeCount, sizeof(Node *));
+  // The work it took
+  printf("\n\t%ld pairs found after comparing %ld of %.0f in %.3f ms.\n", 
+    count, candidateCount, (double) Model.nodeCount * (Model.nodeCount - 1) / 2, seconds * 1000);
 
-  // Read the file contents
-  // Also generates the model in memory
-  while(File_read(&file, "%s %s", &sourceId, &targetId))
-    Model_addAdj(sourceId, targetId);
+  free(pPairs);
 
-  // Set the active dataset
-  strcpy(Model.activeDataset, filepath);
+  return 1;
+}
+
+/**
+ * Writes an entry of a path-count product as "id1 id2 count".
+ * 
+ * @param   { void * }  pArgs   The ModelProductJob to write to.
+ * @param   { int }     row     The node the paths start from.
+ * @param   { int }     column  The node the paths end at.
+ * @param   { double }  value   How many paths there are.
+*/
+void _Model_writeProductEntry(void *pArgs, int row, int column, double value) {
+  ModelProductJob *pJob = pArgs;
+
+  fprintf(pJob->pFile, "%s %s %.0f\n", Model.nodePointers[row]->id, Model.nodePointers[column]->id, value);
+  pJob->count++;
+}
+
+/**
+ * Counts the walks of a few hops between every pair of people, as the entries of a power of the adjacency matrix.
+ * Two hops counts mutual friends; three hops multiplies through the full two-hop matrix first.
+ * Only the counts that pass the filter are written, as "id1 id2 count" lines in order of the first id.
+ * 
+ * @param   { int }     hops        How long the walks are, either 2 or 3.
+ * @param   { double }  threshold   The smallest count to write, or SPARSE_NO_LIMIT for any.
+ * @param   { int }     k           The most counts to write per person, largest first, or SPARSE_NO_LIMIT for all.
+ * @param   { int }     bDiagonal   Whether to write the walks that come back to where they started.
+ * @param   { char * }  outputPath  Where to write the counts, or "-" for the standard output.
+ * @return  { int }                 Whether or not the file could be opened.
+*/
+int Model_writeProduct(int hops, double threshold, int k, int bDiagonal, char *outputPath) {
+
+  // Open the output
+  File output;
+
+  if(!_Model_openOutput(&output, outputPath))
+    return 0;
+
+  SparseFilter filter = { threshold, k, bDiagonal };
+  SparseFilter none = { SPARSE_NO_LIMIT, SPARSE_NO_LIMIT, 1 };
+  ModelProductJob job = { output.pFile, 0 };
+  Sparse *pAdjacency = Sparse_fromGraph(Model.graph);
+  Sparse *pSquare = NULL;
+  long productCount = 0;
+  double start = Timer_now();
+
+  // Three hops needs the whole square first, since any of it can be reached
+  if(hops == 3) {
+    pSquare = Sparse_multiply(pAdjacency, pAdjacency, &none, &productCount);
+    productCount += Sparse_stream(pAdjacency, pSquare, &filter, _Model_writeProductEntry, &job);
+  } else {
+    productCount = Sparse_stream(pAdjacency, pAdjacency, &filter, _Model_writeProductEntry, &job);
+  }
+
+  double seconds = Timer_now() - start;
+
+  _Model_closeOutput(&output);
+
+  // The work it took
+  printf("\n\t%ld counts kept for %d nodes after %ld multiply-adds in %.3f ms (%d threads).\n", 
+    job.count, Model.nodeCount, productCount, seconds * 1000, Thread_getCount());
+
+  if(pSquare != NULL)
+    printf("\t%ld nonzero counts at two hops.\n", pSquare->entryCount);
+
+  // Garbage collection
+  Sparse_kill(pAdjacency);
+
+  if(pSquare != NULL)
+    Sparse_kill(pSquare);
+
+  return 1;
+}
+
+/**
+ * Ranks everyone by how relevant they are to a node, using the PageRank personalized to that node.
+ * Only the neighborhood around the node is explored; a smaller epsilon explores further and ranks more precisely.
+ * Direct friends are marked with a star.
+ * 
+ * @param   { char * }  id        The id of the node to inspect.
+ * @param   { double }  epsilon   How much leftover score per neighbor is small enough to ignore.
+ * @param   { int }     k         How many of the top nodes to list.
+*/
+void Model_printRelevant(char *id, double epsilon, int k) {
+
+  // Grab the node we want
+  Node *pNode = HashMap_get(Model.nodes, id);
+
+  // The id was invalid
+  if(pNode == NULL) {
+    printf("\tInvalid id.\n");
+    return;
+  }
+
+  // Push the scores out from the node
+  PersonalRank *pPersonalRank = PersonalRankPool_acquire(Model.personalRanks);
+  double start = Timer_now();
+  int count = PersonalRank_run(pPersonalRank, pNode->index, PERSONALRANK_ALPHA, epsilon);
+  double seconds = Timer_now() - start;
+
+  // The best nodes
+  int *pTop = malloc((k > 0 ? k : 1) * sizeof(int));
+  int topCount = PersonalRank_getTop(pPersonalRank, k, pTop);
+
+  printf("\tTop %d by relevance to %s:\n", topCount, id);
+
+  for(int i = 0; i < topCount; i++) {
+    Node *pOther = Model.nodePointers[pTop[i]];
+
+    printf("\t  %d. %s%s: %.6g\n", i + 1, pOther->id, 
+      HashMap_get(pNode->adjNodes, pOther->id) != NULL ? " *" : "", pPersonalRank->pEstimates[pTop[i]]);
+  }
+
+  // The work it took
+  printf("\n\t%d nodes touched, %ld pushes over %ld adjacencies in %.3f ms.\n", 
+    count, pPersonalRank->pushCount, pPersonalRank->edgeCount, seconds * 1000);
+
+  // Garbage collection
+  free(pTop);
+  PersonalRankPool_release(Model.personalRanks, pPersonalRank);
+}
+
+/**
+ * Prints a node reached by a neighborhood query.
+ * The arguments hold the number of columns, the last hop printed, and how many were printed on it.
+ * 
+ * @param   { void * }  pArgs   The printing state.
+ * @param   { int }     node    The node reached.
+ * @param   { int }     hops    How many hops away it is.
+*/
+void _Model_printNeighbor(void *pArgs, int node, int hops) {
+  int *pState = pArgs;
+
+  // A new hop starts
+  if(pState[1] != hops) {
+    printf("\n\n\tHop %d:", hops);
+    pState[1] = hops;
+    pState[2] = 0;
+  }
+
+  // Column formatting
+  if(pState[2]++ % pState[0] == 0)
+    printf("\n\t");
+
+  // Data print
+  printf("%s,\t", Model.nodePointers[node]->id);
+}
+
+/**
+ * Lists everyone within a number of hops of a node, closest first.
+ * The nodes are printed as they are found, followed by how many were found at each hop.
+ * 
+ * @param   { char * }  id      The id of the node to inspect.
+ * @param   { int }     hops    How many hops out to go.
+ * @param   { int }     limit   The most nodes to list, or NEIGHBORHOOD_UNLIMITED.
+ * @param   { int }     cols    The number of cols for formatting data.
+*/
+void Model_printNeighborhood(char *id, int hops, int limit, int cols) {
+
+  // Grab the node we want
+  Node *pNode = HashMap_get(Model.nodes, id);
+
+  // The id was invalid
+  if(pNode == NULL) {
+    printf("\tInvalid id.\n");
+    return;
+  }
+
+  // Stream the nodes out as they're found
+  int state[3] = { cols, 0, 0 };
+  Neighborhood *pNeighborhood = NeighborhoodPool_acquire(Model.neighborhoods);
+  double start = Timer_now();
+  int count = Neighborhood_run(pNeighborhood, pNode->index, hops, limit, _Model_printNeighbor, state);
+  double seconds = Timer_now() - start;
+
+  // The summary
+  printf("\n\n\tWithin %d hops (%d)%s:\n", hops, count, pNeighborhood->bTruncated ? ", cut off at the limit" : "");
+
+  for(int i = 1; i < pNeighborhood->levelCount; i++)
+    printf("\t  %d hops: %d\n", i, pNeighborhood->pLevelCounts[i]);
+
+  printf("\t%ld adjacencies scanned in %.3f ms.\n", pNeighborhood->edgeCount, seconds * 1000);
+
+  NeighborhoodPool_release(Model.neighborhoods, pNeighborhood);
+}
+
+/**
+ * Displays whether or not there's a connection between the two nodes, without going past the given limits.
+ * When a limit stops the search, says which one and how far the search got.
+ * 
+ * @param   { char * }      sourceId  The id of the source node.
+ * @param   { char * }      targetId  The id of the target node.
+ * @param   { BFSLimits * } pLimits   The bounds of the search; NULL for none.
+ * @param   { int }         cols      The number of cols for the formatting.
+*/
+void Model_printConnectionWithin(char *sourceId, char *targetId, BFSLimits *pLimits, int cols) {
+  
+  // Grab the nodes we want
+  Node *pSourceNode = HashMap_get(Model.nodes, sourceId);
+  Node *pTargetNode = HashMap_get(Model.nodes, targetId);
+
+  // If either id was invalid
+  if(pSourceNode == NULL || pTargetNode == NULL) {
+    printf("\tAt least one of the ids was invalid.\n");
+    return;
+  }
+
+  // Grab some query state and look for a connection
+  Query *pQuery = QueryPool_acquire(Model.queries);
+  int success = Model_generateConnection(pQuery, pSourceNode, pTargetNode, pLimits);   
+  BFSStats *pStats = &pQuery->stats;
+
+  // No path could be found
+  if(!success) {
+
+    // Say why
+    switch(pStats->status) {
+      case BFS_STATUS_HOPS: printf("\tNo path within %d hops.\n", pLimits->maxHops); break;
+      case BFS_STATUS_LONGER: printf("\tThe shortest path is %d hops (limit %d).\n", pStats->depth, pLimits->maxHops); break;
+      case BFS_STATUS_BUDGET: printf("\tThe search budget was exhausted.\n"); break;
+      default: printf("\tA path could not be found.\n"); break;
+    }
+
+    // Show how far it got when it was cut short
+    if(pStats->status == BFS_STATUS_HOPS || pStats->status == BFS_STATUS_BUDGET)
+      printf("\tNo path is %d hops or shorter; %ld adjacencies scanned and %d nodes reached in %.3f ms.\n", 
+        pStats->depth, pStats->edgeCount, pStats->nodeCount, pStats->seconds * 1000);
+
+    QueryPool_release(Model.queries, pQuery);
+    return;
+  }
+
+  // Print that a path was found
+  printf("\tThe following path was found.\n\n");
+
+  // The path is already ordered from source to target
+  for(int i = 0; i < pQuery->pathLength; i++) {
+    
+    // Column formatting
+    if(i % cols == 0)
+      printf("\n\t");
+
+    // Print the ids
+    printf("=> %s\t", Model.nodePointers[pQuery->pPath[i]]->id);
+  }
+
+  // Cleaner printing
+  printf("\n");
+
+  // Give the query state back
+  QueryPool_release(Model.queries, pQuery);
+}
+
+/**
+ * Displays whether or not there's a connection between the two nodes.
+ * Prints the appropriate message when none exists, or when one of the nodes are invalid.
+ * 
+ * @param   { char * }  sourceId  The id of the source node.
+ * @param   { char * }  targetId  The id of the target node.
+ * @param   { int }     cols      The number of cols for the formatting.
+*/
+void Model_printConnection(char *sourceId, char *targetId, int cols) {
+  Model_printConnectionWithin(sourceId, targetId, NULL, cols);
+}
+
+/**
+ * Writes an edge of the shortest-path graph as a line of two ids.
+ * 
+ * @param   { void * }  pArgs   The file to write to.
+ * @param   { int }     from    The end closer to the source.
+ * @param   { int }     to      The end closer to the target.
+*/
+void _Model_writePathEdge(void *pArgs, int from, int to) {
+  fprintf(pArgs, "%s %s\n", Model.nodePointers[from]->id, Model.nodePointers[to]->id);
+}
+
+/**
+ * Counts the shortest paths between two nodes and lists who they pass through.
+ * Intermediaries are listed by how far they are from the source, with the share of paths through each.
+ * Also prints a few paths picked uniformly at random, and can write the shortest-path graph to a file.
+ * 
+ * @param   { char * }  sourceId    The id of the source node.
+ * @param   { char * }  targetId    The id of the target node.
+ * @param   { int }     samples     How many paths to pick.
+ * @param   { char * }  outputPath  Where to write the shortest-path graph, "-" for the standard output, or NULL to skip it.
+ * @param   { int }     cols        The number of cols for the formatting.
+*/
+void Model_printPathCount(char *sourceId, char *targetId, int samples, char *outputPath, int cols) {
+
+  // Grab the nodes we want
+  Node *pSourceNode = HashMap_get(Model.nodes, sourceId);
+  Node *pTargetNode = HashMap_get(Model.nodes, targetId);
+
+  // If either id was invalid
+  if(pSourceNode == NULL || pTargetNode == NULL) {
+    printf("\tAt least one of the ids was invalid.\n");
+    return;
+  }
+
+  // Count them
+  Paths *pPaths = PathsPool_acquire(Model.paths);
+  double start = Timer_now();
+  double count = Paths_count(pPaths, pSourceNode->index, pTargetNode->index);
+  double seconds = Timer_now() - start;
+
+  // No path could be found
+  if(count == 0) {
+    printf("\tA path could not be found.\n");
+    PathsPool_release(Model.paths, pPaths);
+    return;
+  }
+
+  // The overall numbers
+  printf("\tShortest paths: %.0f, each %d hops long (%.3f ms).\n", count, pPaths->distance, seconds * 1000);
+  printf("\tNodes on them: %d\n", pPaths->nodeCount);
+
+  // The intermediaries; the node list runs from the target back, so each level is a contiguous run
+  for(int i = pPaths->nodeCount - 2, printed = 0; i > 0; i--) {
+    int u = pPaths->pNodes[i];
+
+    // A new level starts
+    if(pPaths->pDistances[u] != pPaths->pDistances[pPaths->pNodes[i + 1]]) {
+      printf("\n\n\tHop %d:", pPaths->pDistances[u]);
+      printed = 0;
+    }
+
+    // Column formatting
+    if(printed++ % cols == 0)
+      printf("\n\t");
+
+    // The id and the share of paths through it
+    printf("%s (%.1f%%),\t", Model.nodePointers[u]->id, 100 * Paths_getFraction(pPaths, u));
+  }
+
+  // A few random paths
+  int *pPath = malloc((pPaths->distance + 1) * sizeof(int));
+
+  if(samples > 0)
+    printf("\n\n\tSampled paths:\n");
+
+  for(int k = 0; k < samples; k++) {
+    int length = Paths_sample(pPaths, pPath);
+    printf("\n\t");
+
+    for(int i = 0; i < length; i++)
+      printf("=> %s\t", Model.nodePointers[pPath[i]]->id);
+  }
+
+  free(pPath);
+  printf("\n");
+
+  // Stream out the graph, if asked
+  if(outputPath != NULL) {
+    File output;
+
+    // Couldn't open it
+    if(!_Model_openOutput(&output, outputPath)) {
+      printf("\n\tCould not write the shortest-path graph.\n");
+    } else {
+      long edgeCount = Paths_streamGraph(pPaths, _Model_writePathEdge, output.pFile);
+
+      _Model_closeOutput(&output);
+      printf("\n\tWrote the %ld edges of the shortest-path graph.\n", edgeCount);
+    }
+  }
+
+  PathsPool_release(Model.paths, pPaths);
+}
+
+/**
+ * Answers every "sourceId targetId" pair in a file and writes the answers to another.
+ * Either path may be "-" to use the standard input or output instead.
+ * Prints a short summary once done.
+ * 
+ * @param   { char * }  inputPath   The path to the file of pairs.
+ * @param   { char * }  outputPath  The path to write the answers to.
+ * @return  { int }                 Whether or not both files could be opened.
+*/
+int Model_printConnectionFile(char *inputPath, char *outputPath) {
+
+  // The input and output files
+  File input;
+  File output;
+  File_init(&input, inputPath);
+
+  // Use the standard streams if asked
+  if(!strcmp(inputPath, MODEL_STREAM))
+    input.pFile = stdin;
+  else if(!File_open(&input, "r"))
+    return 0;
+
+  if(!_Model_openOutput(&output, outputPath)) {
+    if(input.pFile != stdin)
+      File_close(&input);
+    return 0;
+  }
+
+  // Answer everything
+  Batch *pBatch = Batch_new(Model.graph, Model.nodes, Model.queries, Model.trees, Model.landmarks);
+  long answered = Batch_run(pBatch, input.pFile, output.pFile);
+  long found = pBatch->found;
+  long malformed = pBatch->malformed;
+  
+  // Close the files
+  if(input.pFile != stdin)
+    File_close(&input);
+  _Model_closeOutput(&output);
+
+  // Garbage collection
+  Batch_kill(pBatch);
+
+  // Print the summary
+  fprintf(stderr, "\tAnswered %ld pairs, %ld of which were connected.\n", answered, found);
+
+  if(malformed)
+    fprintf(stderr, "\tSkipped %ld malformed lines.\n", malformed);
+
+  return 1;
+}
+
+/**
+ * Prints the counters of the tree cache.
+ * Useful for telling whether the cache budget is big enough.
+*/
+void Model_printCacheStats() {
+  
+  // Grab the cache
+  TreeCache *pCache = Model.trees;
+
+  // Print the counters
+  printf("\tTree cache: %ld hits, %ld misses, %ld trees built, %ld evictions; %d trees in %.1f of %.1f MB.\n",
+    pCache->hits, pCache->misses, pCache->builds, pCache->evictions, pCache->count,
+    pCache->used / 1048576.0, pCache->budget / 1048576.0);
+}
+
+/**
+ * Prints a summary of the connected components of the model.
+ * Lists the largest few, then how many components there are of each size.
+ * 
+ * @param   { int }   cols  The number of cols for formatting data.
+*/
+void Model_printComponents(int cols) {
+
+  // Grab the components
+  Components *pComponents = Model.components;
+  int count = pComponents->count;
+
+  // The overall numbers
+  printf("\tComponents: %d\n", count);
+  printf("\tLargest: %d nodes (%.2f%% of %d)\n", 
+    pComponents->pSizes[0], 100.0 * pComponents->pSizes[0] / Model.nodeCount, Model.nodeCount);
+
+  // How many components have each size
+  // The sizes are sorted, so equal sizes are next to each other
+  printf("\n\tSize x count:\n");
+
+  for(int i = 0, j = 0, k = 0; i < count; i = j) {
+
+    // Find the end of the run
+    while(j < count && pComponents->pSizes[j] == pComponents->pSizes[i])
+      j++;
+
+    // Column formatting, counting the runs printed rather than the components
+    if(k++ % cols == 0)
+      printf("\n\t");
+
+    printf("%d x %d,\t", pComponents->pSizes[i], j - i);
+  }
+
+  // Last newline
+  printf("\n");
+}
+
+/**
+ * Prints an overview of the dataset: its size, its components and its degrees.
+ * Everything here was collected while loading, so this doesn't go over the data again.
+*/
+void Model_printSummary() {
+
+  // Grab the statistics
+  Degrees *pDegrees = Model.degrees;
+  long edgeCount = pDegrees->sum / 2;
+  double pairs = (double) Model.nodeCount * (Model.nodeCount - 1) / 2;
+
+  // The overall numbers
+  printf("\tDataset: %s\n", Model.activeDataset);
+  printf("\tNodes: %d\n", Model.nodeCount);
+  printf("\tEdges: %ld (density %.6f)\n", edgeCount, pairs > 0 ? edgeCount / pairs : 0);
+  printf("\tComponents: %d, the largest with %d nodes\n", Model.components->count, Model.components->pSizes[0]);
+
+  // The degrees
+  printf("\n\tDegrees: %d to %d, mean %.3f, variance %.3f\n", 
+    Degrees_getMin(pDegrees), pDegrees->maxDegree, Degrees_getMean(pDegrees), Degrees_getVariance(pDegrees));
+  printf("\tMean degree of a friend: %.3f\n", Degrees_getFriendMean(pDegrees));
+
+  // The histogram, in bins that double in width
+  printf("\n\tDegree x count:\n");
+  printf("\t  0: %d\n", pDegrees->pHistogram[0]);
+
+  for(int low = 1; low <= pDegrees->maxDegree; low *= 2) {
+    int count = 0;
+
+    for(int d = low; d < low * 2 && d <= pDegrees->maxDegree; d++)
+      count += pDegrees->pHistogram[d];
+
+    if(low == 1)
+      printf("\t  1: %d\n", count);
+    else
+      printf("\t  %d-%d: %d\n", low, low * 2 - 1, count);
+  }
+
+  // The highest degrees
+  printf("\n\tMost friends:\n");
+
+  for(int i = 0; i < pDegrees->topCount; i++)
+    printf("\t  %d. %s: %d\n", i + 1, Model.nodePointers[pDegrees->pTop[i]]->id, pDegrees->pDegrees[pDegrees->pTop[i]]);
+}
+
+/**
+ * Gets the core numbers of the graph, peeling it the first time.
+ * Big graphs are peeled across threads when there's more than one.
+ * 
+ * @return  { Cores * }   The core numbers.
+*/
+Cores *Model_getCores() {
+
+  // Already peeled
+  if(Model.cores != NULL)
+    return Model.cores;
+
+  // Pick the version that suits the size
+  Model.cores = Thread_getCount() > 1 && Model.nodeCount >= CORES_PARALLEL_MIN ?
+    Cores_newParallel(Model.graph) :
+    Cores_new(Model.graph);
+
+  return Model.cores;
+}
+
+/**
+ * Prints how many nodes have each core number, from the densest core down.
+ * 
+ * @param   { int }   cols  The number of cols for formatting data.
+*/
+void Model_printCores(int cols) {
+
+  // Grab the cores
+  Cores *pCores = Model_getCores();
+
+  // The overall numbers
+  printf("\tHighest core: %d, with %d nodes (peeled in %.3f ms)\n", 
+    pCores->maxCore, pCores->pCounts[pCores->maxCore], pCores->seconds * 1000);
+
+  // How many nodes have each core number
+  printf("\n\tCore x count:\n");
+
+  for(int k = pCores->maxCore, i = 0; k >= 0; k--) {
+
+    // Nobody at this one
+    if(!pCores->pCounts[k])
+      continue;
+
+    // Column formatting
+    if(i++ % cols == 0)
+      printf("\n\t");
+
+    printf("%d x %d,\t", k, pCores->pCounts[k]);
+  }
+
+  // Last newline
+  printf("\n");
+}
+
+/**
+ * Prints the core number of a node.
+ * 
+ * @param   { char * }  id  The id of the node to inspect.
+*/
+void Model_printCoreOf(char *id) {
+
+  // Grab the node we want
+  Node *pNode = HashMap_get(Model.nodes, id);
+
+  // The id was invalid
+  if(pNode == NULL) {
+    printf("\tInvalid id.\n");
+    return;
+  }
+
+  Cores *pCores = Model_getCores();
+  printf("\tCore number of %s: %d (of at most %d)\n", id, pCores->pCores[pNode->index], pCores->maxCore);
+}
+
+/**
+ * Lists the nodes of the k-core, the largest group where everyone has at least k friends within the group.
+ * Also counts the edges inside it, to show how dense it is.
+ * 
+ * @param   { int }   k     The core to list.
+ * @param   { int }   cols  The number of cols for formatting data.
+*/
+void Model_printKCore(int k, int cols) {
+
+  // Grab the cores
+  Cores *pCores = Model_getCores();
+  int *pCoreOf = pCores->pCores;
+  int size = Cores_getSize(pCores, k);
+  long adjCount = 0;
+
+  printf("\tThe %d-core (%d):\n", k, size);
+
+  // List its nodes, counting the edges that stay inside
+  for(int v = 0, i = 0; v < pCores->nodeCount; v++) {
+    int *pAdjs = Graph_getAdjs(Model.graph, v);
+    int degree = Graph_getDegree(Model.graph, v);
+
+    // Not in it
+    if(pCoreOf[v] < k)
+      continue;
+
+    for(int j = 0; j < degree; j++)
+      adjCount += pCoreOf[pAdjs[j]] >= k;
+
+    // Column formatting
+    if(i++ % cols == 0)
+      printf("\n\t");
+
+    printf("%s,\t", Model.nodePointers[v]->id);
+  }
+
+  // How dense it is
+  double pairs = (double) size * (size - 1) / 2;
+  printf("\n\n\tEdges inside: %ld (density %.6f)\n", adjCount / 2, pairs > 0 ? adjCount / 2 / pairs : 0);
+}
+
+/**
+ * Prints the exact diameter of the model, and how many searches it took instead of one from every node.
+ * With every eccentricity, also prints the radius and can write each node's eccentricity to a file.
+ * 
+ * @param   { int }     bEccentricities   Whether to compute the eccentricity of every node too.
+ * @param   { char * }  outputPath        Where to write "id eccentricity" lines, "-" for the standard output, or NULL to skip it.
+*/
+void Model_printDiameter(int bEccentricities, char *outputPath) {
+
+  // Measure everything
+  Eccentricity *pEccentricity = bEccentricities ?
+    Eccentricity_newAll(Model.graph, Model.components) :
+    Eccentricity_newDiameter(Model.graph, Model.components);
+
+  // The overall numbers
+  printf("\tDiameter: %d, between %s and %s\n", pEccentricity->diameter,
+    Model.nodePointers[pEccentricity->source]->id, Model.nodePointers[pEccentricity->target]->id);
+
+  if(bEccentricities)
+    printf("\tRadius of the largest component: %d, around %s\n", 
+      pEccentricity->radius, Model.nodePointers[pEccentricity->center]->id);
+
+  // How much searching it took
+  printf("\n\tSearches: %d instead of %d (%ld adjacencies scanned in %.3f ms)\n", 
+    pEccentricity->bfsCount, Model.nodeCount, pEccentricity->edgeCount, pEccentricity->seconds * 1000);
+
+  // Write out every node, if asked
+  if(bEccentricities && outputPath != NULL) {
+    File output;
+
+    // Couldn't open it
+    if(!_Model_openOutput(&output, outputPath)) {
+      printf("\n\tCould not write the eccentricities.\n");
+    } else {
+      for(int i = 0; i < Model.nodeCount; i++)
+        fprintf(output.pFile, "%s %d\n", Model.nodePointers[i]->id, pEccentricity->pEccentricities[i]);
+
+      _Model_closeOutput(&output);
+    }
+  }
+
+  Eccentricity_kill(pEccentricity);
+}
+
+/**
+ * Measures a group of people read from a file of ids: how far apart they are, and how close each is to everyone.
+ * All the members are searched from at once, sharing each adjacency scan, so big groups cost far less than
+ * a search per member. Writes "id reached closeness harmonic" followed by the distance to every member, in order,
+ * with "-" for members that can't be reached. Ids that aren't in the model are skipped.
+ * 
+ * @param   { char * }  inputPath   The path to the file of ids.
+ * @param   { char * }  outputPath  Where to write the table, or "-" for the standard output.
+ * @return  { int }                 Whether or not both files could be opened.
+*/
+int Model_writeCohort(char *inputPath, char *outputPath) {
+
+  // Try to open the ids
+  File input;
+  File_init(&input, inputPath);
+
+  if(!File_open(&input, "r"))
+    return 0;
+
+  // Collect the members we know
+  int *pMembers = malloc((Model.nodeCount + 1) * sizeof(int));
+  int memberCount = 0;
+  int unknownCount = 0;
+  char id[NODE_ID_LENGTH + 1];
+
+  while(File_read(&input, MODEL_MASK_FORMAT, id) == 1) {
+    Node *pNode = HashMap_get(Model.nodes, id);
+
+    // Not in the model
+    if(pNode == NULL) {
+      unknownCount++;
+      continue;
+    }
+
+    // Repeats are dropped by the cohort, so there's room for every node once
+    if(memberCount < Model.nodeCount)
+      pMembers[memberCount++] = pNode->index;
+  }
+
+  File_close(&input);
+
+  // Open the output
+  File output;
+
+  if(!_Model_openOutput(&output, outputPath)) {
+    free(pMembers);
+    return 0;
+  }
+
+  // Search from everyone at once
+  Cohort *pCohort = Cohort_new(Model.graph, pMembers, memberCount);
+  int count = pCohort->memberCount;
+
+  // The header names the columns
+  fprintf(output.pFile, "id reached closeness harmonic");
+
+  for(int j = 0; j < count; j++)
+    fprintf(output.pFile, " %s", Model.nodePointers[pCohort->pMembers[j]]->id);
+
+  fprintf(output.pFile, "\n");
+
+  // Then a row per member
+  for(int i = 0; i < count; i++) {
+    int *pRow = pCohort->pDistances + (long) i * count;
+
+    fprintf(output.pFile, "%s %d %.6f %.6f", Model.nodePointers[pCohort->pMembers[i]]->id, 
+      pCohort->pReached[i] - 1, Cohort_getCloseness(pCohort, i), pCohort->pHarmonic[i]);
+
+    for(int j = 0; j < count; j++)
+      if(pRow[j] == BFS_UNVISITED)
+        fprintf(output.pFile, " -");
+      else
+        fprintf(output.pFile, " %d", pRow[j]);
+
+    fprintf(output.pFile, "\n");
+  }
+
+  _Model_closeOutput(&output);
+
+  // The closest member, by harmonic centrality so other components don't skew it
+  int best = -1;
+
+  for(int i = 0; i < count; i++)
+    if(best < 0 || pCohort->pHarmonic[i] > pCohort->pHarmonic[best])
+      best = i;
+
+  printf("\n\tMembers: %d (%d unknown ids skipped)\n", count, unknownCount);
+
+  if(best >= 0)
+    printf("\tClosest to everyone: %s (harmonic %.2f)\n", 
+      Model.nodePointers[pCohort->pMembers[best]]->id, pCohort->pHarmonic[best]);
+
+  printf("\n\t%d searches sharing %ld adjacency scans in %.3f ms (%d threads).\n", 
+    count, pCohort->edgeCount, pCohort->seconds * 1000, Thread_getCount());
+
+  // Garbage collection
+  Cohort_kill(pCohort);
+  free(pMembers);
+
+  return 1;
+}
+
+/**
+ * Prints the approximate distance distribution of the model, and the nodes with the highest harmonic centrality.
+ * Everything comes from a few rounds of HyperLogLog counters rather than from the distances themselves.
+ * 
+ * @param   { char * }  outputPath  Where to write "id harmonic" lines, "-" for the standard output, or NULL to skip it.
+*/
+void Model_printDistances(char *outputPath) {
+
+  // Grow the balls
+  HyperBall *pBall = HyperBall_new(Model.graph);
+
+  // The overall numbers
+  printf("\tConnected pairs: about %.0f (%d rounds in %.3f ms)\n", 
+    HyperBall_getPairs(pBall) / 2, pBall->depth, pBall->seconds * 1000);
+  printf("\tAverage distance: %.4f\n", HyperBall_getAverageDistance(pBall));
+  printf("\tEffective diameter: %.4f\n", HyperBall_getEffectiveDiameter(pBall, HYPERBALL_QUANTILE));
+
+  // The share of pairs within each distance
+  printf("\n\tPairs within each distance:\n");
+
+  for(int t = 1; t <= pBall->depth; t++)
+    printf("\t  %d: %.2f%%\n", t, 100 * HyperBall_getWithin(pBall, t));
+
+  // The most central nodes
+  int top[MODEL_TOP_COUNT];
+  int topCount = TopK_select(pBall->pHarmonic, Model.nodeCount, MODEL_TOP_COUNT, top);
+
+  printf("\n\tHighest harmonic centrality:\n");
+
+  for(int i = 0; i < topCount; i++)
+    printf("\t  %d. %s: %.2f\n", i + 1, Model.nodePointers[top[i]]->id, pBall->pHarmonic[top[i]]);
+
+  // Write out every node, if asked
+  if(outputPath != NULL) {
+    File output;
+
+    // Couldn't open it
+    if(!_Model_openOutput(&output, outputPath)) {
+      printf("\n\tCould not write the centralities.\n");
+    } else {
+      for(int i = 0; i < Model.nodeCount; i++)
+        fprintf(output.pFile, "%s %.4f\n", Model.nodePointers[i]->id, pBall->pHarmonic[i]);
+
+      _Model_closeOutput(&output);
+    }
+  }
+
+  HyperBall_kill(pBall);
+}
+
+/**
+ * Gets the clique search of the graph, ordering the nodes the first time.
+ * 
+ * @return  { Cliques * }   The clique search.
+*/
+Cliques *Model_getCliques() {
+
+  // Already ordered
+  if(Model.cliques == NULL)
+    Model.cliques = Cliques_new(Model.graph);
+
+  return Model.cliques;
+}
+
+/**
+ * Prints how many maximal cliques of each size there were, and how much searching it took.
+ * 
+ * @param   { Cliques * }   pCliques  The cliques that were just searched.
+*/
+void _Model_printCliqueSizes(Cliques *pCliques) {
+  printf("\n\t%ld maximal cliques found, %ld written (%ld calls in %.3f ms, degeneracy %d).\n", 
+    pCliques->cliqueCount, pCliques->visitCount, pCliques->callCount, pCliques->seconds * 1000, pCliques->degeneracy);
+
+  // The sizes, largest first
+  for(int s = pCliques->degeneracy + 1, i = 0; s > 0 && i < MODEL_TOP_COUNT; s--) {
+    if(!pCliques->pSizeCounts[s])
+      continue;
+
+    printf("\t  Size %d: %ld\n", s, pCliques->pSizeCounts[s]);
+    i++;
+  }
+}
+
+/**
+ * Writes a maximal clique as a line of ids.
+ * 
+ * @param   { void * }  pArgs     The file to write to.
+ * @param   { int * }   pClique   The members of the clique.
+ * @param   { int }     size      How many members there are.
+*/
+void _Model_writeClique(void *pArgs, int *pClique, int size) {
+  for(int i = 0; i < size; i++)
+    fprintf(pArgs, i ? " %s" : "%s", Model.nodePointers[pClique[i]]->id);
+
+  fprintf(pArgs, "\n");
+}
+
+/**
+ * Writes the maximal cliques of the model as lines of ids, either all of them or the ones with a given node.
+ * The cliques are written as they're found rather than kept, so they come out in no particular order.
+ * 
+ * @param   { char * }  id          The id of the node the cliques have to contain, or "-" for every clique.
+ * @param   { int }     minSize     How many members a clique needs to be written.
+ * @param   { char * }  outputPath  Where to write the cliques, or "-" for the standard output.
+ * @return  { int }                 Whether or not the file could be opened.
+*/
+int Model_writeCliques(char *id, int minSize, char *outputPath) {
+  Node *pNode = NULL;
+
+  // Grab the node we want
+  if(strcmp(id, MODEL_STREAM)) {
+    pNode = HashMap_get(Model.nodes, id);
+
+    // The id was invalid
+    if(pNode == NULL) {
+      printf("\tInvalid id.\n");
+      return 1;
+    }
+  }
+
+  // Open the output
+  File output;
+
+  if(!_Model_openOutput(&output, outputPath))
+    return 0;
+
+  // Search everywhere, or just around the node
+  Cliques *pCliques = Model_getCliques();
+
+  if(pNode == NULL)
+    Cliques_enumerate(pCliques, minSize, _Model_writeClique, output.pFile);
+  else
+    Cliques_enumerateWith(pCliques, pNode->index, minSize, _Model_writeClique, output.pFile);
+
+  _Model_closeOutput(&output);
+
+  _Model_printCliqueSizes(pCliques);
+
+  return 1;
+}
+
+/**
+ * Prints a largest clique of the model.
+ * 
+ * @param   { int }   cols  The number of cols for formatting data.
+*/
+void Model_printMaximumClique(int cols) {
+  Cliques *pCliques = Model_getCliques();
+  int size = Cliques_findMaximum(pCliques);
+
+  printf("\tLargest clique: %d members (the degeneracy allows up to %d)\n", size, pCliques->degeneracy + 1);
+
+  // The members, with column formatting
+  for(int i = 0; i < size; i++) {
+    if(i % cols == 0)
+      printf("\n\t");
+
+    printf("%s,\t", Model.nodePointers[pCliques->pMaximum[i]]->id);
+  }
+
+  printf("\n\n\t%ld maximal cliques looked at (%ld calls in %.3f ms, %d threads).\n", 
+    pCliques->cliqueCount, pCliques->callCount, pCliques->seconds * 1000, Thread_getCount());
+}
+
+/**
+ * Splits the model into communities and prints how good the split is.
+ * The result replaces the last one kept on the model.
+ * 
+ * @param   { int }     bLabelPropagation   Whether to use label propagation instead of Louvain's method.
+ * @param   { char * }  outputPath          Where to write "id community" lines, "-" for the standard output, or NULL to skip it.
+*/
+void Model_printCommunities(int bLabelPropagation, char *outputPath) {
+
+  // Replace the last split
+  if(Model.communities != NULL)
+    Communities_kill(Model.communities);
+
+  Model.communities = bLabelPropagation ?
+    Communities_newLabelPropagation(Model.graph) :
+    Communities_newLouvain(Model.graph);
+
+  Communities *pCommunities = Model.communities;
+
+  // The overall numbers
+  printf("\tCommunities: %d (found in %.3f ms, %d %s)\n", 
+    pCommunities->count, pCommunities->seconds * 1000, pCommunities->rounds, 
+    bLabelPropagation ? "iterations" : "levels");
+  printf("\tModularity: %.6f\n", pCommunities->modularity);
+
+  // The largest ones, which come first
+  printf("\n\tLargest communities:\n");
+
+  for(int i = 0; i < pCommunities->count && i < MODEL_TOP_COUNT; i++)
+    printf("\t  %d. %d nodes (%.2f%%)\n", 
+      i, pCommunities->pSizes[i], 100.0 * pCommunities->pSizes[i] / pCommunities->nodeCount);
+
+  // Write out every node, if asked
+  if(outputPath != NULL) {
+    File output;
+
+    // Couldn't open it
+    if(!_Model_openOutput(&output, outputPath)) {
+      printf("\n\tCould not write the communities.\n");
+    } else {
+      for(int i = 0; i < Model.nodeCount; i++)
+        fprintf(output.pFile, "%s %d\n", Model.nodePointers[i]->id, pCommunities->pLabels[i]);
+
+      _Model_closeOutput(&output);
+    }
+  }
+}
+
+/**
+ * Prints the triangle counts and clustering coefficients of the model.
+ * Lists the nodes in the most triangles, and can write every node's numbers to a file.
+ * 
+ * @param   { char * }  outputPath  Where to write "id triangles coefficient" lines, "-" for the standard output, or NULL to skip it.
+*/
+void Model_printClustering(char *outputPath) {
+
+  // Count everything
+  Triangles *pTriangles = Triangles_new(Model.graph);
+
+  // The overall numbers
+  printf("\tTriangles: %ld (counted in %.3f ms)\n", pTriangles->count, pTriangles->seconds * 1000);
+  printf("\tAverage clustering: %.6f\n", pTriangles->averageClustering);
+  printf("\tTransitivity: %.6f\n", pTriangles->transitivity);
+
+  // The nodes in the most triangles; the counts are exact as doubles
+  int top[MODEL_TOP_COUNT];
+  double *pCounts = malloc((Model.nodeCount + 1) * sizeof(double));
+
+  for(int i = 0; i < Model.nodeCount; i++)
+    pCounts[i] = pTriangles->pCounts[i];
+
+  int topCount = TopK_select(pCounts, Model.nodeCount, MODEL_TOP_COUNT, top);
+  free(pCounts);
+
+  printf("\n\tIn the most triangles:\n");
+
+  for(int i = 0; i < topCount; i++)
+    printf("\t  %s: %ld triangles, clustering %.4f\n", 
+      Model.nodePointers[top[i]]->id, pTriangles->pCounts[top[i]], pTriangles->pClustering[top[i]]);
+
+  // Write out every node, if asked
+  if(outputPath != NULL) {
+    File output;
+
+    // Couldn't open it
+    if(!_Model_openOutput(&output, outputPath)) {
+      printf("\n\tCould not write the per-node numbers.\n");
+    } else {
+      for(int i = 0; i < Model.nodeCount; i++)
+        fprintf(output.pFile, "%s %ld %.6f\n", Model.nodePointers[i]->id, pTriangles->pCounts[i], pTriangles->pClustering[i]);
+
+      _Model_closeOutput(&output);
+    }
+  }
+
+  Triangles_kill(pTriangles);
+}
+
+/**
+ * Prints the nodes with the highest centrality, and how the iterations went.
+ * 
+ * @param   { int }     bEigenvector  Whether to use eigenvector centrality instead of PageRank.
+ * @param   { double }  damping       The damping of PageRank.
+ * @param   { double }  tolerance     How little the scores must move in total to stop.
+ * @param   { int }     k             How many of the top nodes to list.
+*/
+void Model_printCentrality(int bEigenvector, double damping, double tolerance, int k) {
+
+  // Run the iterations
+  Centrality *pCentrality = bEigenvector ?
+    Centrality_newEigenvector(Model.graph, tolerance, CENTRALITY_MAX_ITERATIONS) :
+    Centrality_newPageRank(Model.graph, damping, tolerance, CENTRALITY_MAX_ITERATIONS);
+
+  // How it went
+  printf("\t%s after %d iterations (change %.3g) in %.3f ms, %.3f ms per iteration.\n",
+    pCentrality->bConverged ? "Converged" : "Stopped without converging",
+    pCentrality->iterations, pCentrality->residual, pCentrality->seconds * 1000, 
+    pCentrality->seconds * 1000 / (pCentrality->iterations ? pCentrality->iterations : 1));
+
+  // The best nodes
+  int *pTop = malloc((k > 0 ? k : 1) * sizeof(int));
+  int count = Centrality_getTop(pCentrality, k, pTop);
+
+  printf("\n\tTop %d by %s:\n", count, bEigenvector ? "eigenvector centrality" : "PageRank");
+
+  for(int i = 0; i < count; i++)
+    printf("\t  %d. %s: %.6g\n", i + 1, Model.nodePointers[pTop[i]]->id, (double) pCentrality->pScores[pTop[i]]);
+
+  // Garbage collection
+  free(pTop);
+  Centrality_kill(pCentrality);
+}
+
+/**
+ * Prints the nodes with the highest betweenness, and how much work it took.
+ * With no sample size, every source is searched; a negative one samples until the error bound is likely met.
+ * 
+ * @param   { int }     sampleCount   How many sources to sample, 0 for all of them, or negative to sample adaptively.
+ * @param   { double }  epsilon       The bound on the error of the normalized scores, when sampling adaptively.
+ * @param   { int }     k             How many of the top nodes to list.
+*/
+void Model_printBetweenness(int sampleCount, double epsilon, int k) {
+
+  // Run the searches
+  Betweenness *pBetweenness = 
+    sampleCount == 0 ? Betweenness_newExact(Model.graph) :
+    sampleCount > 0 ? Betweenness_newSampled(Model.graph, sampleCount) :
+    Betweenness_newAdaptive(Model.graph, epsilon, BETWEENNESS_MAX_SAMPLES);
+
+  // How it went
+  printf("\t%s from %d of %d sources in %.3f ms (%ld adjacencies scanned).\n", 
+    pBetweenness->bExact ? "Exact" : "Estimated", pBetweenness->sourceCount, pBetweenness->nodeCount,
+    pBetweenness->seconds * 1000, pBetweenness->edgeCount);
+
+  if(sampleCount < 0 && !pBetweenness->bExact)
+    printf("\t%s\n", pBetweenness->bPrecise ?
+      "Every normalized score is likely within the bound (95% confidence)." :
+      "Hit the most sources allowed before every score was within the bound.");
+
+  // The best nodes
+  int *pTop = malloc((k > 0 ? k : 1) * sizeof(int));
+  int count = Betweenness_getTop(pBetweenness, k, pTop);
+
+  printf("\n\tTop %d by betweenness (pairs, normalized):\n", count);
+
+  for(int i = 0; i < count; i++)
+    printf("\t  %d. %s: %.1f, %.6g\n", i + 1, Model.nodePointers[pTop[i]]->id, 
+      pBetweenness->pScores[pTop[i]], Betweenness_getNormalized(pBetweenness, pTop[i]));
+
+  // Garbage collection
+  free(pTop);
+  Betweenness_kill(pBetweenness);
+}
+
+/**
+ * Gets the path of the distance index of the active dataset.
+ * The index lives right beside the dataset.
+ * 
+ * @param   { char * }  out   Where to write the path.
+*/
+void Model_getLandmarksPath(char *out) {
+  strcpy(out, Model.activeDataset);
+  strcat(out, LANDMARKS_EXTENSION);
+}
+
+/**
+ * Builds the distance index for the active dataset and saves it beside the dataset.
+ * Prints how big the index is and how long it took.
+*/
+void Model_buildLandmarks() {
+
+  // Where the index goes
+  char filepath[256 + sizeof(LANDMARKS_EXTENSION)];
+  Model_getLandmarksPath(filepath);
+
+  // Replace any old index
+  if(Model.landmarks != NULL)
+    Landmarks_kill(Model.landmarks);
+
+  // Build it and time it
+  double start = Timer_now();
+  Model.landmarks = Landmarks_new(Model.graph);
+  double seconds = Timer_now() - start;
+
+  // Print the stats
+  printf("\tBuilt %ld labels (%.1f per node) in %.2fs.\n", 
+    (long) (Model.landmarks->labelCount - Model.nodeCount), 
+    (double) (Model.landmarks->labelCount - Model.nodeCount) / Model.nodeCount, 
+    seconds);
+
+  // Save it
+  if(Landmarks_save(Model.landmarks, filepath))
+    printf("\tSaved the index to %s.\n", filepath);
+  else
+    printf("\tCould not save the index to %s.\n", filepath);
+}
+
+/**
+ * Clears the contents of the model.
+ * Makes sure to perform proper garbage collection.
+*/
+void Model_clearData() {
+
+  // If it's already cleared or smth
+  if(!strcmp(Model.activeDataset, MODEL_EMPTY))
+    return;
+  
+  // Kill the hashmap first
+  // We don't delete the data inside because we clean that up ourselves
+  HashMap_kill(Model.nodes, 0);
+
+  // The compact graph only refers to the nodes
+  // The queries and the index were made for it, so they go too
+  if(Model.landmarks != NULL)
+    Landmarks_kill(Model.landmarks);
+  TreeCache_kill(Model.trees);
+  QueryPool_kill(Model.queries);
+  NeighborhoodPool_kill(Model.neighborhoods);
+  PathsPool_kill(Model.paths);
+  PersonalRankPool_kill(Model.personalRanks);
+  SuggestPool_kill(Model.suggestions);
+  Components_kill(Model.components);
+  Degrees_kill(Model.degrees);
+  if(Model.cores != NULL)
+    Cores_kill(Model.cores);
+  if(Model.cliques != NULL)
+    Cliques_kill(Model.cliques);
+  if(Model.communities != NULL)
+    Communities_kill(Model.communities);
+  if(Model.minhash != NULL)
+    MinHash_kill(Model.minhash);
+  Graph_kill(Model.graph);
+  Model.landmarks = NULL;
+  Model.trees = NULL;
+  Model.neighborhoods = NULL;
+  Model.paths = NULL;
+  Model.personalRanks = NULL;
+  Model.suggestions = NULL;
+  Model.queries = NULL;
+  Model.components = NULL;
+  Model.degrees = NULL;
+  Model.cores = NULL;
+  Model.cliques = NULL;
+  Model.communities = NULL;
+  Model.minhash = NULL;
+  Model.graph = NULL;
+
+  // We kill the associated data with each of the nodes
+  while(Model.nodeCount--)
+    Node_kill(Model.nodePointers[Model.nodeCount], 1);
+
+  // Free the nodePointers
+  free(Model.nodePointers);
+
+  // Create a new hashmap
+  // Reset node count (although that's a bit redudant)
+  Model.nodes = HashMap_new();
+  Model.nodeCount = 0;
+
+  // Empty the activeDataset string
+  strcpy(Model.activeDataset, MODEL_EMPTY);
+}
+
+/**
+ * Reads the file and converts its data into our model.
+ * 
+ * @param   { char * }  filepath  The path to the file to read.
+ * @return  { int }               Whether or not the data was loaded.
+*/
+int Model_loadData(char *filepath) {
+  
+  // Create a file to the dataset
+  File file;
+  File_init(&file, filepath);
+  
+  // Try to open the file
+  if(!File_open(&file, "r"))
+    return 0;
+
+  // Temporary variables for holding read data
+  char sourceId[32];
+  char targetId[32];
+
+  // Metadata
+  int nodeCount;
+  int edgeCount;
+
+  // The first line only contains metadata
+  File_read(&file, "%d %d", &nodeCount, &edgeCount);
+
+  // Init the node pointer array
+  Model.nodePointers = calloc(nodeCount, sizeof(Node *));
+
+  // The components and the degrees are tracked as the edges come in
+  Model.unionFind = UnionFind_new(nodeCount);
+  Model.degrees = Degrees_new(nodeCount);
+
+  // Read the file contents
+  // Also generates the model in memory
+  while(File_read(&file, "%s %s", &sourceId, &targetId))
+    Model_addAdj(sourceId, targetId);
+
+  // Label the components, then drop the union-find
+  Model.components = Components_new(Model.unionFind);
+  UnionFind_kill(Model.unionFind);
+  Model.unionFind = NULL;
+
+  // Build the compact graph for the traversals
+  Model.graph = Graph_new(Model.nodePointers, Model.nodeCount);
+  Model.queries = QueryPool_new(Model.graph, Model.components);
+  Model.neighborhoods = NeighborhoodPool_new(Model.graph);
+  Model.paths = PathsPool_new(Model.graph);
+  Model.personalRanks = PersonalRankPool_new(Model.graph);
+  Model.suggestions = SuggestPool_new(Model.graph);
+
+  // Size the tree cache
+  Model.trees = TreeCache_new(Model.graph, Model_getCacheBudget());
+
+  // Set the active dataset
+  strcpy(Model.activeDataset, filepath);
+
+  // Pick up a saved distance index if there is one
+  char landmarksPath[256 + sizeof(LANDMARKS_EXTENSION)];
+  Model_getLandmarksPath(landmarksPath);
+  Model.landmarks = Landmarks_load(Model.graph, landmarksPath);
 
   // Close the file
   File_close(&file);
@@ -1,7 +1,7 @@
 /**
  * @ Author: Mo David
  * @ Create Time: 2024-07-17 10:27:36
- * @ Modified time: 2024-07-24 22:16:33
+ * @ Modified time: 2026-10-18 20:17:52
  * @ Description:
  * 
  * The node class.
@@ -22,16 +22,16 @@ typedef struct Node Node;
  */
 struct Node {
 
-  // We use these variables for pathfinding
-  Node *pPrevNode;
-  Node *pNextNode;
-
   // We use this instead when creating undirected graphs
   HashMap *adjNodes;
 
   // The id and data of the node
   char id[NODE_ID_LENGTH + 1];
   void *pData;
+
+  // The dense index of the node within the model
+  // This is its position in the compact graph
+  int index;
 };
 
 /**
@@ -59,10 +59,6 @@ Node *_Node_init(Node *this, char *id, void *pData) {
   strncpy(this->id, id, NODE_ID_LENGTH);
   this->pData = pData;
 
-  // Set the pointer to null
-  this->pPrevNode = NULL;
-  this->pNextNode = NULL;
-
   // Init the hashmaps
   this->adjNodes = HashMap_new();
 
@@ -99,37 +95,19 @@ void Node_kill(Node *this, int bShouldFreeData) {
   free(this);
 }
 
-/**
- * Sets the next node of the given node.
- * 
- * @param   { Node * }  this    The node to modify.
- * @param   { Node * }  pNext   A pointer to the next node.
-*/
-void Node_setNext(Node *this, Node *pNext) {
-  this->pNextNode = pNext;
-}
-
-/**
- * Sets the prev node of the given node.
- * 
- * @param   { Node * }  this    The node to modify.
- * @param   { Node * }  pPrev   A pointer to the prev node.
-*/
-void Node_setPrev(Node *this, Node *pPrev) {
-  this->pPrevNode = pPrev;
-}
-
 /**
  * Adds an adjacent node to the given node.
- * This method is used exclusively when addNext() and addPrev() are not.
- * In other words, we either use addNext() and addPrev() OR addAdj() based on whether we're constructing a un/directed graph.
+ * The adjacency is added to both nodes since our graph is undirected.
  * 
  * @param   { Node * }  this  The first node in the adjacency.
  * @param   { Node * }  pAdj  The second node in the adjacency.
+ * @return  { int }           Whether or not the adjacency is new.
 */
-void Node_addAdj(Node *this, Node *pAdj) {
-  HashMap_put(this->adjNodes, pAdj->id, pAdj);
+int Node_addAdj(Node *this, Node *pAdj) {
+  int bIsNew = HashMap_put(this->adjNodes, pAdj->id, pAdj);
   HashMap_put(pAdj->adjNodes, this->id, this);
+
+  return bIsNew;
 }
 
 #endif
\ No newline at end of file
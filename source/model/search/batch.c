@@ -0,0 +1,528 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 21:12:06
+ * @ Modified time: 2026-10-19 09:46:27
+ * @ Description:
+ *
+ * Answers connection queries in bulk.
+ * Pairs are read in chunks, answered in parallel, and written back out in the order they came in.
+ * Sources with many pairs get a tree of their own; the rest are looked up like single queries are,
+ * in the cached trees, then in the distance index if there is one, and only then searched for.
+ */
+
+#ifndef BATCH_C
+#define BATCH_C
+
+#include "../structs/hashmap.c"
+#include "../../utils/thread.c"
+#include "../graph.c"
+#include "../node.c"
+#include "./bfs.c"
+#include "./query.c"
+#include "./cache.c"
+#include "./landmarks.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// How many pairs are held in memory at a time
+#define BATCH_CHUNK (1 << 16)
+
+// Sources with at least this many pairs in a chunk get a full shortest-path tree
+// Smaller groups are looked up, or searched for, one pair at a time
+#define BATCH_TREE_MIN 16
+
+// The longest line read at once; anything longer can't be two valid ids anyway
+#define BATCH_LINE_LENGTH (4 * NODE_ID_LENGTH)
+
+// What separates the ids of a line
+#define BATCH_SPACES " \t\r\n"
+
+#define BATCH_INVALID (-1)
+
+typedef struct BatchPair BatchPair;
+typedef struct BatchKey BatchKey;
+typedef struct Batch Batch;
+
+/**
+ * A single pair and its answer.
+ */
+struct BatchPair {
+
+  // The ids as they were read
+  char sourceId[NODE_ID_LENGTH + 1];
+  char targetId[NODE_ID_LENGTH + 1];
+
+  // The resolved indices, or BATCH_INVALID
+  int source;
+  int target;
+
+  // The path found; length is BATCH_INVALID for bad ids and 0 when there is no path
+  int *pPath;
+  int length;
+};
+
+/**
+ * Used to sort pairs by source without losing their input order.
+ */
+struct BatchKey {
+  int source;
+  int position;
+};
+
+/**
+ * The state of a batch run.
+ */
+struct Batch {
+
+  // What the pairs are answered against
+  Graph *pGraph;
+  HashMap *pNodes;
+  QueryPool *pQueries;
+
+  // Where known paths are read from before searching; the index may be NULL
+  TreeCache *pTrees;
+  Landmarks *pLandmarks;
+
+  // The tree each thread builds for big groups, kept for the whole run
+  int *pParents[THREAD_MAX_COUNT];
+
+  // The pairs of the current chunk
+  BatchPair *pPairs;
+  int pairCount;
+
+  // The pairs sorted by source, and where each source's group starts
+  BatchKey *pKeys;
+  int *pGroups;
+  int groupCount;
+
+  // The line being read, and how many lines were read so far
+  char line[BATCH_LINE_LENGTH + 2];
+  long lineCount;
+
+  // Totals across all chunks, including the lines that weren't a pair of ids
+  long answered;
+  long found;
+  long malformed;
+};
+
+/**
+ * The batch interface.
+ */
+Batch *_Batch_alloc();
+Batch *_Batch_init(Batch *this, Graph *pGraph, HashMap *pNodes, QueryPool *pQueries, TreeCache *pTrees, Landmarks *pLandmarks);
+Batch *Batch_new(Graph *pGraph, HashMap *pNodes, QueryPool *pQueries, TreeCache *pTrees, Landmarks *pLandmarks);
+void Batch_kill(Batch *this);
+
+int _Batch_parse(char *line, char *sourceId, char *targetId);
+int _Batch_read(Batch *this, FILE *pInput);
+void _Batch_resolve(void *pArgs, int thread, int start, int end);
+void _Batch_group(Batch *this);
+int _Batch_connect(Batch *this, Query *pQuery, int source, int target);
+void _Batch_answer(void *pArgs, int thread, int start, int end);
+void _Batch_write(Batch *this, FILE *pOutput);
+long Batch_run(Batch *this, FILE *pInput, FILE *pOutput);
+
+/**
+ * Orders keys by source, then by input position.
+ *
+ * @param   { const void * }  a   The first key.
+ * @param   { const void * }  b   The second key.
+ * @return  { int }               The ordering of the two keys.
+ */
+static int _Batch_compareKey(const void *a, const void *b) {
+  const BatchKey *pA = a;
+  const BatchKey *pB = b;
+
+  // Group by source first
+  if(pA->source != pB->source)
+    return pA->source < pB->source ? -1 : 1;
+
+  return pA->position - pB->position;
+}
+
+/**
+ * Allocates memory for a batch.
+ *
+ * @return  { Batch * }   The memory for the new batch.
+ */
+Batch *_Batch_alloc() {
+  Batch *pBatch = calloc(1, sizeof(*pBatch));
+
+  return pBatch;
+}
+
+/**
+ * Initializes a batch against the given model data.
+ *
+ * @param   { Batch * }       this        The batch to initialize.
+ * @param   { Graph * }       pGraph      The graph to query.
+ * @param   { HashMap * }     pNodes      Maps ids to nodes.
+ * @param   { QueryPool * }   pQueries    Where to get query state from.
+ * @param   { TreeCache * }   pTrees      The cached trees to read paths from.
+ * @param   { Landmarks * }   pLandmarks  The distance index to read paths from; may be NULL.
+ * @return  { Batch * }                   The initialized batch.
+ */
+Batch *_Batch_init(Batch *this, Graph *pGraph, HashMap *pNodes, QueryPool *pQueries, TreeCache *pTrees, Landmarks *pLandmarks) {
+
+  // Save the references
+  this->pGraph = pGraph;
+  this->pNodes = pNodes;
+  this->pQueries = pQueries;
+  this->pTrees = pTrees;
+  this->pLandmarks = pLandmarks;
+
+  // Room for a whole chunk
+  this->pPairs = calloc(BATCH_CHUNK, sizeof(BatchPair));
+  this->pKeys = calloc(BATCH_CHUNK, sizeof(BatchKey));
+  this->pGroups = calloc(BATCH_CHUNK + 1, sizeof(int));
+
+  return this;
+}
+
+/**
+ * Creates a new batch against the given model data.
+ *
+ * @param   { Graph * }       pGraph      The graph to query.
+ * @param   { HashMap * }     pNodes      Maps ids to nodes.
+ * @param   { QueryPool * }   pQueries    Where to get query state from.
+ * @param   { TreeCache * }   pTrees      The cached trees to read paths from.
+ * @param   { Landmarks * }   pLandmarks  The distance index to read paths from; may be NULL.
+ * @return  { Batch * }                   The new batch.
+ */
+Batch *Batch_new(Graph *pGraph, HashMap *pNodes, QueryPool *pQueries, TreeCache *pTrees, Landmarks *pLandmarks) {
+  return _Batch_init(_Batch_alloc(), pGraph, pNodes, pQueries, pTrees, pLandmarks);
+}
+
+/**
+ * Frees the memory associated with a batch.
+ *
+ * @param   { Batch * }   this  The batch to free.
+ */
+void Batch_kill(Batch *this) {
+  for(int t = 0; t < THREAD_MAX_COUNT; t++)
+    free(this->pParents[t]);
+
+  free(this->pPairs);
+  free(this->pKeys);
+  free(this->pGroups);
+  free(this);
+}
+
+/**
+ * Splits a line into exactly two ids.
+ *
+ * @param   { char * }  line      The line to split; it gets cut up in the process.
+ * @param   { char * }  sourceId  Where to copy the first id.
+ * @param   { char * }  targetId  Where to copy the second id.
+ * @return  { int }               How many ids the line had, or -1 if one was too long.
+ */
+int _Batch_parse(char *line, char *sourceId, char *targetId) {
+  char *pIds[2];
+  int count = 0;
+
+  // Walk the tokens
+  while(1) {
+    line += strspn(line, BATCH_SPACES);
+
+    // No more
+    if(*line == 0)
+      break;
+
+    int length = strcspn(line, BATCH_SPACES);
+
+    // Too long to be an id
+    if(length > NODE_ID_LENGTH)
+      return -1;
+
+    // Only the first two are kept
+    if(count < 2)
+      pIds[count] = line;
+
+    count++;
+    line += length;
+
+    // End the token
+    if(*line != 0)
+      *line++ = 0;
+  }
+
+  // Not a pair
+  if(count != 2)
+    return count;
+
+  strcpy(sourceId, pIds[0]);
+  strcpy(targetId, pIds[1]);
+
+  return 2;
+}
+
+/**
+ * Reads up to a chunk of pairs, one per line.
+ * Blank lines are skipped; lines that aren't exactly two ids are reported with their line number and skipped.
+ *
+ * @param   { Batch * }   this    The batch to fill.
+ * @param   { FILE * }    pInput  Where to read the pairs from.
+ * @return  { int }               How many pairs were read.
+ */
+int _Batch_read(Batch *this, FILE *pInput) {
+  this->pairCount = 0;
+
+  // Read until the chunk is full or the input runs out
+  while(this->pairCount < BATCH_CHUNK && fgets(this->line, sizeof(this->line), pInput) != NULL) {
+    BatchPair *pPair = &this->pPairs[this->pairCount];
+    int length = strlen(this->line);
+    int bTruncated = length > 0 && this->line[length - 1] != '\n' && !feof(pInput);
+
+    this->lineCount++;
+
+    // Skip the rest of a line that didn't fit
+    if(bTruncated) {
+      int c;
+      while((c = fgetc(pInput)) != EOF && c != '\n');
+    }
+
+    int count = bTruncated ? -1 : _Batch_parse(this->line, pPair->sourceId, pPair->targetId);
+
+    // Nothing on it
+    if(count == 0)
+      continue;
+
+    // Not a pair
+    if(count != 2) {
+      fprintf(stderr, "\tLine %ld: expected two ids of at most %d characters, skipped.\n", this->lineCount, NODE_ID_LENGTH);
+      this->malformed++;
+      continue;
+    }
+
+    this->pairCount++;
+  }
+
+  return this->pairCount;
+}
+
+/**
+ * Looks up the indices of the pairs within the given range.
+ * The node hashmap is only read, so this runs safely across threads.
+ *
+ * @param   { void * }  pArgs   The batch.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first pair to resolve.
+ * @param   { int }     end     One past the last pair to resolve.
+ */
+void _Batch_resolve(void *pArgs, int thread, int start, int end) {
+  Batch *this = pArgs;
+
+  // Resolve each pair
+  for(int i = start; i < end; i++) {
+    BatchPair *pPair = &this->pPairs[i];
+    Node *pSource = HashMap_get(this->pNodes, pPair->sourceId);
+    Node *pTarget = HashMap_get(this->pNodes, pPair->targetId);
+
+    pPair->source = pSource != NULL ? pSource->index : BATCH_INVALID;
+    pPair->target = pTarget != NULL ? pTarget->index : BATCH_INVALID;
+    pPair->pPath = NULL;
+    pPair->length = 0;
+
+    // Prepare the key for grouping
+    this->pKeys[i].source = pPair->source;
+    this->pKeys[i].position = i;
+  }
+}
+
+/**
+ * Sorts the pairs by source and marks where each source's group begins.
+ *
+ * @param   { Batch * }   this  The batch to group.
+ */
+void _Batch_group(Batch *this) {
+
+  // Sort the keys
+  qsort(this->pKeys, this->pairCount, sizeof(BatchKey), _Batch_compareKey);
+
+  // Mark the group boundaries
+  this->groupCount = 0;
+  for(int i = 0; i < this->pairCount; i++)
+    if(i == 0 || this->pKeys[i].source != this->pKeys[i - 1].source)
+      this->pGroups[this->groupCount++] = i;
+
+  this->pGroups[this->groupCount] = this->pairCount;
+}
+
+/**
+ * Saves a path into a pair.
+ *
+ * @param   { BatchPair * }   pPair   The pair to update.
+ * @param   { int * }         pPath   The path found.
+ * @param   { int }           length  The number of nodes in the path.
+ */
+static void _Batch_savePath(BatchPair *pPair, int *pPath, int length) {
+  pPair->length = length;
+
+  // No path to copy
+  if(length <= 0)
+    return;
+
+  pPair->pPath = malloc(length * sizeof(int));
+  memcpy(pPair->pPath, pPath, length * sizeof(int));
+}
+
+/**
+ * Finds the path of a single pair, reading it off a cached tree or the distance index before searching.
+ * No tree is built here; the batch already gives its busiest sources their own.
+ *
+ * @param   { Batch * }   this    The batch.
+ * @param   { Query * }   pQuery  The query state to search with; the path is left in it.
+ * @param   { int }       source  The index of the source node.
+ * @param   { int }       target  The index of the target node.
+ * @return  { int }               The number of nodes in the path, or 0 if there is none.
+ */
+int _Batch_connect(Batch *this, Query *pQuery, int source, int target) {
+
+  // Try the cached trees first
+  int length = TreeCache_getPath(this->pTrees, source, target, 0, pQuery->pPath);
+
+  // Then the distance index
+  if(length < 0 && this->pLandmarks != NULL)
+    length = Landmarks_getPath(this->pLandmarks, this->pGraph, source, target, pQuery->pPath);
+
+  // Neither had it
+  if(length < 0)
+    length = Query_connect(pQuery, source, target);
+
+  return length;
+}
+
+/**
+ * Answers the source groups within the given range.
+ * Big groups share a single shortest-path tree; small ones are looked up or searched pair by pair.
+ *
+ * @param   { void * }  pArgs   The batch.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first group to answer.
+ * @param   { int }     end     One past the last group to answer.
+ */
+void _Batch_answer(void *pArgs, int thread, int start, int end) {
+  Batch *this = pArgs;
+  Query *pQuery = QueryPool_acquire(this->pQueries);
+  int n = this->pGraph->nodeCount;
+
+  // The tree buffer of this thread is only made once a big group shows up
+  int *pParents = this->pParents[thread];
+
+  // Answer each group
+  for(int g = start; g < end; g++) {
+    int first = this->pGroups[g];
+    int last = this->pGroups[g + 1];
+    int source = this->pKeys[first].source;
+    int bTree = source != BATCH_INVALID && last - first >= BATCH_TREE_MIN;
+
+    // Build the tree once for the whole group
+    if(bTree) {
+
+      // Lazily make the buffer
+      if(pParents == NULL)
+        pParents = this->pParents[thread] = malloc(n * sizeof(int));
+
+      BFS_tree(this->pGraph, source, pParents, NULL, NULL);
+    }
+
+    // Answer each pair of the group
+    for(int k = first; k < last; k++) {
+      BatchPair *pPair = &this->pPairs[this->pKeys[k].position];
+
+      // Bad ids
+      if(pPair->source == BATCH_INVALID || pPair->target == BATCH_INVALID)
+        pPair->length = BATCH_INVALID;
+
+      // Walk up the shared tree
+      else if(bTree)
+        _Batch_savePath(pPair, pQuery->pPath, BFS_treePath(pParents, source, pPair->target, pQuery->pPath));
+
+      // Look it up or search on its own
+      else
+        _Batch_savePath(pPair, pQuery->pPath, _Batch_connect(this, pQuery, pPair->source, pPair->target));
+    }
+  }
+
+  QueryPool_release(this->pQueries, pQuery);
+}
+
+/**
+ * Writes the answers of the chunk in input order, then frees the paths.
+ * Each line holds the two ids followed by the distance and the path, "no path", or "invalid id".
+ *
+ * @param   { Batch * }   this      The batch to write.
+ * @param   { FILE * }    pOutput   Where to write the answers.
+ */
+void _Batch_write(Batch *this, FILE *pOutput) {
+  Node **pNodes = this->pGraph->pNodes;
+
+  // Write each pair
+  for(int i = 0; i < this->pairCount; i++) {
+    BatchPair *pPair = &this->pPairs[i];
+
+    fprintf(pOutput, "%s %s", pPair->sourceId, pPair->targetId);
+
+    // Bad ids or no path
+    if(pPair->length == BATCH_INVALID)
+      fputs(" invalid id", pOutput);
+    else if(pPair->length == 0)
+      fputs(" no path", pOutput);
+
+    // The distance, then the path
+    else {
+      fprintf(pOutput, " %d", pPair->length - 1);
+
+      for(int j = 0; j < pPair->length; j++) {
+        fputc(' ', pOutput);
+        fputs(pNodes[pPair->pPath[j]]->id, pOutput);
+      }
+
+      this->found++;
+    }
+
+    fputc('\n', pOutput);
+
+    // We're done with the path
+    free(pPair->pPath);
+    pPair->pPath = NULL;
+  }
+
+  this->answered += this->pairCount;
+}
+
+/**
+ * Answers every pair in the input and writes the answers to the output.
+ * Only one chunk is held in memory at a time, so the input can be arbitrarily long.
+ *
+ * @param   { Batch * }   this      The batch to run.
+ * @param   { FILE * }    pInput    Where to read "sourceId targetId" lines from.
+ * @param   { FILE * }    pOutput   Where to write the answers.
+ * @return  { long }                How many pairs were answered.
+ */
+long Batch_run(Batch *this, FILE *pInput, FILE *pOutput) {
+
+  // Reset the totals
+  this->lineCount = 0;
+  this->answered = 0;
+  this->found = 0;
+  this->malformed = 0;
+
+  // One chunk at a time
+  while(_Batch_read(this, pInput)) {
+
+    // Resolve, group and answer in parallel
+    Thread_parallelFor(this->pairCount, 1024, _Batch_resolve, this);
+    _Batch_group(this);
+    Thread_parallelFor(this->groupCount, 8, _Batch_answer, this);
+
+    // Stream the answers out
+    _Batch_write(this, pOutput);
+  }
+
+  return this->answered;
+}
+
+#endif
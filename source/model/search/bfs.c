@@ -0,0 +1,933 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 19:58:40
+ * @ Modified time: 2026-10-19 09:33:05
+ * @ Description:
+ *
+ * Breadth-first traversals over the compact graph.
+ */
+
+#ifndef BFS_C
+#define BFS_C
+
+#include "../graph.c"
+#include "../structs/bitset.c"
+#include "../../utils/thread.c"
+#include "../../utils/timer.c"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BFS_UNVISITED (-1)
+
+// Returned by an expansion that ran out of budget
+#define BFS_EXHAUSTED (-2)
+
+// Leaves a limit unset
+#define BFS_NO_LIMIT (-1)
+
+// How many frontier nodes are expanded between readings of the clock
+#define BFS_CLOCK_INTERVAL 256
+
+// The frontier-size heuristics for switching directions
+// Bottom-up kicks in once the frontier has more than 1/ALPHA of the unexplored adjacencies
+// Top-down resumes once the frontier has less than 1/BETA of the nodes
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+// How many nodes each thread claims at a time
+// This is a multiple of the bitset word size so threads never share a word
+#define BFS_CHUNK 1024
+
+typedef enum BFSStatus BFSStatus;
+typedef struct BFSStats BFSStats;
+typedef struct BFSLimits BFSLimits;
+
+/**
+ * How a search ended.
+ */
+enum BFSStatus {
+  BFS_STATUS_FOUND,
+  BFS_STATUS_NONE,
+  BFS_STATUS_HOPS,
+  BFS_STATUS_BUDGET,
+
+  // A shortest path was already known, but it's longer than the hop limit; depth holds its length
+  BFS_STATUS_LONGER,
+};
+
+/**
+ * Some counters describing how much work a traversal did.
+ */
+struct BFSStats {
+
+  // How many adjacencies were scanned
+  long edgeCount;
+
+  // How many nodes were reached
+  int nodeCount;
+
+  // How the search ended, and how many hops it ruled out
+  // Any path between the two is at least depth + 1 hops long when none was found
+  BFSStatus status;
+  int depth;
+
+  // How long it took, in seconds
+  double seconds;
+};
+
+/**
+ * The bounds on a single search.
+ * Any of the numbers may be BFS_NO_LIMIT.
+ */
+struct BFSLimits {
+
+  // The nodes a path may pass through; NULL for all of them
+  // The two ends of the path are always allowed
+  Bitset *pAllowed;
+
+  // The longest path to look for, in hops
+  int maxHops;
+
+  // The most adjacencies to scan
+  long maxEdges;
+
+  // The most wall-clock time to take, in seconds
+  double maxSeconds;
+};
+
+/**
+ * The buffers used by a bidirectional search.
+ * These are kept between searches so repeated queries don't have to allocate or clear anything.
+ */
+typedef struct BFSScratch BFSScratch;
+
+struct BFSScratch {
+
+  // The number of nodes the buffers were sized for
+  int nodeCount;
+
+  // The parents found by each side
+  int *pPrev;
+  int *pNext;
+
+  // The frontier of each side
+  int *pForward;
+  int *pBackward;
+
+  // The nodes marked during the current search
+  int *pTouched;
+  int touchedCount;
+};
+
+/**
+ * The state of a single level of a direction-optimizing traversal.
+ * This is shared by all the threads working on that level.
+ */
+typedef struct BFSLevel BFSLevel;
+
+struct BFSLevel {
+
+  // The graph and the output distances
+  Graph *pGraph;
+  int *pDistances;
+  int level;
+
+  // The frontier as a list (top-down) and as a bitset (bottom-up)
+  int *pFrontier;
+  Bitset *pFrontierBits;
+  Bitset *pNextBits;
+
+  // The nodes each thread discovered in a top-down step
+  int *pBuffers[THREAD_MAX_COUNT];
+  int bufferCounts[THREAD_MAX_COUNT];
+  int bufferLimits[THREAD_MAX_COUNT];
+
+  // The counters of each thread
+  long edgeCounts[THREAD_MAX_COUNT];
+  long volumes[THREAD_MAX_COUNT];
+  int nodeCounts[THREAD_MAX_COUNT];
+};
+
+/**
+ * The bfs interface.
+ */
+BFSScratch *_BFSScratch_alloc();
+BFSScratch *_BFSScratch_init(BFSScratch *this, int nodeCount);
+BFSScratch *BFSScratch_new(int nodeCount);
+void BFSScratch_kill(BFSScratch *this);
+void BFSScratch_reset(BFSScratch *this);
+
+int _BFS_isExhausted(BFSLimits *pLimits, double deadline, BFSStats *pStats, int degree, int checks);
+int _BFS_expand(Graph *pGraph, BFSScratch *pScratch, int *pFrontier, int *pFrontierCount, int *pThisPrev, int *pOtherPrev, BFSLimits *pLimits, double deadline, BFSStats *pStats);
+long _BFS_frontierVolume(Graph *pGraph, int *pFrontier, int frontierCount);
+int BFS_bidirectional(Graph *pGraph, BFSScratch *pScratch, int source, int target, int *pPath, BFSStats *pStats);
+int BFS_bidirectionalWithin(Graph *pGraph, BFSScratch *pScratch, int source, int target, BFSLimits *pLimits, int *pPath, BFSStats *pStats);
+
+void _BFS_topDown(void *pArgs, int thread, int start, int end);
+void _BFS_bottomUp(void *pArgs, int thread, int start, int end);
+int _BFS_directionOptimizing(Graph *pGraph, int source, int *pDistances, BFSStats *pStats, int bParallel);
+int BFS_distances(Graph *pGraph, int source, int *pDistances, BFSStats *pStats);
+int BFS_distancesParallel(Graph *pGraph, int source, int *pDistances, BFSStats *pStats);
+
+int BFS_tree(Graph *pGraph, int source, int *pParents, int *pDistances, BFSStats *pStats);
+int BFS_treePath(int *pParents, int source, int target, int *pPath);
+
+/**
+ * Allocates memory for a scratch.
+ *
+ * @return  { BFSScratch * }  The memory for the new scratch.
+*/
+BFSScratch *_BFSScratch_alloc() {
+  BFSScratch *pScratch = calloc(1, sizeof(*pScratch));
+
+  return pScratch;
+}
+
+/**
+ * Initializes a scratch for a graph with the given number of nodes.
+ * Both parent arrays start out with every node unvisited.
+ *
+ * @param   { BFSScratch * }  this        The scratch to initialize.
+ * @param   { int }           nodeCount   The number of nodes in the graph.
+ * @return  { BFSScratch * }              The initialized scratch.
+*/
+BFSScratch *_BFSScratch_init(BFSScratch *this, int nodeCount) {
+
+  // Save the size
+  this->nodeCount = nodeCount;
+
+  // Allocate the buffers
+  // Each node can be touched once by each side
+  this->pPrev = malloc((nodeCount + 1) * sizeof(int));
+  this->pNext = malloc((nodeCount + 1) * sizeof(int));
+  this->pForward = malloc((nodeCount + 1) * sizeof(int));
+  this->pBackward = malloc((nodeCount + 1) * sizeof(int));
+  this->pTouched = malloc((2 * nodeCount + 1) * sizeof(int));
+  this->touchedCount = 0;
+
+  // Nothing has been visited yet
+  memset(this->pPrev, 0xff, (nodeCount + 1) * sizeof(int));
+  memset(this->pNext, 0xff, (nodeCount + 1) * sizeof(int));
+
+  return this;
+}
+
+/**
+ * Creates a new scratch.
+ *
+ * @param   { int }           nodeCount   The number of nodes in the graph.
+ * @return  { BFSScratch * }              The new scratch.
+*/
+BFSScratch *BFSScratch_new(int nodeCount) {
+  return _BFSScratch_init(_BFSScratch_alloc(), nodeCount);
+}
+
+/**
+ * Frees the memory associated with a scratch.
+ *
+ * @param   { BFSScratch * }  this  The scratch to free.
+*/
+void BFSScratch_kill(BFSScratch *this) {
+  free(this->pPrev);
+  free(this->pNext);
+  free(this->pForward);
+  free(this->pBackward);
+  free(this->pTouched);
+  free(this);
+}
+
+/**
+ * Marks a node as visited by one side of the search, and remembers to undo it later.
+ *
+ * @param   { BFSScratch * }  this    The scratch to modify.
+ * @param   { int * }         pPrev   The parents of the side.
+ * @param   { int }           node    The node to mark.
+ * @param   { int }           parent  Its parent.
+*/
+static inline void _BFSScratch_mark(BFSScratch *this, int *pPrev, int node, int parent) {
+  pPrev[node] = parent;
+  this->pTouched[this->touchedCount++] = node;
+}
+
+/**
+ * Restores the parent arrays so the scratch can be reused.
+ * Only the nodes touched by the last search are reset, so this costs as much as the search did.
+ *
+ * @param   { BFSScratch * }  this  The scratch to reset.
+*/
+void BFSScratch_reset(BFSScratch *this) {
+
+  // Undo each of the marks
+  for(int i = 0; i < this->touchedCount; i++) {
+    this->pPrev[this->pTouched[i]] = BFS_UNVISITED;
+    this->pNext[this->pTouched[i]] = BFS_UNVISITED;
+  }
+
+  this->touchedCount = 0;
+}
+
+/**
+ * Computes how many adjacencies expanding a frontier would scan.
+ *
+ * @param   { Graph * }   pGraph          The graph to traverse.
+ * @param   { int * }     pFrontier       The nodes in the frontier.
+ * @param   { int }       frontierCount   The size of the frontier.
+ * @return  { long }                      The sum of the degrees of the frontier.
+*/
+long _BFS_frontierVolume(Graph *pGraph, int *pFrontier, int frontierCount) {
+  long volume = 0;
+
+  // Sum the degrees
+  for(int i = 0; i < frontierCount; i++)
+    volume += Graph_getDegree(pGraph, pFrontier[i]);
+
+  return volume;
+}
+
+/**
+ * Checks whether scanning the next adjacency list would go over the budget of a search.
+ * The clock is only read every BFS_CLOCK_INTERVAL checks, since reading it isn't free.
+ *
+ * @param   { BFSLimits * }   pLimits   The bounds of the search; may be NULL.
+ * @param   { double }        deadline  When the search has to stop by.
+ * @param   { BFSStats * }    pStats    The counters so far.
+ * @param   { int }           degree    The size of the next adjacency list.
+ * @param   { int }           checks    How many checks were made before this one.
+ * @return  { int }                     Whether or not the search should stop.
+*/
+int _BFS_isExhausted(BFSLimits *pLimits, double deadline, BFSStats *pStats, int degree, int checks) {
+
+  // Nothing to stay within
+  if(pLimits == NULL)
+    return 0;
+
+  // Too many adjacencies
+  if(pLimits->maxEdges != BFS_NO_LIMIT && pStats->edgeCount + degree > pLimits->maxEdges)
+    return 1;
+
+  // Out of time
+  return 
+    pLimits->maxSeconds != BFS_NO_LIMIT && 
+    checks % BFS_CLOCK_INTERVAL == 0 && 
+    Timer_now() > deadline;
+}
+
+/**
+ * Expands one side of a bidirectional search by a single level.
+ * The frontier is replaced in place by the next level.
+ * Returns the node where both sides met, BFS_UNVISITED if they haven't yet, or BFS_EXHAUSTED if the budget ran out.
+ *
+ * @param   { Graph * }       pGraph          The graph to traverse.
+ * @param   { BFSScratch * }  pScratch        The scratch holding the marks.
+ * @param   { int * }         pFrontier       The frontier of this side; overwritten with the next level.
+ * @param   { int * }         pFrontierCount  The size of the frontier; updated with the next size.
+ * @param   { int * }         pThisPrev       The parents discovered by this side.
+ * @param   { int * }         pOtherPrev      The parents discovered by the other side.
+ * @param   { BFSLimits * }   pLimits         The budget of the search; may be NULL.
+ * @param   { double }        deadline        When the search has to stop by.
+ * @param   { BFSStats * }    pStats          Where to accumulate the counters.
+ * @return  { int }                           The meeting node, if any.
+*/
+int _BFS_expand(Graph *pGraph, BFSScratch *pScratch, int *pFrontier, int *pFrontierCount, int *pThisPrev, int *pOtherPrev, BFSLimits *pLimits, double deadline, BFSStats *pStats) {
+
+  // The next level is written after the current one, then shifted down
+  int count = *pFrontierCount;
+  int next = count;
+
+  // The nodes we may step on, if restricted
+  Bitset *pAllowed = pLimits != NULL ? pLimits->pAllowed : NULL;
+
+  // For each node in the current level
+  for(int i = 0; i < count; i++) {
+
+    // Grab its neighbors
+    int u = pFrontier[i];
+    int *pAdjs = Graph_getAdjs(pGraph, u);
+    int degree = Graph_getDegree(pGraph, u);
+
+    // Stop before going over budget
+    if(_BFS_isExhausted(pLimits, deadline, pStats, degree, i))
+      return BFS_EXHAUSTED;
+
+    // Count the work done
+    pStats->edgeCount += degree;
+
+    // Visit each of the neighbors
+    for(int j = 0; j < degree; j++) {
+      int v = pAdjs[j];
+
+      // Already seen by this side
+      if(pThisPrev[v] != BFS_UNVISITED)
+        continue;
+
+      // Not allowed on the path, unless it's the other end; that one is its own parent
+      if(pAllowed != NULL && !Bitset_get(pAllowed, v) && pOtherPrev[v] != v)
+        continue;
+
+      // Mark it
+      _BFSScratch_mark(pScratch, pThisPrev, v, u);
+      pStats->nodeCount++;
+
+      // The first meeting is always on a shortest path
+      if(pOtherPrev[v] != BFS_UNVISITED)
+        return v;
+
+      // Queue it for the next level
+      pFrontier[next++] = v;
+    }
+  }
+
+  // Shift the next level down
+  memmove(pFrontier, pFrontier + count, (next - count) * sizeof(int));
+  *pFrontierCount = next - count;
+
+  // They haven't met yet
+  return BFS_UNVISITED;
+}
+
+/**
+ * Finds a shortest path between two nodes by searching from both ends.
+ * At each step, the side whose frontier has fewer adjacencies to scan is the one expanded.
+ * The path is written from source to target, and its length in nodes is returned (0 when none exists).
+ * All the search state lives in the scratch, so the graph is only ever read.
+ *
+ * @param   { Graph * }       pGraph    The graph to traverse.
+ * @param   { BFSScratch * }  pScratch  A clean scratch sized for the graph; NULL to use a temporary one.
+ * @param   { int }           source    The index of the source node.
+ * @param   { int }           target    The index of the target node.
+ * @param   { int * }         pPath     Where to write the path; must hold nodeCount entries.
+ * @param   { BFSStats * }    pStats    Where to store the counters; may be NULL.
+ * @return  { int }                     The number of nodes in the path.
+*/
+int BFS_bidirectional(Graph *pGraph, BFSScratch *pScratch, int source, int target, int *pPath, BFSStats *pStats) {
+  return BFS_bidirectionalWithin(pGraph, pScratch, source, target, NULL, pPath, pStats);
+}
+
+/**
+ * Finds a shortest path between two nodes like BFS_bidirectional, but gives up once a limit is hit.
+ * If only some nodes are allowed, the path found is the shortest one passing through those alone.
+ * Having searched d levels in total without the sides meeting means no path is d hops or shorter,
+ * so the search stops as soon as that rules out everything within the hop limit.
+ * The budget is checked before each adjacency list is scanned, so the edge limit is never exceeded.
+ * The status in the counters tells the outcomes apart; the other counters hold the partial work.
+ *
+ * @param   { Graph * }       pGraph    The graph to traverse.
+ * @param   { BFSScratch * }  pScratch  A clean scratch sized for the graph; NULL to use a temporary one.
+ * @param   { int }           source    The index of the source node.
+ * @param   { int }           target    The index of the target node.
+ * @param   { BFSLimits * }   pLimits   The bounds of the search; NULL for none.
+ * @param   { int * }         pPath     Where to write the path; must hold nodeCount entries.
+ * @param   { BFSStats * }    pStats    Where to store the counters; may be NULL.
+ * @return  { int }                     The number of nodes in the path, or 0 if none was found.
+*/
+int BFS_bidirectionalWithin(Graph *pGraph, BFSScratch *pScratch, int source, int target, BFSLimits *pLimits, int *pPath, BFSStats *pStats) {
+
+  // Use a throwaway if the caller doesn't care
+  BFSStats stats = { 0 };
+  double start = Timer_now();
+  double deadline = pLimits != NULL ? start + pLimits->maxSeconds : 0;
+
+  // Trivial path
+  if(source == target) {
+    pPath[0] = source;
+    stats.status = BFS_STATUS_FOUND;
+
+    // Save the counters
+    if(pStats != NULL)
+      *pStats = stats;
+
+    return 1;
+  }
+
+  // Make our own scratch if none was given
+  BFSScratch *pOwnScratch = pScratch == NULL ? BFSScratch_new(pGraph->nodeCount) : NULL;
+
+  if(pOwnScratch != NULL)
+    pScratch = pOwnScratch;
+
+  // The parents and frontiers of each side
+  int *pPrev = pScratch->pPrev;
+  int *pNext = pScratch->pNext;
+  int *pForward = pScratch->pForward;
+  int *pBackward = pScratch->pBackward;
+
+  // Seed both sides
+  int forwardCount = 1;
+  int backwardCount = 1;
+  int meet = BFS_UNVISITED;
+  int length = 0;
+
+  pForward[0] = source;
+  pBackward[0] = target;
+  _BFSScratch_mark(pScratch, pPrev, source, source);
+  _BFSScratch_mark(pScratch, pNext, target, target);
+  stats.nodeCount = 2;
+  stats.status = BFS_STATUS_NONE;
+
+  // Grow the cheaper side until they meet or one runs out
+  while(forwardCount && backwardCount && meet == BFS_UNVISITED) {
+
+    // Any path left would be too long
+    if(pLimits != NULL && pLimits->maxHops != BFS_NO_LIMIT && stats.depth + 1 > pLimits->maxHops) {
+      stats.status = BFS_STATUS_HOPS;
+      break;
+    }
+
+    // Expand forward
+    if(_BFS_frontierVolume(pGraph, pForward, forwardCount) <= _BFS_frontierVolume(pGraph, pBackward, backwardCount))
+      meet = _BFS_expand(pGraph, pScratch, pForward, &forwardCount, pPrev, pNext, pLimits, deadline, &stats);
+
+    // Expand backward
+    else
+      meet = _BFS_expand(pGraph, pScratch, pBackward, &backwardCount, pNext, pPrev, pLimits, deadline, &stats);
+
+    // Out of budget
+    if(meet == BFS_EXHAUSTED) {
+      stats.status = BFS_STATUS_BUDGET;
+      break;
+    }
+
+    // One more level has been searched
+    if(meet == BFS_UNVISITED)
+      stats.depth++;
+  }
+
+  // Stitch the path together
+  if(meet >= 0) {
+
+    // Walk back to the source first
+    for(int u = meet; u != source; u = pPrev[u])
+      pPath[length++] = u;
+    pPath[length++] = source;
+
+    // Reverse that half so it starts from the source
+    for(int i = 0; i < length / 2; i++) {
+      int temp = pPath[i];
+      pPath[i] = pPath[length - i - 1];
+      pPath[length - i - 1] = temp;
+    }
+
+    // Then walk forward to the target
+    for(int u = meet; u != target; )
+      pPath[length++] = u = pNext[u];
+
+    stats.status = BFS_STATUS_FOUND;
+    stats.depth = length - 1;
+  }
+
+  // Leave the scratch clean for the next search
+  if(pOwnScratch != NULL)
+    BFSScratch_kill(pOwnScratch);
+  else
+    BFSScratch_reset(pScratch);
+
+  // Save the counters
+  stats.seconds = Timer_now() - start;
+
+  if(pStats != NULL)
+    *pStats = stats;
+
+  return length;
+}
+
+/**
+ * Expands part of the frontier by looking at the neighbors of each frontier node.
+ * Nodes are claimed with a compare-and-swap on their distance, so each is discovered exactly once.
+ *
+ * @param   { void * }  pArgs   The shared BFSLevel.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first frontier position to expand.
+ * @param   { int }     end     One past the last frontier position to expand.
+*/
+void _BFS_topDown(void *pArgs, int thread, int start, int end) {
+
+  // Unpack the state
+  BFSLevel *pLevel = pArgs;
+  Graph *pGraph = pLevel->pGraph;
+  int *pDistances = pLevel->pDistances;
+  int next = pLevel->level + 1;
+
+  // Local counters
+  long edgeCount = 0;
+  long volume = 0;
+
+  // For each frontier node in our range
+  for(int i = start; i < end; i++) {
+
+    // Grab its neighbors
+    int u = pLevel->pFrontier[i];
+    int *pAdjs = Graph_getAdjs(pGraph, u);
+    int degree = Graph_getDegree(pGraph, u);
+
+    edgeCount += degree;
+
+    // Visit each of the neighbors
+    for(int j = 0; j < degree; j++) {
+      int v = pAdjs[j];
+      int expected = BFS_UNVISITED;
+
+      // Cheap check before the atomic
+      if(pDistances[v] != BFS_UNVISITED)
+        continue;
+
+      // Someone else got to it first
+      if(!__atomic_compare_exchange_n(&pDistances[v], &expected, next, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        continue;
+
+      // Grow the buffer if needed
+      if(pLevel->bufferCounts[thread] == pLevel->bufferLimits[thread]) {
+        pLevel->bufferLimits[thread] = pLevel->bufferLimits[thread] * 2 + 64;
+        pLevel->pBuffers[thread] = realloc(pLevel->pBuffers[thread], pLevel->bufferLimits[thread] * sizeof(int));
+      }
+
+      // Save it for the next level
+      pLevel->pBuffers[thread][pLevel->bufferCounts[thread]++] = v;
+      volume += Graph_getDegree(pGraph, v);
+    }
+  }
+
+  // Save the counters
+  pLevel->edgeCounts[thread] += edgeCount;
+  pLevel->volumes[thread] += volume;
+}
+
+/**
+ * Expands the frontier by having each unvisited node look for a parent in it.
+ * Each node stops scanning as soon as it finds one, which is what makes this cheap on large frontiers.
+ * Threads own whole words of the next bitset, so no atomics are needed.
+ *
+ * @param   { void * }  pArgs   The shared BFSLevel.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to check.
+ * @param   { int }     end     One past the last node to check.
+*/
+void _BFS_bottomUp(void *pArgs, int thread, int start, int end) {
+
+  // Unpack the state
+  BFSLevel *pLevel = pArgs;
+  Graph *pGraph = pLevel->pGraph;
+  int *pDistances = pLevel->pDistances;
+  int next = pLevel->level + 1;
+
+  // Local counters
+  long edgeCount = 0;
+  long volume = 0;
+  int nodeCount = 0;
+
+  // For each node in our range
+  for(int v = start; v < end; v++) {
+
+    // Already has a distance
+    if(pDistances[v] != BFS_UNVISITED)
+      continue;
+
+    // Grab its neighbors
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+
+    // Look for any neighbor in the frontier
+    for(int j = 0; j < degree; j++) {
+      edgeCount++;
+
+      // Not in the frontier
+      if(!Bitset_get(pLevel->pFrontierBits, pAdjs[j]))
+        continue;
+
+      // Found a parent
+      pDistances[v] = next;
+      Bitset_set(pLevel->pNextBits, v);
+      volume += degree;
+      nodeCount++;
+      break;
+    }
+  }
+
+  // Save the counters
+  pLevel->edgeCounts[thread] += edgeCount;
+  pLevel->volumes[thread] += volume;
+  pLevel->nodeCounts[thread] += nodeCount;
+}
+
+/**
+ * Computes the distance from a source to every node, switching between top-down and bottom-up steps.
+ * Unreachable nodes are given BFS_UNVISITED.
+ * Returns the largest distance found, which is the eccentricity of the source within its component.
+ *
+ * @param   { Graph * }     pGraph      The graph to traverse.
+ * @param   { int }         source      The index of the source node.
+ * @param   { int * }       pDistances  Where to write the distances; must hold nodeCount entries.
+ * @param   { BFSStats * }  pStats      Where to store the counters; may be NULL.
+ * @param   { int }         bParallel   Whether or not to split each level across threads.
+ * @return  { int }                     The largest distance from the source.
+*/
+int _BFS_directionOptimizing(Graph *pGraph, int source, int *pDistances, BFSStats *pStats, int bParallel) {
+
+  // The shared state
+  int n = pGraph->nodeCount;
+  int threadCount = bParallel ? Thread_getCount() : 1;
+  BFSLevel *pLevel = calloc(1, sizeof(*pLevel));
+
+  pLevel->pGraph = pGraph;
+  pLevel->pDistances = pDistances;
+  pLevel->pFrontier = malloc((n + 1) * sizeof(int));
+  pLevel->pFrontierBits = Bitset_new(n);
+  pLevel->pNextBits = Bitset_new(n);
+
+  // Nothing has been visited yet
+  memset(pDistances, 0xff, n * sizeof(int));
+
+  // Seed the frontier
+  int frontierCount = 1;
+  int bBottomUp = 0;
+  long frontierVolume = Graph_getDegree(pGraph, source);
+  long unexploredVolume = pGraph->adjCount - frontierVolume;
+  BFSStats stats = { 0, 1 };
+
+  pDistances[source] = 0;
+  pLevel->pFrontier[0] = source;
+
+  // One level at a time
+  while(frontierCount) {
+
+    // Switch directions based on how big the frontier has gotten
+    if(!bBottomUp && frontierVolume > unexploredVolume / BFS_ALPHA) {
+
+      // Convert the list into a bitset
+      bBottomUp = 1;
+      Bitset_clear(pLevel->pFrontierBits);
+      for(int i = 0; i < frontierCount; i++)
+        Bitset_set(pLevel->pFrontierBits, pLevel->pFrontier[i]);
+
+    } else if(bBottomUp && frontierCount < n / BFS_BETA) {
+
+      // Convert the bitset into a list
+      bBottomUp = 0;
+      frontierCount = 0;
+      for(int i = 0; i < pLevel->pFrontierBits->wordCount; i++)
+        for(uint64_t w = pLevel->pFrontierBits->words[i]; w; w &= w - 1)
+          pLevel->pFrontier[frontierCount++] = (i << 6) + __builtin_ctzll(w);
+    }
+
+    // Reset the per-thread counters
+    memset(pLevel->volumes, 0, sizeof(pLevel->volumes));
+    memset(pLevel->nodeCounts, 0, sizeof(pLevel->nodeCounts));
+    memset(pLevel->bufferCounts, 0, sizeof(pLevel->bufferCounts));
+
+    // Expand the level
+    if(bBottomUp) {
+
+      // Every unvisited node checks for a parent
+      Bitset_clear(pLevel->pNextBits);
+      if(threadCount > 1)
+        Thread_parallelFor(n, BFS_CHUNK, _BFS_bottomUp, pLevel);
+      else
+        _BFS_bottomUp(pLevel, 0, 0, n);
+
+      // The next frontier becomes the current one
+      Bitset *pTemp = pLevel->pFrontierBits;
+      pLevel->pFrontierBits = pLevel->pNextBits;
+      pLevel->pNextBits = pTemp;
+
+      // Count the new frontier
+      frontierCount = 0;
+      for(int t = 0; t < threadCount; t++)
+        frontierCount += pLevel->nodeCounts[t];
+
+    } else {
+
+      // Every frontier node pushes to its neighbors
+      if(threadCount > 1)
+        Thread_parallelFor(frontierCount, BFS_CHUNK / 16, _BFS_topDown, pLevel);
+      else
+        _BFS_topDown(pLevel, 0, 0, frontierCount);
+
+      // Gather the buffers into the new frontier; threads that found nothing may not have a buffer yet
+      frontierCount = 0;
+      for(int t = 0; t < threadCount; t++) {
+        if(!pLevel->bufferCounts[t])
+          continue;
+
+        memcpy(pLevel->pFrontier + frontierCount, pLevel->pBuffers[t], pLevel->bufferCounts[t] * sizeof(int));
+        frontierCount += pLevel->bufferCounts[t];
+      }
+    }
+
+    // Update the heuristics
+    frontierVolume = 0;
+    for(int t = 0; t < threadCount; t++)
+      frontierVolume += pLevel->volumes[t];
+    unexploredVolume -= frontierVolume;
+
+    // Go to the next level
+    stats.nodeCount += frontierCount;
+    if(frontierCount)
+      pLevel->level++;
+  }
+
+  // Sum up the work
+  for(int t = 0; t < threadCount; t++)
+    stats.edgeCount += pLevel->edgeCounts[t];
+
+  // Save the counters
+  if(pStats != NULL)
+    *pStats = stats;
+
+  // Garbage collection
+  int eccentricity = pLevel->level;
+
+  for(int t = 0; t < THREAD_MAX_COUNT; t++)
+    free(pLevel->pBuffers[t]);
+  free(pLevel->pFrontier);
+  Bitset_kill(pLevel->pFrontierBits);
+  Bitset_kill(pLevel->pNextBits);
+  free(pLevel);
+
+  return eccentricity;
+}
+
+/**
+ * Computes the distance from a source to every node on the current thread.
+ * See _BFS_directionOptimizing() for details.
+ *
+ * @param   { Graph * }     pGraph      The graph to traverse.
+ * @param   { int }         source      The index of the source node.
+ * @param   { int * }       pDistances  Where to write the distances; must hold nodeCount entries.
+ * @param   { BFSStats * }  pStats      Where to store the counters; may be NULL.
+ * @return  { int }                     The largest distance from the source.
+*/
+int BFS_distances(Graph *pGraph, int source, int *pDistances, BFSStats *pStats) {
+  return _BFS_directionOptimizing(pGraph, source, pDistances, pStats, 0);
+}
+
+/**
+ * Computes the distance from a source to every node, splitting each level across threads.
+ * See _BFS_directionOptimizing() for details.
+ *
+ * @param   { Graph * }     pGraph      The graph to traverse.
+ * @param   { int }         source      The index of the source node.
+ * @param   { int * }       pDistances  Where to write the distances; must hold nodeCount entries.
+ * @param   { BFSStats * }  pStats      Where to store the counters; may be NULL.
+ * @return  { int }                     The largest distance from the source.
+*/
+int BFS_distancesParallel(Graph *pGraph, int source, int *pDistances, BFSStats *pStats) {
+  return _BFS_directionOptimizing(pGraph, source, pDistances, pStats, 1);
+}
+
+/**
+ * Builds the shortest-path tree of a source.
+ * Each reached node gets its parent in the tree (the source is its own parent) and its distance.
+ * Unreached nodes are given BFS_UNVISITED in both arrays.
+ *
+ * @param   { Graph * }     pGraph      The graph to traverse.
+ * @param   { int }         source      The index of the source node.
+ * @param   { int * }       pParents    Where to write the parents; must hold nodeCount entries.
+ * @param   { int * }       pDistances  Where to write the distances; must hold nodeCount entries, or NULL to skip them.
+ * @param   { BFSStats * }  pStats      Where to store the counters; may be NULL.
+ * @return  { int }                     The largest distance from the source.
+*/
+int BFS_tree(Graph *pGraph, int source, int *pParents, int *pDistances, BFSStats *pStats) {
+
+  // The queue doubles as the visit order
+  int n = pGraph->nodeCount;
+  int *pQueue = malloc((n + 1) * sizeof(int));
+  int head = 0;
+  int tail = 0;
+  BFSStats stats = { 0, 1 };
+
+  // The current depth, and where its level ends in the queue
+  int depth = 0;
+  int levelEnd = 1;
+
+  // Nothing has been visited yet
+  memset(pParents, 0xff, n * sizeof(int));
+
+  if(pDistances != NULL)
+    memset(pDistances, 0xff, n * sizeof(int));
+
+  // Seed the queue
+  pParents[source] = source;
+  pQueue[tail++] = source;
+
+  if(pDistances != NULL)
+    pDistances[source] = 0;
+
+  // Plain top-down traversal
+  while(head < tail) {
+
+    // Moving on to the next level
+    if(head == levelEnd) {
+      levelEnd = tail;
+      depth++;
+    }
+
+    // Grab the head and its neighbors
+    int u = pQueue[head++];
+    int *pAdjs = Graph_getAdjs(pGraph, u);
+    int degree = Graph_getDegree(pGraph, u);
+
+    stats.edgeCount += degree;
+
+    // Visit each of the neighbors
+    for(int j = 0; j < degree; j++) {
+      int v = pAdjs[j];
+
+      // Already seen
+      if(pParents[v] != BFS_UNVISITED)
+        continue;
+
+      // Hang it on the tree
+      pParents[v] = u;
+      pQueue[tail++] = v;
+
+      if(pDistances != NULL)
+        pDistances[v] = depth + 1;
+    }
+  }
+
+  // The last node dequeued is the farthest
+  int eccentricity = depth;
+  stats.nodeCount = tail;
+
+  // Save the counters
+  if(pStats != NULL)
+    *pStats = stats;
+
+  free(pQueue);
+
+  return eccentricity;
+}
+
+/**
+ * Reads the path from the root of a shortest-path tree to one of its nodes.
+ * The path is written from source to target; returns its length in nodes, or 0 if the target wasn't reached.
+ *
+ * @param   { int * }   pParents  The parents of the tree.
+ * @param   { int }     source    The root of the tree.
+ * @param   { int }     target    The node to walk to.
+ * @param   { int * }   pPath     Where to write the path.
+ * @return  { int }               The number of nodes in the path.
+*/
+int BFS_treePath(int *pParents, int source, int target, int *pPath) {
+  int length = 0;
+
+  // Not in the tree
+  if(pParents[target] == BFS_UNVISITED)
+    return 0;
+
+  // Walk up to the root
+  for(int u = target; u != source; u = pParents[u])
+    pPath[length++] = u;
+  pPath[length++] = source;
+
+  // Flip it so it starts from the source
+  for(int i = 0; i < length / 2; i++) {
+    int temp = pPath[i];
+    pPath[i] = pPath[length - i - 1];
+    pPath[length - i - 1] = temp;
+  }
+
+  return length;
+}
+
+#endif
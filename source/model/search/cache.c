@@ -0,0 +1,354 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 22:10:45
+ * @ Modified time: 2026-10-19 09:33:05
+ * @ Description:
+ *
+ * A bounded cache of shortest-path trees, keyed by their root.
+ * Once a tree is cached, any path from (or to) its root is read off by walking parents.
+ */
+
+#ifndef CACHE_C
+#define CACHE_C
+
+#include "../graph.c"
+#include "./bfs.c"
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// How many misses a source takes before its tree is built
+// One-off queries are cheaper as a bidirectional search than as a whole tree
+#define TREE_CACHE_BUILD_MISSES 2
+
+typedef struct TreeCache TreeCache;
+typedef struct TreeCacheEntry TreeCacheEntry;
+
+/**
+ * A single cached tree.
+ * Entries form a doubly linked list from most to least recently used.
+ */
+struct TreeCacheEntry {
+
+  // The root of the tree and the tree itself; paths are walked up the parents, so no distances are kept
+  int source;
+  int *pParents;
+
+  // The neighbors in the recency list
+  TreeCacheEntry *pPrev;
+  TreeCacheEntry *pNext;
+};
+
+/**
+ * The cache itself.
+ */
+struct TreeCache {
+
+  // The graph the trees are built on
+  Graph *pGraph;
+
+  // Finds the entry of a root directly by its index
+  TreeCacheEntry **pEntries;
+
+  // How many times each source missed without a tree, capped at TREE_CACHE_BUILD_MISSES
+  unsigned char *pMisses;
+
+  // The recency list; the head is the most recently used
+  TreeCacheEntry *pHead;
+  TreeCacheEntry *pTail;
+
+  // How much memory the trees may take, and how much they do
+  long budget;
+  long used;
+  int count;
+
+  // Counters for tuning the budget
+  long hits;
+  long misses;
+  long builds;
+  long evictions;
+
+  // Guards everything above
+  pthread_mutex_t lock;
+};
+
+/**
+ * The cache interface.
+ */
+TreeCache *_TreeCache_alloc();
+TreeCache *_TreeCache_init(TreeCache *this, Graph *pGraph, long budget);
+TreeCache *TreeCache_new(Graph *pGraph, long budget);
+void TreeCache_kill(TreeCache *this);
+
+long _TreeCache_getTreeSize(TreeCache *this);
+void _TreeCache_unlink(TreeCache *this, TreeCacheEntry *pEntry);
+void _TreeCache_pushFront(TreeCache *this, TreeCacheEntry *pEntry);
+void _TreeCache_evict(TreeCache *this);
+int _TreeCache_walk(TreeCacheEntry *pEntry, int target, int bReversed, int *pPath);
+int TreeCache_getPath(TreeCache *this, int source, int target, int bShouldBuild, int *pPath);
+
+/**
+ * Allocates memory for a cache.
+ *
+ * @return  { TreeCache * }   The memory for the new cache.
+ */
+TreeCache *_TreeCache_alloc() {
+  TreeCache *pCache = calloc(1, sizeof(*pCache));
+
+  return pCache;
+}
+
+/**
+ * Initializes an empty cache.
+ *
+ * @param   { TreeCache * }   this    The cache to initialize.
+ * @param   { Graph * }       pGraph  The graph to build trees on.
+ * @param   { long }          budget  How many bytes the trees may take.
+ * @return  { TreeCache * }           The initialized cache.
+ */
+TreeCache *_TreeCache_init(TreeCache *this, Graph *pGraph, long budget) {
+
+  // Nothing cached yet
+  this->pGraph = pGraph;
+  this->pEntries = calloc(pGraph->nodeCount + 1, sizeof(TreeCacheEntry *));
+  this->pMisses = calloc(pGraph->nodeCount + 1, sizeof(unsigned char));
+  this->pHead = NULL;
+  this->pTail = NULL;
+  this->budget = budget;
+  this->used = 0;
+  this->count = 0;
+
+  // Fresh counters
+  this->hits = 0;
+  this->misses = 0;
+  this->builds = 0;
+  this->evictions = 0;
+
+  pthread_mutex_init(&this->lock, NULL);
+
+  return this;
+}
+
+/**
+ * Creates a new empty cache.
+ *
+ * @param   { Graph * }       pGraph  The graph to build trees on.
+ * @param   { long }          budget  How many bytes the trees may take.
+ * @return  { TreeCache * }           The new cache.
+ */
+TreeCache *TreeCache_new(Graph *pGraph, long budget) {
+  return _TreeCache_init(_TreeCache_alloc(), pGraph, budget);
+}
+
+/**
+ * Frees the cache and every tree in it.
+ *
+ * @param   { TreeCache * }   this  The cache to free.
+ */
+void TreeCache_kill(TreeCache *this) {
+
+  // Free each of the trees
+  while(this->pHead != NULL) {
+    TreeCacheEntry *pEntry = this->pHead;
+    this->pHead = pEntry->pNext;
+
+    free(pEntry->pParents);
+    free(pEntry);
+  }
+
+  // Free the cache itself
+  pthread_mutex_destroy(&this->lock);
+  free(this->pEntries);
+  free(this->pMisses);
+  free(this);
+}
+
+/**
+ * Returns how many bytes a single tree takes.
+ *
+ * @param   { TreeCache * }   this  The cache to inspect.
+ * @return  { long }                The size of a tree.
+ */
+long _TreeCache_getTreeSize(TreeCache *this) {
+  return sizeof(TreeCacheEntry) + (long) this->pGraph->nodeCount * sizeof(int);
+}
+
+/**
+ * Takes an entry out of the recency list.
+ *
+ * @param   { TreeCache * }       this    The cache to modify.
+ * @param   { TreeCacheEntry * }  pEntry  The entry to unlink.
+ */
+void _TreeCache_unlink(TreeCache *this, TreeCacheEntry *pEntry) {
+
+  // Fix the neighbors
+  if(pEntry->pPrev != NULL)
+    pEntry->pPrev->pNext = pEntry->pNext;
+  else
+    this->pHead = pEntry->pNext;
+
+  if(pEntry->pNext != NULL)
+    pEntry->pNext->pPrev = pEntry->pPrev;
+  else
+    this->pTail = pEntry->pPrev;
+
+  pEntry->pPrev = NULL;
+  pEntry->pNext = NULL;
+}
+
+/**
+ * Puts an entry at the front of the recency list.
+ *
+ * @param   { TreeCache * }       this    The cache to modify.
+ * @param   { TreeCacheEntry * }  pEntry  The entry to move up.
+ */
+void _TreeCache_pushFront(TreeCache *this, TreeCacheEntry *pEntry) {
+  pEntry->pPrev = NULL;
+  pEntry->pNext = this->pHead;
+
+  if(this->pHead != NULL)
+    this->pHead->pPrev = pEntry;
+  else
+    this->pTail = pEntry;
+
+  this->pHead = pEntry;
+}
+
+/**
+ * Drops the least recently used trees until the cache fits its budget.
+ *
+ * @param   { TreeCache * }   this  The cache to trim.
+ */
+void _TreeCache_evict(TreeCache *this) {
+
+  // Drop from the back
+  while(this->used > this->budget && this->pTail != NULL) {
+    TreeCacheEntry *pEntry = this->pTail;
+
+    _TreeCache_unlink(this, pEntry);
+    this->pEntries[pEntry->source] = NULL;
+    this->pMisses[pEntry->source] = 0;
+    this->used -= _TreeCache_getTreeSize(this);
+    this->count--;
+    this->evictions++;
+
+    free(pEntry->pParents);
+    free(pEntry);
+  }
+}
+
+/**
+ * Writes the path between the root of a tree and a target.
+ * The path normally starts at the root; when reversed, it ends there instead.
+ *
+ * @param   { TreeCacheEntry * }  pEntry      The tree to walk.
+ * @param   { int }               target      The other end of the path.
+ * @param   { int }               bReversed   Whether the root is the target of the query.
+ * @param   { int * }             pPath       Where to write the path.
+ * @return  { int }                           The number of nodes in the path.
+ */
+int _TreeCache_walk(TreeCacheEntry *pEntry, int target, int bReversed, int *pPath) {
+
+  // Walking up the tree already gives the reversed order
+  if(bReversed) {
+    int length = 0;
+
+    // Not reachable
+    if(pEntry->pParents[target] == BFS_UNVISITED)
+      return 0;
+
+    for(int u = target; u != pEntry->source; u = pEntry->pParents[u])
+      pPath[length++] = u;
+    pPath[length++] = pEntry->source;
+
+    return length;
+  }
+
+  return BFS_treePath(pEntry->pParents, pEntry->source, target, pPath);
+}
+
+/**
+ * Finds a shortest path using a cached tree rooted at either end.
+ * On a miss, a tree for the source is built and cached if asked to, but only once the source has missed
+ * TREE_CACHE_BUILD_MISSES times and only if a tree fits the budget at all; otherwise -1 is returned,
+ * and the caller is expected to search for the path itself.
+ * The path is written from source to target; returns its length in nodes, or 0 if there is none.
+ * Safe to call from several threads.
+ *
+ * @param   { TreeCache * }   this          The cache to use.
+ * @param   { int }           source        The index of the source node.
+ * @param   { int }           target        The index of the target node.
+ * @param   { int }           bShouldBuild  Whether or not to build a tree on a miss.
+ * @param   { int * }         pPath         Where to write the path.
+ * @return  { int }                         The number of nodes in the path, or -1 on an unbuilt miss.
+ */
+int TreeCache_getPath(TreeCache *this, int source, int target, int bShouldBuild, int *pPath) {
+  int length = -1;
+
+  // Check both ends, since the graph is undirected
+  pthread_mutex_lock(&this->lock);
+  TreeCacheEntry *pEntry = this->pEntries[source];
+  int bReversed = 0;
+
+  if(pEntry == NULL && this->pEntries[target] != NULL) {
+    pEntry = this->pEntries[target];
+    bReversed = 1;
+  }
+
+  // A hit; bump it and walk it
+  if(pEntry != NULL) {
+    _TreeCache_unlink(this, pEntry);
+    _TreeCache_pushFront(this, pEntry);
+    length = _TreeCache_walk(pEntry, bReversed ? source : target, bReversed, pPath);
+    this->hits++;
+  } else {
+    this->misses++;
+
+    // Only sources that keep coming back are worth a tree, and only if it could ever be kept
+    if(this->pMisses[source] < TREE_CACHE_BUILD_MISSES)
+      this->pMisses[source]++;
+
+    if(this->pMisses[source] < TREE_CACHE_BUILD_MISSES || _TreeCache_getTreeSize(this) > this->budget)
+      bShouldBuild = 0;
+    else if(bShouldBuild)
+      this->builds++;
+  }
+
+  pthread_mutex_unlock(&this->lock);
+
+  // Done, or not allowed to do more
+  if(length >= 0 || !bShouldBuild)
+    return length;
+
+  // Build the tree outside the lock
+  int n = this->pGraph->nodeCount;
+  pEntry = calloc(1, sizeof(*pEntry));
+  pEntry->source = source;
+  pEntry->pParents = malloc(n * sizeof(int));
+  BFS_tree(this->pGraph, source, pEntry->pParents, NULL, NULL);
+  length = _TreeCache_walk(pEntry, target, 0, pPath);
+
+  // Cache it, unless someone beat us to it
+  pthread_mutex_lock(&this->lock);
+
+  if(this->pEntries[source] == NULL) {
+    this->pEntries[source] = pEntry;
+    this->used += _TreeCache_getTreeSize(this);
+    this->count++;
+    _TreeCache_pushFront(this, pEntry);
+    _TreeCache_evict(this);
+    pEntry = NULL;
+  }
+
+  pthread_mutex_unlock(&this->lock);
+
+  // It wasn't kept
+  if(pEntry != NULL) {
+    free(pEntry->pParents);
+    free(pEntry);
+  }
+
+  return length;
+}
+
+#endif
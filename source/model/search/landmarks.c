@@ -0,0 +1,636 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 21:36:27
+ * @ Modified time: 2026-10-19 07:48:20
+ * @ Description:
+ *
+ * A distance index built with pruned landmark labeling.
+ * Every node keeps a short list of (hub, distance) labels, and the distance between two nodes is read off by merging their lists.
+ */
+
+#ifndef LANDMARKS_C
+#define LANDMARKS_C
+
+#include "../graph.c"
+#include "../../utils/thread.c"
+#include "./bfs.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Used to tell our index files apart from anything else
+#define LANDMARKS_MAGIC 0x324c4c50
+#define LANDMARKS_EXTENSION ".pll"
+#define LANDMARKS_INFINITY (1 << 29)
+
+// How many hubs are labeled one after the other before switching to parallel batches
+// The first hubs prune the most, so these are worth doing strictly in order
+#define LANDMARKS_SERIAL_HUBS 256
+
+// How many hubs each thread labels per batch afterwards
+#define LANDMARKS_BATCH_PER_THREAD 4
+
+typedef struct Landmarks Landmarks;
+typedef struct LandmarksList LandmarksList;
+typedef struct LandmarksBuild LandmarksBuild;
+
+/**
+ * The labels of a single node while the index is being built.
+ * Hubs are stored by rank, and are always appended in increasing rank.
+ */
+struct LandmarksList {
+  int *pHubs;
+  int *pDistances;
+  int count;
+  int limit;
+};
+
+/**
+ * The finished index.
+ * The labels of node v are at [offsets[v], offsets[v + 1]), each terminated by a sentinel hub of nodeCount.
+ */
+struct Landmarks {
+
+  // The size and the checksum of the graph the index was built for
+  int nodeCount;
+  int adjCount;
+  uint64_t checksum;
+
+  // The rank of each node; rank 0 is the highest degree
+  int *pRanks;
+
+  // The flattened labels
+  int *pOffsets;
+  int *pHubs;
+  int *pDistances;
+  int64_t labelCount;
+};
+
+/**
+ * The state shared by the threads while building.
+ */
+struct LandmarksBuild {
+
+  // The graph and the node order
+  Graph *pGraph;
+  int *pOrder;
+
+  // The labels so far, and the labels found by the current batch
+  LandmarksList *pLists;
+  LandmarksList *pPending[THREAD_MAX_COUNT];
+
+  // The nodes each thread labeled in the current batch, so committing only visits those
+  int *pTouched[THREAD_MAX_COUNT];
+  int touchedCounts[THREAD_MAX_COUNT];
+
+  // Where each node's list stood before the current batch, or -1 if the batch hasn't reached it
+  // Also the nodes the batch reached, in the order they were first seen
+  int *pFirsts;
+  int *pCommitted;
+
+  // The scratch of each thread
+  int *pQueues[THREAD_MAX_COUNT];
+  int *pSeen[THREAD_MAX_COUNT];
+  int *pHubDistances[THREAD_MAX_COUNT];
+
+  // The first rank of the current batch
+  int batchStart;
+};
+
+/**
+ * The landmarks interface.
+ */
+Landmarks *_Landmarks_alloc();
+Landmarks *_Landmarks_init(Landmarks *this, Graph *pGraph);
+Landmarks *Landmarks_new(Graph *pGraph);
+void Landmarks_kill(Landmarks *this);
+
+void _Landmarks_label(void *pArgs, int thread, int start, int end);
+void _Landmarks_commit(LandmarksBuild *pBuild, int threadCount);
+int Landmarks_getDistance(Landmarks *this, int source, int target);
+int Landmarks_getPath(Landmarks *this, Graph *pGraph, int source, int target, int *pPath);
+
+int Landmarks_save(Landmarks *this, char *filepath);
+Landmarks *Landmarks_load(Graph *pGraph, char *filepath);
+
+/**
+ * Appends a label to a list.
+ *
+ * @param   { LandmarksList * }   pList     The list to grow.
+ * @param   { int }               hub       The rank of the hub.
+ * @param   { int }               distance  The distance to the hub.
+ */
+static inline void _LandmarksList_push(LandmarksList *pList, int hub, int distance) {
+
+  // Grow if needed
+  if(pList->count == pList->limit) {
+    pList->limit = pList->limit * 2 + 4;
+    pList->pHubs = realloc(pList->pHubs, pList->limit * sizeof(int));
+    pList->pDistances = realloc(pList->pDistances, pList->limit * sizeof(int));
+  }
+
+  pList->pHubs[pList->count] = hub;
+  pList->pDistances[pList->count++] = distance;
+}
+
+/**
+ * Orders nodes by decreasing degree, breaking ties by index.
+ *
+ * @param   { const void * }  a   The first node, prefixed by its negated degree.
+ * @param   { const void * }  b   The second node, prefixed by its negated degree.
+ * @return  { int }               The ordering of the two nodes.
+ */
+static int _Landmarks_compareDegree(const void *a, const void *b) {
+  const int *pA = a;
+  const int *pB = b;
+
+  if(pA[0] != pB[0])
+    return pA[0] - pB[0];
+
+  return pA[1] - pB[1];
+}
+
+/**
+ * Allocates memory for an index.
+ *
+ * @return  { Landmarks * }   The memory for the new index.
+ */
+Landmarks *_Landmarks_alloc() {
+  Landmarks *pLandmarks = calloc(1, sizeof(*pLandmarks));
+
+  return pLandmarks;
+}
+
+/**
+ * Runs the pruned searches for the hubs within the given range of the current batch.
+ * A search from a hub stops at any node whose distance the existing labels already cover.
+ * New labels go to the thread's pending lists so that the batch only ever reads committed labels.
+ *
+ * @param   { void * }  pArgs   The shared LandmarksBuild.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first hub, relative to the batch.
+ * @param   { int }     end     One past the last hub, relative to the batch.
+ */
+void _Landmarks_label(void *pArgs, int thread, int start, int end) {
+
+  // Unpack the state
+  LandmarksBuild *pBuild = pArgs;
+  Graph *pGraph = pBuild->pGraph;
+  LandmarksList *pLists = pBuild->pLists;
+  LandmarksList *pPending = pBuild->pPending[thread];
+  int *pTouched = pBuild->pTouched[thread];
+  int *pQueue = pBuild->pQueues[thread];
+  int *pSeen = pBuild->pSeen[thread];
+  int *pHubDistances = pBuild->pHubDistances[thread];
+
+  // One pruned search per hub
+  for(int i = start; i < end; i++) {
+    int rank = pBuild->batchStart + i;
+    int root = pBuild->pOrder[rank];
+    LandmarksList *pRootList = &pLists[root];
+
+    // Spread the labels of the root so each check is a single pass over the other list
+    for(int j = 0; j < pRootList->count; j++)
+      pHubDistances[pRootList->pHubs[j]] = pRootList->pDistances[j];
+
+    // Seed the search
+    int head = 0;
+    int tail = 0;
+    pQueue[tail++] = root;
+    pSeen[root] = 0;
+
+    // Level by level
+    while(head < tail) {
+      int u = pQueue[head++];
+      int d = pSeen[u];
+      LandmarksList *pList = &pLists[u];
+      int bPruned = 0;
+
+      // Check whether an earlier hub already gives a distance at least as good
+      for(int j = 0; j < pList->count && !bPruned; j++)
+        if(pHubDistances[pList->pHubs[j]] + pList->pDistances[j] <= d)
+          bPruned = 1;
+
+      // Nothing new to say about u or anything behind it
+      if(bPruned)
+        continue;
+
+      // Label it, remembering the first label of each node
+      if(!pPending[u].count)
+        pTouched[pBuild->touchedCounts[thread]++] = u;
+
+      _LandmarksList_push(&pPending[u], rank, d);
+
+      // Visit the neighbors
+      int *pAdjs = Graph_getAdjs(pGraph, u);
+      int degree = Graph_getDegree(pGraph, u);
+
+      for(int j = 0; j < degree; j++) {
+        int v = pAdjs[j];
+
+        if(pSeen[v] != BFS_UNVISITED)
+          continue;
+
+        pSeen[v] = d + 1;
+        pQueue[tail++] = v;
+      }
+    }
+
+    // Reset only what we touched
+    for(int j = 0; j < tail; j++)
+      pSeen[pQueue[j]] = BFS_UNVISITED;
+
+    for(int j = 0; j < pRootList->count; j++)
+      pHubDistances[pRootList->pHubs[j]] = LANDMARKS_INFINITY;
+  }
+}
+
+/**
+ * Moves the labels found by a batch into the lists, in rank order.
+ * Only the nodes some thread labeled are visited, so a batch costs what it found rather than the size of the graph.
+ * Every pending hub outranks the committed ones, so only the new tail of each list needs sorting.
+ *
+ * @param   { LandmarksBuild * }  pBuild        The build state, after a batch.
+ * @param   { int }               threadCount   How many threads may have labeled nodes.
+ */
+void _Landmarks_commit(LandmarksBuild *pBuild, int threadCount) {
+  int committedCount = 0;
+
+  // Move the labels of each thread over
+  for(int t = 0; t < threadCount; t++) {
+    for(int i = 0; i < pBuild->touchedCounts[t]; i++) {
+      int v = pBuild->pTouched[t][i];
+      LandmarksList *pList = &pBuild->pLists[v];
+      LandmarksList *pPending = &pBuild->pPending[t][v];
+
+      // The first thread to reach it this batch
+      if(pBuild->pFirsts[v] < 0) {
+        pBuild->pFirsts[v] = pList->count;
+        pBuild->pCommitted[committedCount++] = v;
+      }
+
+      for(int j = 0; j < pPending->count; j++)
+        _LandmarksList_push(pList, pPending->pHubs[j], pPending->pDistances[j]);
+
+      pPending->count = 0;
+    }
+
+    pBuild->touchedCounts[t] = 0;
+  }
+
+  // Insertion sort the tails; each is at most a batch long
+  for(int c = 0; c < committedCount; c++) {
+    int v = pBuild->pCommitted[c];
+    LandmarksList *pList = &pBuild->pLists[v];
+    int first = pBuild->pFirsts[v];
+
+    for(int i = first + 1; i < pList->count; i++) {
+      int hub = pList->pHubs[i];
+      int distance = pList->pDistances[i];
+      int j = i - 1;
+
+      for(; j >= first && pList->pHubs[j] > hub; j--) {
+        pList->pHubs[j + 1] = pList->pHubs[j];
+        pList->pDistances[j + 1] = pList->pDistances[j];
+      }
+
+      pList->pHubs[j + 1] = hub;
+      pList->pDistances[j + 1] = distance;
+    }
+
+    pBuild->pFirsts[v] = -1;
+  }
+}
+
+/**
+ * Builds the index for the given graph.
+ * Hubs are taken in decreasing degree order; after the first few, they are labeled in parallel batches.
+ * Hubs within a batch can't prune each other, which only adds redundant labels and never changes an answer.
+ *
+ * @param   { Landmarks * }   this    The index to build.
+ * @param   { Graph * }       pGraph  The graph to index.
+ * @return  { Landmarks * }           The built index.
+ */
+Landmarks *_Landmarks_init(Landmarks *this, Graph *pGraph) {
+
+  // Save the size
+  int n = pGraph->nodeCount;
+  int threadCount = Thread_getCount();
+  this->nodeCount = n;
+  this->adjCount = pGraph->adjCount;
+  this->checksum = Graph_getChecksum(pGraph);
+
+  // Sort the nodes by degree
+  int *pPairs = malloc(2 * (n + 1) * sizeof(int));
+  int *pOrder = malloc((n + 1) * sizeof(int));
+  this->pRanks = malloc((n + 1) * sizeof(int));
+
+  for(int v = 0; v < n; v++) {
+    pPairs[2 * v] = -Graph_getDegree(pGraph, v);
+    pPairs[2 * v + 1] = v;
+  }
+
+  qsort(pPairs, n, 2 * sizeof(int), _Landmarks_compareDegree);
+
+  for(int r = 0; r < n; r++) {
+    pOrder[r] = pPairs[2 * r + 1];
+    this->pRanks[pOrder[r]] = r;
+  }
+
+  free(pPairs);
+
+  // Set up the shared state
+  LandmarksBuild build = { 0 };
+  build.pGraph = pGraph;
+  build.pOrder = pOrder;
+  build.pLists = calloc(n + 1, sizeof(LandmarksList));
+  build.pFirsts = malloc((n + 1) * sizeof(int));
+  build.pCommitted = malloc((n + 1) * sizeof(int));
+
+  for(int v = 0; v <= n; v++)
+    build.pFirsts[v] = -1;
+
+  for(int t = 0; t < threadCount; t++) {
+    build.pPending[t] = calloc(n + 1, sizeof(LandmarksList));
+    build.pTouched[t] = malloc((n + 1) * sizeof(int));
+    build.pQueues[t] = malloc((n + 1) * sizeof(int));
+    build.pSeen[t] = malloc((n + 1) * sizeof(int));
+    build.pHubDistances[t] = malloc((n + 1) * sizeof(int));
+
+    memset(build.pSeen[t], 0xff, (n + 1) * sizeof(int));
+    for(int v = 0; v <= n; v++)
+      build.pHubDistances[t][v] = LANDMARKS_INFINITY;
+  }
+
+  // Label the hubs batch by batch
+  while(build.batchStart < n) {
+
+    // The first hubs go one at a time
+    int size = build.batchStart < LANDMARKS_SERIAL_HUBS ? 1 : threadCount * LANDMARKS_BATCH_PER_THREAD;
+
+    if(build.batchStart + size > n)
+      size = n - build.batchStart;
+
+    // Run the searches
+    if(size == 1)
+      _Landmarks_label(&build, 0, 0, 1);
+    else
+      Thread_parallelFor(size, 1, _Landmarks_label, &build);
+
+    _Landmarks_commit(&build, threadCount);
+    build.batchStart += size;
+  }
+
+  // Flatten the lists, with a sentinel after each
+  this->pOffsets = malloc((n + 1) * sizeof(int));
+  this->pOffsets[0] = 0;
+
+  for(int v = 0; v < n; v++)
+    this->pOffsets[v + 1] = this->pOffsets[v] + build.pLists[v].count + 1;
+
+  this->labelCount = this->pOffsets[n];
+  this->pHubs = malloc((this->labelCount + 1) * sizeof(int));
+  this->pDistances = malloc((this->labelCount + 1) * sizeof(int));
+
+  for(int v = 0; v < n; v++) {
+    LandmarksList *pList = &build.pLists[v];
+    int offset = this->pOffsets[v];
+
+    memcpy(this->pHubs + offset, pList->pHubs, pList->count * sizeof(int));
+    memcpy(this->pDistances + offset, pList->pDistances, pList->count * sizeof(int));
+    this->pHubs[offset + pList->count] = n;
+    this->pDistances[offset + pList->count] = 0;
+
+    free(pList->pHubs);
+    free(pList->pDistances);
+  }
+
+  // Garbage collection
+  for(int t = 0; t < threadCount; t++) {
+    for(int v = 0; v < n; v++) {
+      free(build.pPending[t][v].pHubs);
+      free(build.pPending[t][v].pDistances);
+    }
+
+    free(build.pPending[t]);
+    free(build.pTouched[t]);
+    free(build.pQueues[t]);
+    free(build.pSeen[t]);
+    free(build.pHubDistances[t]);
+  }
+
+  free(build.pLists);
+  free(build.pFirsts);
+  free(build.pCommitted);
+  free(pOrder);
+
+  return this;
+}
+
+/**
+ * Builds a new index for the given graph.
+ *
+ * @param   { Graph * }       pGraph  The graph to index.
+ * @return  { Landmarks * }           The new index.
+ */
+Landmarks *Landmarks_new(Graph *pGraph) {
+  return _Landmarks_init(_Landmarks_alloc(), pGraph);
+}
+
+/**
+ * Frees the memory associated with an index.
+ *
+ * @param   { Landmarks * }   this  The index to free.
+ */
+void Landmarks_kill(Landmarks *this) {
+  free(this->pRanks);
+  free(this->pOffsets);
+  free(this->pHubs);
+  free(this->pDistances);
+  free(this);
+}
+
+/**
+ * Returns the exact distance between two nodes, or BFS_UNVISITED if they aren't connected.
+ * This is a single merge of the two sorted label lists.
+ *
+ * @param   { Landmarks * }   this    The index to read.
+ * @param   { int }           source  The index of the first node.
+ * @param   { int }           target  The index of the second node.
+ * @return  { int }                   The distance between the two.
+ */
+int Landmarks_getDistance(Landmarks *this, int source, int target) {
+
+  // The two lists
+  int *pHubsA = this->pHubs + this->pOffsets[source];
+  int *pHubsB = this->pHubs + this->pOffsets[target];
+  int *pDistancesA = this->pDistances + this->pOffsets[source];
+  int *pDistancesB = this->pDistances + this->pOffsets[target];
+  int best = LANDMARKS_INFINITY;
+  int sentinel = this->nodeCount;
+
+  // Merge until either list hits its sentinel
+  while(*pHubsA != sentinel && *pHubsB != sentinel) {
+
+    // A shared hub
+    if(*pHubsA == *pHubsB) {
+      if(*pDistancesA + *pDistancesB < best)
+        best = *pDistancesA + *pDistancesB;
+
+      pHubsA++; pDistancesA++;
+      pHubsB++; pDistancesB++;
+    }
+
+    // Advance the smaller side
+    else if(*pHubsA < *pHubsB) {
+      pHubsA++; pDistancesA++;
+    } else {
+      pHubsB++; pDistancesB++;
+    }
+  }
+
+  return best == LANDMARKS_INFINITY ? BFS_UNVISITED : best;
+}
+
+/**
+ * Rebuilds a shortest path from the distances in the index.
+ * From each node, we step to any neighbor that is one hop closer to the target.
+ * The path is written from source to target; returns its length in nodes, or 0 if there is none.
+ *
+ * @param   { Landmarks * }   this    The index to read.
+ * @param   { Graph * }       pGraph  The graph the index was built for.
+ * @param   { int }           source  The index of the source node.
+ * @param   { int }           target  The index of the target node.
+ * @param   { int * }         pPath   Where to write the path.
+ * @return  { int }                   The number of nodes in the path.
+ */
+int Landmarks_getPath(Landmarks *this, Graph *pGraph, int source, int target, int *pPath) {
+
+  // Not connected
+  int distance = Landmarks_getDistance(this, source, target);
+
+  if(distance == BFS_UNVISITED)
+    return 0;
+
+  // Walk towards the target
+  int length = 0;
+  int u = source;
+
+  pPath[length++] = u;
+
+  while(distance > 0) {
+    int *pAdjs = Graph_getAdjs(pGraph, u);
+    int degree = Graph_getDegree(pGraph, u);
+
+    // Find a neighbor one hop closer
+    for(int j = 0; j < degree; j++) {
+      if(Landmarks_getDistance(this, pAdjs[j], target) == distance - 1) {
+        u = pAdjs[j];
+        break;
+      }
+    }
+
+    pPath[length++] = u;
+    distance--;
+  }
+
+  return length;
+}
+
+/**
+ * Writes the index to a file.
+ *
+ * @param   { Landmarks * }   this      The index to save.
+ * @param   { char * }        filepath  Where to save it.
+ * @return  { int }                     Whether or not the index was saved.
+ */
+int Landmarks_save(Landmarks *this, char *filepath) {
+
+  // Open the file
+  FILE *pFile = fopen(filepath, "wb");
+
+  if(pFile == NULL)
+    return 0;
+
+  // The header, so we can tell if the file matches the graph later
+  // The counts have fixed widths so files carry across platforms
+  int header[4] = { LANDMARKS_MAGIC, this->nodeCount, this->adjCount, 0 };
+  int n = this->nodeCount;
+
+  fwrite(header, sizeof(int), 4, pFile);
+  fwrite(&this->checksum, sizeof(uint64_t), 1, pFile);
+  fwrite(&this->labelCount, sizeof(int64_t), 1, pFile);
+
+  // The contents
+  fwrite(this->pRanks, sizeof(int), n, pFile);
+  fwrite(this->pOffsets, sizeof(int), n + 1, pFile);
+  fwrite(this->pHubs, sizeof(int), this->labelCount, pFile);
+  fwrite(this->pDistances, sizeof(int), this->labelCount, pFile);
+
+  fclose(pFile);
+
+  return 1;
+}
+
+/**
+ * Reads an index from a file.
+ * Returns NULL if the file doesn't exist or wasn't built for this graph.
+ *
+ * @param   { Graph * }       pGraph    The graph the index should match.
+ * @param   { char * }        filepath  Where to read it from.
+ * @return  { Landmarks * }             The loaded index, or NULL.
+ */
+Landmarks *Landmarks_load(Graph *pGraph, char *filepath) {
+
+  // Open the file
+  FILE *pFile = fopen(filepath, "rb");
+
+  if(pFile == NULL)
+    return NULL;
+
+  // Check the header, down to the checksum so a file from another graph of the same size isn't taken
+  int header[4] = { 0 };
+  uint64_t checksum = 0;
+  int64_t labelCount = 0;
+  int n = pGraph->nodeCount;
+
+  if(fread(header, sizeof(int), 4, pFile) != 4 || 
+    fread(&checksum, sizeof(uint64_t), 1, pFile) != 1 || 
+    fread(&labelCount, sizeof(int64_t), 1, pFile) != 1 ||
+    header[0] != LANDMARKS_MAGIC || header[1] != n || header[2] != pGraph->adjCount || 
+    checksum != Graph_getChecksum(pGraph) || labelCount < 0) {
+    fclose(pFile);
+    return NULL;
+  }
+
+  // Read the contents
+  Landmarks *this = _Landmarks_alloc();
+  this->nodeCount = n;
+  this->adjCount = pGraph->adjCount;
+  this->checksum = checksum;
+  this->labelCount = labelCount;
+  this->pRanks = malloc((n + 1) * sizeof(int));
+  this->pOffsets = malloc((n + 1) * sizeof(int));
+  this->pHubs = malloc((labelCount + 1) * sizeof(int));
+  this->pDistances = malloc((labelCount + 1) * sizeof(int));
+
+  int bComplete =
+    fread(this->pRanks, sizeof(int), n, pFile) == (size_t) n &&
+    fread(this->pOffsets, sizeof(int), n + 1, pFile) == (size_t) n + 1 &&
+    fread(this->pHubs, sizeof(int), labelCount, pFile) == (size_t) labelCount &&
+    fread(this->pDistances, sizeof(int), labelCount, pFile) == (size_t) labelCount;
+
+  fclose(pFile);
+
+  // Truncated file
+  if(!bComplete) {
+    Landmarks_kill(this);
+    return NULL;
+  }
+
+  return this;
+}
+
+#endif
@@ -0,0 +1,663 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 06:07:15
+ * @ Modified time: 2026-10-19 09:24:40
+ * @ Description:
+ *
+ * Finds nodes with similar friend lists without comparing everyone against everyone.
+ * Each node gets a MinHash signature of its friends, where two signatures agree in about as many places as the
+ * Jaccard similarity of the lists. The signatures are cut into bands, and nodes that share a whole band land in
+ * the same bucket (locality-sensitive hashing), so only those pairs are ever compared for real.
+ */
+
+#ifndef MINHASH_C
+#define MINHASH_C
+
+#include "../graph.c"
+#include "../../utils/thread.c"
+#include "../../utils/timer.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Used to tell our signature files apart from anything else
+#define MINHASH_MAGIC 0x32484d4d
+#define MINHASH_EXTENSION ".minhash"
+
+// How long the signatures are, and how they're cut into bands
+// Pairs that share a band are likely once their similarity passes about (1 / BANDS)^(1 / ROWS), here 0.18
+// Friend lists are rarely much more alike than that, so short bands suit them better than long ones
+#define MINHASH_SIZE 64
+#define MINHASH_BANDS 32
+#define MINHASH_ROWS (MINHASH_SIZE / MINHASH_BANDS)
+
+// The default similarity for near-duplicates
+#define MINHASH_THRESHOLD 0.3
+
+// How many nodes each thread claims at a time
+#define MINHASH_CHUNK 256
+
+typedef struct MinHash MinHash;
+typedef struct MinHashEntry MinHashEntry;
+typedef struct MinHashPair MinHashPair;
+typedef struct MinHashJob MinHashJob;
+
+/**
+ * A node filed under the key of one of its bands.
+ */
+struct MinHashEntry {
+  uint32_t key;
+  int node;
+};
+
+/**
+ * Two nodes with similar friend lists.
+ */
+struct MinHashPair {
+  int a;
+  int b;
+  double jaccard;
+};
+
+/**
+ * The signatures and the banded index.
+ * Queries reuse the scratch below, so a single instance must not be queried from several threads at once.
+ */
+struct MinHash {
+
+  // The size and the checksum of the graph the signatures were made for
+  int nodeCount;
+  int adjCount;
+  uint64_t checksum;
+
+  // Whether the signatures were read from or written to a file
+  int bSaved;
+
+  // MINHASH_SIZE hashes per node
+  uint32_t *pSignatures;
+
+  // For each band, the nodes with friends sorted by the key of that band
+  MinHashEntry *pBands;
+  int indexedCount;
+
+  // The candidates of the last query, and a stamp per node to skip repeats
+  int *pCandidates;
+  int candidateCount;
+  int *pStamps;
+  int stamp;
+
+  // How long the signatures took
+  double seconds;
+};
+
+/**
+ * The state shared by the threads signing nodes, filing bands, or pairing up buckets.
+ */
+struct MinHashJob {
+
+  // The graph and the signatures
+  Graph *pGraph;
+  MinHash *pMinHash;
+
+  // How similar a pair has to be to count
+  double threshold;
+
+  // The pairs each thread found, and how many candidates it checked
+  MinHashPair *pPairs[THREAD_MAX_COUNT];
+  long pairCounts[THREAD_MAX_COUNT];
+  long pairLimits[THREAD_MAX_COUNT];
+  long candidateCounts[THREAD_MAX_COUNT];
+};
+
+/**
+ * The minhash interface.
+ */
+MinHash *_MinHash_alloc();
+MinHash *_MinHash_init(MinHash *this, int nodeCount, int adjCount);
+MinHash *MinHash_new(Graph *pGraph);
+void MinHash_kill(MinHash *this);
+
+static inline uint64_t _MinHash_mix(uint64_t x);
+static inline uint32_t _MinHash_getKey(MinHash *this, int v, int band);
+void _MinHash_sign(void *pArgs, int thread, int start, int end);
+void _MinHash_file(void *pArgs, int thread, int start, int end);
+void _MinHash_build(MinHash *this, Graph *pGraph);
+
+double MinHash_getJaccard(Graph *pGraph, int a, int b);
+double MinHash_getEstimate(MinHash *this, int a, int b);
+int MinHash_getSimilar(MinHash *this, Graph *pGraph, int v, int k, int *pTop, double *pScores);
+void _MinHash_pairBand(void *pArgs, int thread, int start, int end);
+long MinHash_getPairs(MinHash *this, Graph *pGraph, double threshold, MinHashPair **ppPairs, long *pCandidateCount);
+
+int MinHash_save(MinHash *this, char *filepath);
+MinHash *MinHash_load(Graph *pGraph, char *filepath);
+
+/**
+ * Orders entries by key, then by node.
+ *
+ * @param   { const void * }  a   The first entry.
+ * @param   { const void * }  b   The second entry.
+ * @return  { int }               The ordering of the two entries.
+ */
+static int _MinHash_compareEntries(const void *a, const void *b) {
+  const MinHashEntry *pA = a;
+  const MinHashEntry *pB = b;
+
+  if(pA->key != pB->key)
+    return pA->key < pB->key ? -1 : 1;
+
+  return pA->node - pB->node;
+}
+
+/**
+ * Allocates memory for the signatures.
+ *
+ * @return  { MinHash * }   The memory for the signatures.
+ */
+MinHash *_MinHash_alloc() {
+  MinHash *pMinHash = calloc(1, sizeof(*pMinHash));
+
+  return pMinHash;
+}
+
+/**
+ * Initializes the signatures with nothing signed or filed yet.
+ *
+ * @param   { MinHash * }   this        The signatures to initialize.
+ * @param   { int }         nodeCount   How many nodes the graph has.
+ * @param   { int }         adjCount    How many adjacencies the graph has.
+ * @return  { MinHash * }               The initialized signatures.
+ */
+MinHash *_MinHash_init(MinHash *this, int nodeCount, int adjCount) {
+  this->nodeCount = nodeCount;
+  this->adjCount = adjCount;
+  this->checksum = 0;
+  this->bSaved = 0;
+  this->pSignatures = malloc(((long) nodeCount * MINHASH_SIZE + 1) * sizeof(uint32_t));
+  this->pBands = NULL;
+  this->indexedCount = 0;
+  this->pCandidates = malloc((nodeCount + 1) * sizeof(int));
+  this->candidateCount = 0;
+  this->pStamps = calloc(nodeCount + 1, sizeof(int));
+  this->stamp = 0;
+  this->seconds = 0;
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with the signatures.
+ *
+ * @param   { MinHash * }   this  The signatures to free.
+ */
+void MinHash_kill(MinHash *this) {
+  free(this->pSignatures);
+  free(this->pBands);
+  free(this->pCandidates);
+  free(this->pStamps);
+  free(this);
+}
+
+/**
+ * Scrambles a number (the splitmix64 finalizer).
+ *
+ * @param   { uint64_t }  x   The number to scramble.
+ * @return  { uint64_t }      The scrambled number.
+ */
+static inline uint64_t _MinHash_mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+
+  return x ^ (x >> 31);
+}
+
+/**
+ * Hashes the rows of one band of a signature into its key.
+ *
+ * @param   { MinHash * }   this  The signatures.
+ * @param   { int }         v     The node.
+ * @param   { int }         band  The band.
+ * @return  { uint32_t }          The key of the band.
+ */
+static inline uint32_t _MinHash_getKey(MinHash *this, int v, int band) {
+  uint32_t *pRows = this->pSignatures + (long) v * MINHASH_SIZE + band * MINHASH_ROWS;
+  uint64_t key = band;
+
+  for(int r = 0; r < MINHASH_ROWS; r++)
+    key = _MinHash_mix(key ^ pRows[r]);
+
+  return key >> 32;
+}
+
+/**
+ * Signs the nodes within the given range.
+ * Hash i of a friend is the top half of a_i * x + b_i, with x the friend's scrambled index and a_i odd, which
+ * only takes a multiply per hash. The signature keeps the lowest of each over all the friends.
+ *
+ * @param   { void * }  pArgs   The shared MinHashJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to sign.
+ * @param   { int }     end     One past the last node to sign.
+ */
+void _MinHash_sign(void *pArgs, int thread, int start, int end) {
+  MinHashJob *pJob = pArgs;
+  Graph *pGraph = pJob->pGraph;
+  uint64_t pA[MINHASH_SIZE];
+  uint64_t pB[MINHASH_SIZE];
+
+  // The same hashes on every thread
+  for(int i = 0; i < MINHASH_SIZE; i++) {
+    pA[i] = _MinHash_mix(2 * i + 1) | 1;
+    pB[i] = _MinHash_mix(2 * i + 2);
+  }
+
+  for(int v = start; v < end; v++) {
+    uint32_t *pSignature = pJob->pMinHash->pSignatures + (long) v * MINHASH_SIZE;
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+
+    // Nothing seen yet
+    for(int i = 0; i < MINHASH_SIZE; i++)
+      pSignature[i] = UINT32_MAX;
+
+    // Keep the lowest of each hash
+    for(int j = 0; j < degree; j++) {
+      uint64_t x = _MinHash_mix(pAdjs[j]);
+
+      for(int i = 0; i < MINHASH_SIZE; i++) {
+        uint32_t h = (pA[i] * x + pB[i]) >> 32;
+
+        if(h < pSignature[i])
+          pSignature[i] = h;
+      }
+    }
+  }
+}
+
+/**
+ * Files every node with friends under the keys of the bands within the given range, then sorts each band.
+ *
+ * @param   { void * }  pArgs   The shared MinHashJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first band to file.
+ * @param   { int }     end     One past the last band to file.
+ */
+void _MinHash_file(void *pArgs, int thread, int start, int end) {
+  MinHashJob *pJob = pArgs;
+  MinHash *this = pJob->pMinHash;
+  Graph *pGraph = pJob->pGraph;
+
+  for(int band = start; band < end; band++) {
+    MinHashEntry *pEntries = this->pBands + (long) band * this->indexedCount;
+    int count = 0;
+
+    // Nodes without friends aren't similar to anyone
+    for(int v = 0; v < this->nodeCount; v++) {
+      if(!Graph_getDegree(pGraph, v))
+        continue;
+
+      pEntries[count].key = _MinHash_getKey(this, v, band);
+      pEntries[count].node = v;
+      count++;
+    }
+
+    qsort(pEntries, count, sizeof(MinHashEntry), _MinHash_compareEntries);
+  }
+}
+
+/**
+ * Builds the banded index from the signatures, a band per thread at a time.
+ *
+ * @param   { MinHash * }   this    The signatures to index.
+ * @param   { Graph * }     pGraph  The graph they were made for.
+ */
+void _MinHash_build(MinHash *this, Graph *pGraph) {
+  MinHashJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+  pJob->pMinHash = this;
+
+  // Only nodes with friends get filed
+  this->indexedCount = 0;
+
+  for(int v = 0; v < this->nodeCount; v++)
+    this->indexedCount += Graph_getDegree(pGraph, v) > 0;
+
+  free(this->pBands);
+  this->pBands = malloc(((long) MINHASH_BANDS * this->indexedCount + 1) * sizeof(MinHashEntry));
+
+  Thread_parallelFor(MINHASH_BANDS, 1, _MinHash_file, pJob);
+  free(pJob);
+}
+
+/**
+ * Signs every node across threads, then builds the index.
+ *
+ * @param   { Graph * }     pGraph  The graph to sign.
+ * @return  { MinHash * }           The signatures and their index.
+ */
+MinHash *MinHash_new(Graph *pGraph) {
+  double start = Timer_now();
+  MinHash *this = _MinHash_init(_MinHash_alloc(), pGraph->nodeCount, pGraph->adjCount);
+  MinHashJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+  pJob->pMinHash = this;
+  this->checksum = Graph_getChecksum(pGraph);
+
+  Thread_parallelFor(pGraph->nodeCount, MINHASH_CHUNK, _MinHash_sign, pJob);
+  free(pJob);
+
+  _MinHash_build(this, pGraph);
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+/**
+ * Computes the exact Jaccard similarity of the friend lists of two nodes by merging them.
+ *
+ * @param   { Graph * }   pGraph  The graph.
+ * @param   { int }       a       The first node.
+ * @param   { int }       b       The second node.
+ * @return  { double }            The size of the intersection over the size of the union.
+ */
+double MinHash_getJaccard(Graph *pGraph, int a, int b) {
+  int *pA = Graph_getAdjs(pGraph, a);
+  int *pB = Graph_getAdjs(pGraph, b);
+  int aCount = Graph_getDegree(pGraph, a);
+  int bCount = Graph_getDegree(pGraph, b);
+  int i = 0, j = 0, common = 0;
+
+  // Both lists are sorted
+  while(i < aCount && j < bCount) {
+    if(pA[i] < pB[j])
+      i++;
+    else if(pA[i] > pB[j])
+      j++;
+    else
+      common++, i++, j++;
+  }
+
+  return aCount + bCount ? (double) common / (aCount + bCount - common) : 0;
+}
+
+/**
+ * Estimates the Jaccard similarity of two nodes from the share of their signatures that agree.
+ *
+ * @param   { MinHash * }   this  The signatures.
+ * @param   { int }         a     The first node.
+ * @param   { int }         b     The second node.
+ * @return  { double }            The estimated similarity.
+ */
+double MinHash_getEstimate(MinHash *this, int a, int b) {
+  uint32_t *pA = this->pSignatures + (long) a * MINHASH_SIZE;
+  uint32_t *pB = this->pSignatures + (long) b * MINHASH_SIZE;
+  int same = 0;
+
+  for(int i = 0; i < MINHASH_SIZE; i++)
+    same += pA[i] == pB[i];
+
+  return (double) same / MINHASH_SIZE;
+}
+
+/**
+ * Finds the nodes whose friend lists are most similar to that of v, most similar first.
+ * Only the nodes sharing a bucket with v in some band are considered, and each is checked exactly.
+ * Afterwards pCandidates lists everyone that was considered.
+ *
+ * @param   { MinHash * }   this      The signatures and their index.
+ * @param   { Graph * }     pGraph    The graph they were made for.
+ * @param   { int }         v         The node to match.
+ * @param   { int }         k         How many nodes to find.
+ * @param   { int * }       pTop      Where to write the nodes; must hold k entries.
+ * @param   { double * }    pScores   Where to write their similarities; must hold k entries.
+ * @return  { int }                   How many nodes were written.
+ */
+int MinHash_getSimilar(MinHash *this, Graph *pGraph, int v, int k, int *pTop, double *pScores) {
+  int count = 0;
+
+  // A new stamp, so last query's marks don't count
+  this->candidateCount = 0;
+  this->stamp++;
+  this->pStamps[v] = this->stamp;
+
+  // Nobody is like someone without friends
+  if(!Graph_getDegree(pGraph, v))
+    return 0;
+
+  for(int band = 0; band < MINHASH_BANDS; band++) {
+    MinHashEntry *pEntries = this->pBands + (long) band * this->indexedCount;
+    uint32_t key = _MinHash_getKey(this, v, band);
+
+    // Find the first entry with the key
+    int low = 0;
+    int high = this->indexedCount;
+
+    while(low < high) {
+      int middle = low + (high - low) / 2;
+
+      if(pEntries[middle].key < key)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+
+    // Check everyone in the bucket once
+    for(int i = low; i < this->indexedCount && pEntries[i].key == key; i++) {
+      int u = pEntries[i].node;
+
+      if(this->pStamps[u] == this->stamp)
+        continue;
+
+      this->pStamps[u] = this->stamp;
+      this->pCandidates[this->candidateCount++] = u;
+
+      // Slide it into the window
+      double score = MinHash_getJaccard(pGraph, v, u);
+      int j = count < k ? count++ : k;
+
+      for(; j > 0 && pScores[j - 1] < score; j--) {
+        if(j < k) {
+          pTop[j] = pTop[j - 1];
+          pScores[j] = pScores[j - 1];
+        }
+      }
+
+      if(j < k) {
+        pTop[j] = u;
+        pScores[j] = score;
+      }
+    }
+  }
+
+  return count;
+}
+
+/**
+ * Pairs up the nodes sharing a bucket in the bands within the given range, keeping those similar enough.
+ * A pair that shares several bands is only checked in the first one, by comparing the keys of the earlier bands.
+ *
+ * @param   { void * }  pArgs   The shared MinHashJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first band to pair up.
+ * @param   { int }     end     One past the last band to pair up.
+ */
+void _MinHash_pairBand(void *pArgs, int thread, int start, int end) {
+  MinHashJob *pJob = pArgs;
+  MinHash *this = pJob->pMinHash;
+
+  for(int band = start; band < end; band++) {
+    MinHashEntry *pEntries = this->pBands + (long) band * this->indexedCount;
+
+    // One bucket at a time
+    for(int first = 0, last; first < this->indexedCount; first = last) {
+      for(last = first + 1; last < this->indexedCount && pEntries[last].key == pEntries[first].key; last++);
+
+      for(int i = first; i < last; i++) {
+        for(int j = i + 1; j < last; j++) {
+          int a = pEntries[i].node;
+          int b = pEntries[j].node;
+          int bSeen = 0;
+
+          // Already met in an earlier band
+          for(int earlier = 0; earlier < band && !bSeen; earlier++)
+            bSeen = _MinHash_getKey(this, a, earlier) == _MinHash_getKey(this, b, earlier);
+
+          if(bSeen)
+            continue;
+
+          pJob->candidateCounts[thread]++;
+
+          // Check it for real
+          double jaccard = MinHash_getJaccard(pJob->pGraph, a, b);
+
+          if(jaccard < pJob->threshold)
+            continue;
+
+          // Grow if needed
+          if(pJob->pairCounts[thread] == pJob->pairLimits[thread]) {
+            pJob->pairLimits[thread] = pJob->pairLimits[thread] ? pJob->pairLimits[thread] * 2 : 64;
+            pJob->pPairs[thread] = realloc(pJob->pPairs[thread], pJob->pairLimits[thread] * sizeof(MinHashPair));
+          }
+
+          MinHashPair *pPair = &pJob->pPairs[thread][pJob->pairCounts[thread]++];
+          pPair->a = a;
+          pPair->b = b;
+          pPair->jaccard = jaccard;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Finds every pair of nodes whose friend lists are at least as similar as the threshold.
+ * Pairs below about 0.2 rarely share a band, so lower thresholds will miss many of them.
+ * The caller frees the returned pairs.
+ *
+ * @param   { MinHash * }       this              The signatures and their index.
+ * @param   { Graph * }         pGraph            The graph they were made for.
+ * @param   { double }          threshold         How similar a pair has to be.
+ * @param   { MinHashPair ** }  ppPairs           Where to put the pairs found.
+ * @param   { long * }          pCandidateCount   Where to put how many pairs were checked; may be NULL.
+ * @return  { long }                              How many pairs were found.
+ */
+long MinHash_getPairs(MinHash *this, Graph *pGraph, double threshold, MinHashPair **ppPairs, long *pCandidateCount) {
+  MinHashJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+  pJob->pMinHash = this;
+  pJob->threshold = threshold;
+
+  Thread_parallelFor(MINHASH_BANDS, 1, _MinHash_pairBand, pJob);
+
+  // Gather what every thread found
+  long total = 0;
+  long candidateCount = 0;
+
+  for(int t = 0; t < THREAD_MAX_COUNT; t++) {
+    total += pJob->pairCounts[t];
+    candidateCount += pJob->candidateCounts[t];
+  }
+
+  MinHashPair *pPairs = malloc((total + 1) * sizeof(MinHashPair));
+
+  // Threads that never ran have no buffer to copy from
+  for(long t = 0, offset = 0; t < THREAD_MAX_COUNT; t++) {
+    if(pJob->pairCounts[t])
+      memcpy(pPairs + offset, pJob->pPairs[t], pJob->pairCounts[t] * sizeof(MinHashPair));
+
+    offset += pJob->pairCounts[t];
+    free(pJob->pPairs[t]);
+  }
+
+  if(pCandidateCount != NULL)
+    *pCandidateCount = candidateCount;
+
+  free(pJob);
+  *ppPairs = pPairs;
+
+  return total;
+}
+
+/**
+ * Writes the signatures to a file.
+ * The index is quick to rebuild from them, so it isn't saved.
+ *
+ * @param   { MinHash * }   this      The signatures to save.
+ * @param   { char * }      filepath  Where to save them.
+ * @return  { int }                   Whether or not the signatures were saved.
+ */
+int MinHash_save(MinHash *this, char *filepath) {
+
+  // Open the file
+  FILE *pFile = fopen(filepath, "wb");
+
+  if(pFile == NULL)
+    return 0;
+
+  // The header, so we can tell if the file matches the graph later
+  int header[4] = { MINHASH_MAGIC, this->nodeCount, this->adjCount, MINHASH_SIZE };
+
+  fwrite(header, sizeof(int), 4, pFile);
+  fwrite(&this->checksum, sizeof(uint64_t), 1, pFile);
+  fwrite(this->pSignatures, sizeof(uint32_t), (long) this->nodeCount * MINHASH_SIZE, pFile);
+  fclose(pFile);
+
+  this->bSaved = 1;
+
+  return 1;
+}
+
+/**
+ * Reads signatures from a file and rebuilds their index.
+ * Returns NULL if the file doesn't exist or wasn't made for this graph.
+ *
+ * @param   { Graph * }     pGraph    The graph the signatures should match.
+ * @param   { char * }      filepath  Where to read them from.
+ * @return  { MinHash * }             The loaded signatures, or NULL.
+ */
+MinHash *MinHash_load(Graph *pGraph, char *filepath) {
+
+  // Open the file
+  FILE *pFile = fopen(filepath, "rb");
+
+  if(pFile == NULL)
+    return NULL;
+
+  // Check the header, down to the checksum so a file from another graph of the same size isn't taken
+  int header[4] = { 0 };
+  uint64_t checksum = 0;
+  int n = pGraph->nodeCount;
+
+  if(fread(header, sizeof(int), 4, pFile) != 4 || 
+    fread(&checksum, sizeof(uint64_t), 1, pFile) != 1 ||
+    header[0] != MINHASH_MAGIC || header[1] != n || header[2] != pGraph->adjCount || 
+    header[3] != MINHASH_SIZE || checksum != Graph_getChecksum(pGraph)) {
+    fclose(pFile);
+    return NULL;
+  }
+
+  // Read the contents
+  double start = Timer_now();
+  MinHash *this = _MinHash_init(_MinHash_alloc(), n, pGraph->adjCount);
+  long size = (long) n * MINHASH_SIZE;
+  this->checksum = checksum;
+  this->bSaved = 1;
+  int bComplete = fread(this->pSignatures, sizeof(uint32_t), size, pFile) == (size_t) size;
+
+  fclose(pFile);
+
+  // Truncated file
+  if(!bComplete) {
+    MinHash_kill(this);
+    return NULL;
+  }
+
+  _MinHash_build(this, pGraph);
+  this->seconds = Timer_now() - start;
+
+  return this;
+}
+
+#endif
@@ -0,0 +1,263 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 20:31:44
+ * @ Modified time: 2026-10-18 20:31:44
+ * @ Description:
+ *
+ * Runs many breadth-first traversals at once.
+ * Each node keeps one bit per source, so a single scan of an adjacency list advances every traversal.
+ */
+
+#ifndef MSBFS_C
+#define MSBFS_C
+
+#include "../graph.c"
+#include "../../utils/thread.c"
+#include "./bfs.c"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// How many 64-bit words make up the bits of a node
+// With 4 words, each batch runs 256 traversals and the lane operations map to 256-bit vector instructions
+#define MSBFS_WORDS 4
+#define MSBFS_WIDTH (MSBFS_WORDS * 64)
+
+/**
+ * The bits of a single node, one per traversal in the batch.
+ * The reduced alignment lets us keep these in plain malloc'd arrays.
+ */
+typedef uint64_t MSBFSLane __attribute__((vector_size(MSBFS_WORDS * sizeof(uint64_t)), aligned(sizeof(uint64_t))));
+
+/**
+ * Called whenever a traversal reaches a node.
+ * It receives the shared arguments, the position of the source within the batch list, the node, and its distance.
+ */
+typedef void (*MSBFSVisit)(void *pArgs, int source, int node, int distance);
+
+typedef struct MSBFSBatch MSBFSBatch;
+
+/**
+ * The state shared by the threads running the batches.
+ */
+struct MSBFSBatch {
+
+  // The graph to traverse
+  Graph *pGraph;
+
+  // The sources and what to do on each visit
+  int *pSources;
+  int sourceCount;
+  MSBFSVisit pVisit;
+  void *pArgs;
+
+  // The total work done, summed across threads
+  long edgeCount;
+};
+
+/**
+ * The msbfs interface.
+ */
+long _MSBFS_runBatch(Graph *pGraph, int *pSources, int sourceCount, int offset, MSBFSVisit pVisit, void *pArgs);
+void _MSBFS_runBatches(void *pArgs, int thread, int start, int end);
+void _MSBFS_saveDistance(void *pArgs, int source, int node, int distance);
+long MSBFS_run(Graph *pGraph, int *pSources, int sourceCount, MSBFSVisit pVisit, void *pArgs);
+long MSBFS_distances(Graph *pGraph, int *pSources, int sourceCount, int *pDistances);
+
+/**
+ * Checks whether none of the bits in a lane are set.
+ *
+ * @param   { MSBFSLane * }   pLane   The lane to check.
+ * @return  { int }                   Whether or not the lane is empty.
+*/
+static inline int _MSBFS_isEmpty(MSBFSLane *pLane) {
+  uint64_t any = 0;
+
+  // Or all the words together
+  for(int i = 0; i < MSBFS_WORDS; i++)
+    any |= (*pLane)[i];
+
+  return !any;
+}
+
+/**
+ * Runs a single batch of at most MSBFS_WIDTH traversals.
+ * Bit i of each lane belongs to the traversal from pSources[i].
+ *
+ * @param   { Graph * }     pGraph        The graph to traverse.
+ * @param   { int * }       pSources      The sources of this batch.
+ * @param   { int }         sourceCount   How many sources there are; at most MSBFS_WIDTH.
+ * @param   { int }         offset        The position of this batch within the full source list.
+ * @param   { MSBFSVisit }  pVisit        What to do on each visit.
+ * @param   { void * }      pArgs         The arguments passed to pVisit.
+ * @return  { long }                      How many adjacencies were scanned.
+*/
+long _MSBFS_runBatch(Graph *pGraph, int *pSources, int sourceCount, int offset, MSBFSVisit pVisit, void *pArgs) {
+
+  // The bits of each node
+  int n = pGraph->nodeCount;
+  MSBFSLane *pSeen = calloc(n, sizeof(MSBFSLane));
+  MSBFSLane *pVisitNow = calloc(n, sizeof(MSBFSLane));
+  MSBFSLane *pVisitNext = calloc(n, sizeof(MSBFSLane));
+  MSBFSLane empty = { 0 };
+  long edgeCount = 0;
+
+  // Seed each traversal
+  for(int i = 0; i < sourceCount; i++) {
+    int s = pSources[i];
+
+    pSeen[s][i >> 6] |= 1ULL << (i & 63);
+    pVisitNow[s][i >> 6] |= 1ULL << (i & 63);
+    pVisit(pArgs, offset + i, s, 0);
+  }
+
+  // One level at a time, for every traversal at once
+  for(int level = 1, bActive = 1; bActive; level++) {
+
+    // Push the frontier bits of each node to its neighbors
+    for(int u = 0; u < n; u++) {
+
+      // This node isn't in any frontier
+      if(_MSBFS_isEmpty(&pVisitNow[u]))
+        continue;
+
+      // Share the scan across all the traversals that reached u
+      MSBFSLane bits = pVisitNow[u];
+      int *pAdjs = Graph_getAdjs(pGraph, u);
+      int degree = Graph_getDegree(pGraph, u);
+
+      edgeCount += degree;
+
+      for(int j = 0; j < degree; j++)
+        pVisitNext[pAdjs[j]] |= bits;
+    }
+
+    // Keep only the bits that are new to each node
+    bActive = 0;
+    for(int v = 0; v < n; v++) {
+
+      // Nothing arrived here
+      if(_MSBFS_isEmpty(&pVisitNext[v]))
+        continue;
+
+      // Drop the traversals that already saw v
+      MSBFSLane fresh = pVisitNext[v] & ~pSeen[v];
+      pVisitNext[v] = fresh;
+      pSeen[v] |= fresh;
+
+      // Report each of them
+      for(int w = 0; w < MSBFS_WORDS; w++) {
+        for(uint64_t bits = fresh[w]; bits; bits &= bits - 1) {
+          pVisit(pArgs, offset + (w << 6) + __builtin_ctzll(bits), v, level);
+          bActive = 1;
+        }
+      }
+    }
+
+    // The next frontier becomes the current one
+    MSBFSLane *pTemp = pVisitNow;
+    pVisitNow = pVisitNext;
+    pVisitNext = pTemp;
+
+    // Clear the old frontier
+    for(int v = 0; v < n; v++)
+      pVisitNext[v] = empty;
+  }
+
+  // Garbage collection
+  free(pSeen);
+  free(pVisitNow);
+  free(pVisitNext);
+
+  return edgeCount;
+}
+
+/**
+ * Runs the batches within the given range.
+ *
+ * @param   { void * }  pArgs   The shared MSBFSBatch.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first batch to run.
+ * @param   { int }     end     One past the last batch to run.
+*/
+void _MSBFS_runBatches(void *pArgs, int thread, int start, int end) {
+  MSBFSBatch *pBatch = pArgs;
+
+  // Run each batch
+  for(int b = start; b < end; b++) {
+
+    // Where this batch starts and how big it is
+    int offset = b * MSBFS_WIDTH;
+    int count = pBatch->sourceCount - offset;
+
+    if(count > MSBFS_WIDTH)
+      count = MSBFS_WIDTH;
+
+    // Run it and count the work
+    long edgeCount = _MSBFS_runBatch(pBatch->pGraph, pBatch->pSources + offset, count, offset, pBatch->pVisit, pBatch->pArgs);
+    __atomic_fetch_add(&pBatch->edgeCount, edgeCount, __ATOMIC_RELAXED);
+  }
+}
+
+/**
+ * Runs a traversal from each of the given sources.
+ * Sources are grouped into batches of MSBFS_WIDTH, and the batches are spread across threads.
+ * Since batches run concurrently, pVisit must be safe to call from several threads as long as the sources differ.
+ *
+ * @param   { Graph * }     pGraph        The graph to traverse.
+ * @param   { int * }       pSources      The sources of the traversals.
+ * @param   { int }         sourceCount   How many sources there are.
+ * @param   { MSBFSVisit }  pVisit        What to do on each visit.
+ * @param   { void * }      pArgs         The arguments passed to pVisit.
+ * @return  { long }                      How many adjacencies were scanned in total.
+*/
+long MSBFS_run(Graph *pGraph, int *pSources, int sourceCount, MSBFSVisit pVisit, void *pArgs) {
+
+  // The shared state
+  MSBFSBatch batch = { pGraph, pSources, sourceCount, pVisit, pArgs, 0 };
+  int batchCount = (sourceCount + MSBFS_WIDTH - 1) / MSBFS_WIDTH;
+
+  // One batch per claim
+  Thread_parallelFor(batchCount, 1, _MSBFS_runBatches, &batch);
+
+  return batch.edgeCount;
+}
+
+/**
+ * Saves a visit into a row-major distance table.
+ *
+ * @param   { void * }  pArgs     The graph and the distance table.
+ * @param   { int }     source    The position of the source.
+ * @param   { int }     node      The node reached.
+ * @param   { int }     distance  Its distance from the source.
+*/
+void _MSBFS_saveDistance(void *pArgs, int source, int node, int distance) {
+  Graph *pGraph = ((void **) pArgs)[0];
+  int *pDistances = ((void **) pArgs)[1];
+
+  pDistances[(long) source * pGraph->nodeCount + node] = distance;
+}
+
+/**
+ * Computes the distance from each of the given sources to every node.
+ * Row i of the table holds the distances from pSources[i]; unreachable nodes are given BFS_UNVISITED.
+ *
+ * @param   { Graph * }   pGraph        The graph to traverse.
+ * @param   { int * }     pSources      The sources of the traversals.
+ * @param   { int }       sourceCount   How many sources there are.
+ * @param   { int * }     pDistances    Where to write the table; must hold sourceCount * nodeCount entries.
+ * @return  { long }                    How many adjacencies were scanned in total.
+*/
+long MSBFS_distances(Graph *pGraph, int *pSources, int sourceCount, int *pDistances) {
+
+  // Nothing is reachable until visited
+  memset(pDistances, 0xff, (long) sourceCount * pGraph->nodeCount * sizeof(int));
+
+  // Fill in the table
+  void *pArgs[2] = { pGraph, pDistances };
+
+  return MSBFS_run(pGraph, pSources, sourceCount, _MSBFS_saveDistance, pArgs);
+}
+
+#endif
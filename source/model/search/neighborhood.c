@@ -0,0 +1,415 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 23:05:37
+ * @ Modified time: 2026-10-19 08:26:33
+ * @ Description:
+ *
+ * Lists everyone within a few hops of a node, one hop at a time.
+ * Each hop comes out sorted by index, so callers can stream it without collecting anything.
+ */
+
+#ifndef NEIGHBORHOOD_C
+#define NEIGHBORHOOD_C
+
+#include "../graph.c"
+#include "../structs/bitset.c"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// No limit on the number of nodes listed
+#define NEIGHBORHOOD_UNLIMITED (-1)
+
+/**
+ * Called for every node reached, in order of hops and then of index.
+ * It receives the shared arguments, the node, and how many hops away it is.
+ */
+typedef void (*NeighborhoodVisit)(void *pArgs, int node, int hops);
+
+typedef struct Neighborhood Neighborhood;
+typedef struct NeighborhoodPool NeighborhoodPool;
+
+/**
+ * The reusable state of a neighborhood query.
+ * A single instance must not be shared across threads; take one from a pool instead.
+ */
+struct Neighborhood {
+
+  // The graph to explore
+  Graph *pGraph;
+
+  // The nodes reached so far, and the hop being built
+  Bitset *pSeen;
+  Bitset *pNext;
+
+  // The nodes reached, hop by hop; each hop is sorted
+  int *pNodes;
+  int nodeCount;
+
+  // How many nodes each hop holds; hop 0 is the node itself
+  int *pLevelCounts;
+  int levelCount;
+
+  // Whether the last query stopped at its limit, and the work it took
+  int bTruncated;
+  long edgeCount;
+
+  // The next free query in the pool
+  Neighborhood *pNextFree;
+};
+
+/**
+ * A thread-safe stack of idle neighborhood queries.
+ */
+struct NeighborhoodPool {
+
+  // The graph the queries are made for
+  Graph *pGraph;
+
+  // The idle queries
+  Neighborhood *pFree;
+
+  // Guards the idle list
+  pthread_mutex_t lock;
+};
+
+/**
+ * The neighborhood interface.
+ */
+Neighborhood *_Neighborhood_alloc();
+Neighborhood *_Neighborhood_init(Neighborhood *this, Graph *pGraph);
+Neighborhood *Neighborhood_new(Graph *pGraph);
+void Neighborhood_kill(Neighborhood *this);
+
+int _Neighborhood_expand(Neighborhood *this, int start, int end);
+void _Neighborhood_reset(Neighborhood *this);
+int Neighborhood_run(Neighborhood *this, int source, int hops, int limit, NeighborhoodVisit pVisit, void *pArgs);
+
+NeighborhoodPool *_NeighborhoodPool_alloc();
+NeighborhoodPool *_NeighborhoodPool_init(NeighborhoodPool *this, Graph *pGraph);
+NeighborhoodPool *NeighborhoodPool_new(Graph *pGraph);
+void NeighborhoodPool_kill(NeighborhoodPool *this);
+
+Neighborhood *NeighborhoodPool_acquire(NeighborhoodPool *this);
+void NeighborhoodPool_release(NeighborhoodPool *this, Neighborhood *pNeighborhood);
+
+/**
+ * Allocates memory for a neighborhood query.
+ *
+ * @return  { Neighborhood * }  The memory for the new query.
+ */
+Neighborhood *_Neighborhood_alloc() {
+  Neighborhood *pNeighborhood = calloc(1, sizeof(*pNeighborhood));
+
+  return pNeighborhood;
+}
+
+/**
+ * Initializes a neighborhood query against the given graph.
+ *
+ * @param   { Neighborhood * }  this    The query to initialize.
+ * @param   { Graph * }         pGraph  The graph to explore.
+ * @return  { Neighborhood * }          The initialized query.
+ */
+Neighborhood *_Neighborhood_init(Neighborhood *this, Graph *pGraph) {
+
+  // Size everything for the graph
+  int n = pGraph->nodeCount;
+  this->pGraph = pGraph;
+  this->pSeen = Bitset_new(n);
+  this->pNext = Bitset_new(n);
+  this->pNodes = malloc((n + 1) * sizeof(int));
+  this->pLevelCounts = calloc(n + 1, sizeof(int));
+  this->nodeCount = 0;
+  this->levelCount = 0;
+  this->bTruncated = 0;
+  this->edgeCount = 0;
+  this->pNextFree = NULL;
+
+  return this;
+}
+
+/**
+ * Creates a new neighborhood query against the given graph.
+ *
+ * @param   { Graph * }         pGraph  The graph to explore.
+ * @return  { Neighborhood * }          The new query.
+ */
+Neighborhood *Neighborhood_new(Graph *pGraph) {
+  return _Neighborhood_init(_Neighborhood_alloc(), pGraph);
+}
+
+/**
+ * Frees the memory associated with a neighborhood query.
+ *
+ * @param   { Neighborhood * }  this  The query to free.
+ */
+void Neighborhood_kill(Neighborhood *this) {
+  Bitset_kill(this->pSeen);
+  Bitset_kill(this->pNext);
+  free(this->pNodes);
+  free(this->pLevelCounts);
+  free(this);
+}
+
+/**
+ * Appends the next hop, given the range of pNodes holding the current one.
+ * The neighbor lists are sorted, so a single node's unseen neighbors are copied over as they are.
+ * Otherwise the lists are merged through a bitset, which is drained in index order.
+ *
+ * @param   { Neighborhood * }  this    The query to expand.
+ * @param   { int }             start   The first node of the current hop in pNodes.
+ * @param   { int }             end     One past the last node of the current hop.
+ * @return  { int }                     How many nodes the next hop holds.
+ */
+int _Neighborhood_expand(Neighborhood *this, int start, int end) {
+  Graph *pGraph = this->pGraph;
+  int count = this->nodeCount;
+
+  // A single node; its list is already sorted
+  if(end - start == 1) {
+    int u = this->pNodes[start];
+    int *pAdjs = Graph_getAdjs(pGraph, u);
+    int degree = Graph_getDegree(pGraph, u);
+
+    this->edgeCount += degree;
+
+    for(int j = 0; j < degree; j++) {
+      int v = pAdjs[j];
+
+      // Already reached
+      if(Bitset_get(this->pSeen, v))
+        continue;
+
+      Bitset_set(this->pSeen, v);
+      this->pNodes[count++] = v;
+    }
+
+    return count - this->nodeCount;
+  }
+
+  // Only the words between these were touched
+  int firstWord = this->pNext->wordCount;
+  int lastWord = -1;
+
+  // Union the lists of the whole hop
+  for(int i = start; i < end; i++) {
+    int u = this->pNodes[i];
+    int *pAdjs = Graph_getAdjs(pGraph, u);
+    int degree = Graph_getDegree(pGraph, u);
+
+    this->edgeCount += degree;
+
+    for(int j = 0; j < degree; j++) {
+      int v = pAdjs[j];
+
+      // Already reached
+      if(Bitset_get(this->pSeen, v))
+        continue;
+
+      Bitset_set(this->pSeen, v);
+      Bitset_set(this->pNext, v);
+
+      // Widen the touched range
+      if((v >> 6) < firstWord)
+        firstWord = v >> 6;
+      if((v >> 6) > lastWord)
+        lastWord = v >> 6;
+    }
+  }
+
+  // Drain the bits in order, clearing them on the way
+  for(int w = firstWord; w <= lastWord; w++) {
+    uint64_t bits = this->pNext->words[w];
+    this->pNext->words[w] = 0;
+
+    for(; bits; bits &= bits - 1)
+      this->pNodes[count++] = (w << 6) + __builtin_ctzll(bits);
+  }
+
+  return count - this->nodeCount;
+}
+
+/**
+ * Unmarks the nodes reached by the last query.
+ * This only touches what was reached, so small neighborhoods stay cheap on big graphs.
+ *
+ * @param   { Neighborhood * }  this  The query to reset.
+ */
+void _Neighborhood_reset(Neighborhood *this) {
+
+  // Unmark each reached node
+  for(int i = 0; i < this->nodeCount; i++)
+    Bitset_unset(this->pSeen, this->pNodes[i]);
+
+  this->nodeCount = 0;
+  this->levelCount = 0;
+  this->bTruncated = 0;
+  this->edgeCount = 0;
+}
+
+/**
+ * Visits everyone within the given number of hops of a node, closest first.
+ * Nodes at the same distance are visited in order of index.
+ * Afterwards, pLevelCounts holds how many nodes were found at each hop, up to levelCount.
+ *
+ * @param   { Neighborhood * }    this    The query to run.
+ * @param   { int }               source  The node to start from.
+ * @param   { int }               hops    How many hops out to go.
+ * @param   { int }               limit   The most nodes to visit, or NEIGHBORHOOD_UNLIMITED.
+ * @param   { NeighborhoodVisit } pVisit  What to do on each visit; may be NULL.
+ * @param   { void * }            pArgs   The arguments passed to pVisit.
+ * @return  { int }                       How many nodes were visited, not counting the source.
+ */
+int Neighborhood_run(Neighborhood *this, int source, int hops, int limit, NeighborhoodVisit pVisit, void *pArgs) {
+
+  // Forget the last query
+  _Neighborhood_reset(this);
+
+  // Start with the node itself
+  Bitset_set(this->pSeen, source);
+  this->pNodes[this->nodeCount++] = source;
+  this->pLevelCounts[this->levelCount++] = 1;
+
+  // One hop at a time
+  for(int level = 1, start = 0; level <= hops; level++) {
+    int end = this->nodeCount;
+    int count = _Neighborhood_expand(this, start, end);
+
+    // Cut the hop short at the limit
+    // The source isn't counted against it
+    if(limit != NEIGHBORHOOD_UNLIMITED && end - 1 + count > limit) {
+      int kept = limit - (end - 1);
+
+      // Unmark the ones we're dropping
+      for(int i = end + kept; i < end + count; i++)
+        Bitset_unset(this->pSeen, this->pNodes[i]);
+
+      this->bTruncated = 1;
+      count = kept;
+    }
+
+    // Nothing more to reach, or nothing more allowed
+    if(!count)
+      break;
+
+    // Visit the hop
+    if(pVisit != NULL)
+      for(int i = end; i < end + count; i++)
+        pVisit(pArgs, this->pNodes[i], level);
+
+    // Save the hop
+    this->pLevelCounts[this->levelCount++] = count;
+    this->nodeCount = end + count;
+    start = end;
+
+    // Nothing more is allowed
+    if(this->bTruncated)
+      break;
+  }
+
+  return this->nodeCount - 1;
+}
+
+/**
+ * Allocates memory for a pool.
+ *
+ * @return  { NeighborhoodPool * }  The memory for the new pool.
+ */
+NeighborhoodPool *_NeighborhoodPool_alloc() {
+  NeighborhoodPool *pPool = calloc(1, sizeof(*pPool));
+
+  return pPool;
+}
+
+/**
+ * Initializes an empty pool.
+ *
+ * @param   { NeighborhoodPool * }  this    The pool to initialize.
+ * @param   { Graph * }             pGraph  The graph the queries are made for.
+ * @return  { NeighborhoodPool * }          The initialized pool.
+ */
+NeighborhoodPool *_NeighborhoodPool_init(NeighborhoodPool *this, Graph *pGraph) {
+
+  // No idle queries yet
+  this->pGraph = pGraph;
+  this->pFree = NULL;
+
+  pthread_mutex_init(&this->lock, NULL);
+
+  return this;
+}
+
+/**
+ * Creates a new empty pool.
+ *
+ * @param   { Graph * }             pGraph  The graph the queries are made for.
+ * @return  { NeighborhoodPool * }          The new pool.
+ */
+NeighborhoodPool *NeighborhoodPool_new(Graph *pGraph) {
+  return _NeighborhoodPool_init(_NeighborhoodPool_alloc(), pGraph);
+}
+
+/**
+ * Frees the pool and all of its idle queries.
+ * Queries that were never released are not freed.
+ *
+ * @param   { NeighborhoodPool * }  this  The pool to free.
+ */
+void NeighborhoodPool_kill(NeighborhoodPool *this) {
+
+  // Free the idle queries
+  while(this->pFree != NULL) {
+    Neighborhood *pNeighborhood = this->pFree;
+    this->pFree = pNeighborhood->pNextFree;
+    Neighborhood_kill(pNeighborhood);
+  }
+
+  // Free the pool itself
+  pthread_mutex_destroy(&this->lock);
+  free(this);
+}
+
+/**
+ * Grabs an idle query, creating one if none are left.
+ * Safe to call from several threads.
+ *
+ * @param   { NeighborhoodPool * }  this  The pool to take from.
+ * @return  { Neighborhood * }            A query that the caller now owns.
+ */
+Neighborhood *NeighborhoodPool_acquire(NeighborhoodPool *this) {
+
+  // Pop an idle query
+  pthread_mutex_lock(&this->lock);
+  Neighborhood *pNeighborhood = this->pFree;
+
+  if(pNeighborhood != NULL)
+    this->pFree = pNeighborhood->pNextFree;
+
+  pthread_mutex_unlock(&this->lock);
+
+  // Make a new one outside the lock
+  if(pNeighborhood == NULL)
+    pNeighborhood = Neighborhood_new(this->pGraph);
+
+  return pNeighborhood;
+}
+
+/**
+ * Returns a query to the pool so its buffers can be reused.
+ * Safe to call from several threads.
+ *
+ * @param   { NeighborhoodPool * }  this            The pool to return to.
+ * @param   { Neighborhood * }      pNeighborhood   The query to return.
+ */
+void NeighborhoodPool_release(NeighborhoodPool *this, Neighborhood *pNeighborhood) {
+
+  // Push it back
+  pthread_mutex_lock(&this->lock);
+  pNeighborhood->pNextFree = this->pFree;
+  this->pFree = pNeighborhood;
+  pthread_mutex_unlock(&this->lock);
+}
+
+#endif
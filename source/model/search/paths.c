@@ -0,0 +1,517 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 23:41:12
+ * @ Modified time: 2026-10-19 10:16:52
+ * @ Description:
+ *
+ * Counts the shortest paths between two nodes and lays out the graph they form.
+ * Paths are never listed one by one, since there can be exponentially many of them.
+ */
+
+#ifndef PATHS_C
+#define PATHS_C
+
+#include "../graph.c"
+#include "./bfs.c"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+/**
+ * Called for every edge of the shortest-path graph.
+ * It receives the shared arguments, and the two ends of the edge, the one closer to the source first.
+ */
+typedef void (*PathsEdge)(void *pArgs, int from, int to);
+
+typedef struct Paths Paths;
+typedef struct PathsPool PathsPool;
+
+/**
+ * The shortest paths between a source and a target.
+ * A node is on some shortest path exactly when it is reached by both passes.
+ * A single instance must not be shared across threads; take one from a pool instead.
+ */
+struct Paths {
+
+  // The graph to search
+  Graph *pGraph;
+
+  // The ends of the last query, and how far apart they are
+  int source;
+  int target;
+  int distance;
+
+  // The distance from the source, and how many shortest paths lead there from the source
+  int *pDistances;
+  double *pCountsFrom;
+
+  // How many shortest paths lead from each node to the target; 0 off the shortest-path graph
+  double *pCountsTo;
+
+  // The nodes reached from the source, in the order they were reached
+  int *pReached;
+  int reachedCount;
+
+  // The nodes of the shortest-path graph, from the target back to the source
+  int *pNodes;
+  int nodeCount;
+
+  // The state of the random walks used for sampling
+  uint64_t seed;
+
+  // The next free query in the pool
+  Paths *pNextFree;
+};
+
+/**
+ * A thread-safe stack of idle paths queries.
+ */
+struct PathsPool {
+
+  // The graph the queries are made for
+  Graph *pGraph;
+
+  // The idle queries
+  Paths *pFree;
+
+  // Guards the idle list
+  pthread_mutex_t lock;
+};
+
+/**
+ * The paths interface.
+ */
+Paths *_Paths_alloc();
+Paths *_Paths_init(Paths *this, Graph *pGraph);
+Paths *Paths_new(Graph *pGraph);
+void Paths_kill(Paths *this);
+
+PathsPool *_PathsPool_alloc();
+PathsPool *_PathsPool_init(PathsPool *this, Graph *pGraph);
+PathsPool *PathsPool_new(Graph *pGraph);
+void PathsPool_kill(PathsPool *this);
+
+Paths *PathsPool_acquire(PathsPool *this);
+void PathsPool_release(PathsPool *this, Paths *pPaths);
+
+void _Paths_reset(Paths *this);
+void _Paths_forward(Paths *this);
+void _Paths_backward(Paths *this);
+double Paths_count(Paths *this, int source, int target);
+double Paths_getFraction(Paths *this, int node);
+long Paths_streamGraph(Paths *this, PathsEdge pEdge, void *pArgs);
+int Paths_sample(Paths *this, int *pPath);
+
+/**
+ * Allocates memory for a paths query.
+ *
+ * @return  { Paths * }   The memory for the new query.
+ */
+Paths *_Paths_alloc() {
+  Paths *pPaths = calloc(1, sizeof(*pPaths));
+
+  return pPaths;
+}
+
+/**
+ * Initializes a paths query against the given graph.
+ *
+ * @param   { Paths * }   this    The query to initialize.
+ * @param   { Graph * }   pGraph  The graph to search.
+ * @return  { Paths * }           The initialized query.
+ */
+Paths *_Paths_init(Paths *this, Graph *pGraph) {
+
+  // Size everything for the graph
+  int n = pGraph->nodeCount;
+  this->pGraph = pGraph;
+  this->pDistances = malloc(n * sizeof(int));
+  this->pCountsFrom = calloc(n, sizeof(double));
+  this->pCountsTo = calloc(n, sizeof(double));
+  this->pReached = malloc(n * sizeof(int));
+  this->pNodes = malloc(n * sizeof(int));
+  this->reachedCount = 0;
+  this->nodeCount = 0;
+  this->distance = BFS_UNVISITED;
+
+  // Nothing is reached yet
+  for(int i = 0; i < n; i++)
+    this->pDistances[i] = BFS_UNVISITED;
+
+  // Any odd constant will do
+  this->seed = 0x9e3779b97f4a7c15ULL;
+  this->pNextFree = NULL;
+
+  return this;
+}
+
+/**
+ * Creates a new paths query against the given graph.
+ *
+ * @param   { Graph * }   pGraph  The graph to search.
+ * @return  { Paths * }           The new query.
+ */
+Paths *Paths_new(Graph *pGraph) {
+  return _Paths_init(_Paths_alloc(), pGraph);
+}
+
+/**
+ * Frees the memory associated with a paths query.
+ *
+ * @param   { Paths * }   this  The query to free.
+ */
+void Paths_kill(Paths *this) {
+  free(this->pDistances);
+  free(this->pCountsFrom);
+  free(this->pCountsTo);
+  free(this->pReached);
+  free(this->pNodes);
+  free(this);
+}
+
+/**
+ * Forgets the last query, touching only what it reached.
+ *
+ * @param   { Paths * }   this  The query to reset.
+ */
+void _Paths_reset(Paths *this) {
+
+  // Undo the forward pass
+  for(int i = 0; i < this->reachedCount; i++) {
+    int u = this->pReached[i];
+    this->pDistances[u] = BFS_UNVISITED;
+    this->pCountsFrom[u] = 0;
+    this->pCountsTo[u] = 0;
+  }
+
+  this->reachedCount = 0;
+  this->nodeCount = 0;
+  this->distance = BFS_UNVISITED;
+}
+
+/**
+ * Runs a breadth-first search from the source, counting the shortest paths to each node.
+ * Each node's count is the sum of the counts of its neighbors one level closer.
+ * The search stops once the level holding the target is done.
+ *
+ * @param   { Paths * }   this  The query to run.
+ */
+void _Paths_forward(Paths *this) {
+  Graph *pGraph = this->pGraph;
+
+  // Seed the source
+  this->pDistances[this->source] = 0;
+  this->pCountsFrom[this->source] = 1;
+  this->pReached[this->reachedCount++] = this->source;
+
+  // Trivial path
+  if(this->source == this->target)
+    this->distance = 0;
+
+  // The reached list doubles as the queue
+  for(int head = 0; head < this->reachedCount; head++) {
+    int u = this->pReached[head];
+    int *pAdjs = Graph_getAdjs(pGraph, u);
+    int degree = Graph_getDegree(pGraph, u);
+
+    // Nothing past the target's level is on a shortest path
+    if(this->distance != BFS_UNVISITED && this->pDistances[u] >= this->distance)
+      break;
+
+    // Pass the counts on to the next level
+    for(int j = 0; j < degree; j++) {
+      int v = pAdjs[j];
+
+      // First time here
+      if(this->pDistances[v] == BFS_UNVISITED) {
+        this->pDistances[v] = this->pDistances[u] + 1;
+        this->pReached[this->reachedCount++] = v;
+
+        // Found the target
+        if(v == this->target)
+          this->distance = this->pDistances[v];
+      }
+
+      // Another way in at the same level
+      if(this->pDistances[v] == this->pDistances[u] + 1)
+        this->pCountsFrom[v] += this->pCountsFrom[u];
+    }
+  }
+}
+
+/**
+ * Walks back from the target, keeping only the neighbors one level closer to the source.
+ * Those are exactly the nodes on some shortest path, and each gets the number of shortest paths it has to the target.
+ * Nodes are taken in order of decreasing distance, so every count is complete before it is passed on.
+ *
+ * @param   { Paths * }   this  The query to run.
+ */
+void _Paths_backward(Paths *this) {
+  Graph *pGraph = this->pGraph;
+
+  // Seed the target
+  this->pCountsTo[this->target] = 1;
+  this->pNodes[this->nodeCount++] = this->target;
+
+  // The node list doubles as the queue
+  for(int head = 0; head < this->nodeCount; head++) {
+    int v = this->pNodes[head];
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+
+    // Pass the counts back to the previous level
+    for(int j = 0; j < degree; j++) {
+      int u = pAdjs[j];
+
+      // Not one level closer to the source
+      if(this->pDistances[u] == BFS_UNVISITED || this->pDistances[u] != this->pDistances[v] - 1)
+        continue;
+
+      // First time here
+      if(this->pCountsTo[u] == 0)
+        this->pNodes[this->nodeCount++] = u;
+
+      this->pCountsTo[u] += this->pCountsTo[v];
+    }
+  }
+}
+
+/**
+ * Counts the shortest paths between two nodes, using one pass from each end.
+ * Counts are kept as doubles, since they can grow exponentially; they are exact up to 2^53.
+ * Afterwards, the other functions read the shortest-path graph of these two nodes.
+ *
+ * @param   { Paths * }   this    The query to run.
+ * @param   { int }       source  The index of the source node.
+ * @param   { int }       target  The index of the target node.
+ * @return  { double }            The number of shortest paths, or 0 if there are none.
+ */
+double Paths_count(Paths *this, int source, int target) {
+
+  // Forget the last query
+  _Paths_reset(this);
+  this->source = source;
+  this->target = target;
+
+  // Count from the source
+  _Paths_forward(this);
+
+  // Unreachable
+  if(this->pDistances[target] == BFS_UNVISITED)
+    return 0;
+
+  // Count back from the target
+  this->distance = this->pDistances[target];
+  _Paths_backward(this);
+
+  return this->pCountsFrom[target];
+}
+
+/**
+ * Returns the fraction of the shortest paths of the last query that pass through a node.
+ *
+ * @param   { Paths * }   this  The query to read.
+ * @param   { int }       node  The node to check.
+ * @return  { double }          The fraction of the paths through it.
+ */
+double Paths_getFraction(Paths *this, int node) {
+
+  // No paths at all
+  if(this->distance == BFS_UNVISITED)
+    return 0;
+
+  return this->pCountsFrom[node] * this->pCountsTo[node] / this->pCountsFrom[this->target];
+}
+
+/**
+ * Sends every edge of the shortest-path graph of the last query to a callback.
+ * Edges come out from the target's end back to the source's, without building the graph.
+ *
+ * @param   { Paths * }     this    The query to read.
+ * @param   { PathsEdge }   pEdge   What to do with each edge.
+ * @param   { void * }      pArgs   The arguments passed to pEdge.
+ * @return  { long }                How many edges there are.
+ */
+long Paths_streamGraph(Paths *this, PathsEdge pEdge, void *pArgs) {
+  Graph *pGraph = this->pGraph;
+  long edgeCount = 0;
+
+  // The edges into each node come from its neighbors on the graph one level closer
+  for(int i = 0; i < this->nodeCount; i++) {
+    int v = this->pNodes[i];
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+
+    for(int j = 0; j < degree; j++) {
+      int u = pAdjs[j];
+
+      // Not an edge of the graph
+      if(this->pCountsTo[u] == 0 || this->pDistances[u] != this->pDistances[v] - 1)
+        continue;
+
+      pEdge(pArgs, u, v);
+      edgeCount++;
+    }
+  }
+
+  return edgeCount;
+}
+
+/**
+ * Picks one of the shortest paths of the last query, each with the same chance.
+ * Walking back from the target, each step goes to a predecessor with odds proportional to its count from the source.
+ * The path is written from source to target.
+ *
+ * @param   { Paths * }   this    The query to read.
+ * @param   { int * }     pPath   Where to write the path.
+ * @return  { int }               The number of nodes in the path, or 0 if there are no paths.
+ */
+int Paths_sample(Paths *this, int *pPath) {
+  Graph *pGraph = this->pGraph;
+
+  // No paths at all
+  if(this->distance == BFS_UNVISITED)
+    return 0;
+
+  // The path is filled in from the back
+  int length = this->distance + 1;
+  int v = this->target;
+  pPath[length - 1] = v;
+
+  // Step back one level at a time
+  for(int i = length - 2; i >= 0; i--) {
+
+    // Advance the generator (xorshift), then pick a point among the ways in
+    this->seed ^= this->seed << 13;
+    this->seed ^= this->seed >> 7;
+    this->seed ^= this->seed << 17;
+    double pick = (this->seed >> 11) * (1.0 / 9007199254740992.0) * this->pCountsFrom[v];
+
+    // Find the predecessor that point falls on
+    int *pAdjs = Graph_getAdjs(pGraph, v);
+    int degree = Graph_getDegree(pGraph, v);
+    int next = BFS_UNVISITED;
+
+    for(int j = 0; j < degree; j++) {
+      int u = pAdjs[j];
+
+      // Not a predecessor
+      if(this->pCountsTo[u] == 0 || this->pDistances[u] != this->pDistances[v] - 1)
+        continue;
+
+      // Keep the last one in case of rounding
+      next = u;
+      pick -= this->pCountsFrom[u];
+
+      if(pick < 0)
+        break;
+    }
+
+    pPath[i] = v = next;
+  }
+
+  return length;
+}
+
+/**
+ * Allocates memory for a pool.
+ *
+ * @return  { PathsPool * }          The memory for the new pool.
+ */
+PathsPool *_PathsPool_alloc() {
+  PathsPool *pPool = calloc(1, sizeof(*pPool));
+
+  return pPool;
+}
+
+/**
+ * Initializes an empty pool.
+ *
+ * @param   { PathsPool * }  this    The pool to initialize.
+ * @param   { Graph * }      pGraph  The graph the queries are made for.
+ * @return  { PathsPool * }          The initialized pool.
+ */
+PathsPool *_PathsPool_init(PathsPool *this, Graph *pGraph) {
+
+  // No idle queries yet
+  this->pGraph = pGraph;
+  this->pFree = NULL;
+
+  pthread_mutex_init(&this->lock, NULL);
+
+  return this;
+}
+
+/**
+ * Creates a new empty pool.
+ *
+ * @param   { Graph * }      pGraph  The graph the queries are made for.
+ * @return  { PathsPool * }          The new pool.
+ */
+PathsPool *PathsPool_new(Graph *pGraph) {
+  return _PathsPool_init(_PathsPool_alloc(), pGraph);
+}
+
+/**
+ * Frees the pool and all of its idle queries.
+ * Queries that were never released are not freed.
+ *
+ * @param   { PathsPool * }  this    The pool to free.
+ */
+void PathsPool_kill(PathsPool *this) {
+
+  // Free the idle queries
+  while(this->pFree != NULL) {
+    Paths *pPaths = this->pFree;
+    this->pFree = pPaths->pNextFree;
+    Paths_kill(pPaths);
+  }
+
+  // Free the pool itself
+  pthread_mutex_destroy(&this->lock);
+  free(this);
+}
+
+/**
+ * Grabs an idle query, creating one if none are left.
+ * Safe to call from several threads.
+ *
+ * @param   { PathsPool * }  this    The pool to take from.
+ * @return  { Paths * }              A query that the caller now owns.
+ */
+Paths *PathsPool_acquire(PathsPool *this) {
+
+  // Pop an idle query
+  pthread_mutex_lock(&this->lock);
+  Paths *pPaths = this->pFree;
+
+  if(pPaths != NULL)
+    this->pFree = pPaths->pNextFree;
+
+  pthread_mutex_unlock(&this->lock);
+
+  // Make a new one outside the lock
+  if(pPaths == NULL)
+    pPaths = Paths_new(this->pGraph);
+
+  return pPaths;
+}
+
+/**
+ * Returns a query to the pool so its buffers can be reused.
+ * Safe to call from several threads.
+ *
+ * @param   { PathsPool * }  this    The pool to return to.
+ * @param   { Paths * }      pPaths  The query to return.
+ */
+void PathsPool_release(PathsPool *this, Paths *pPaths) {
+
+  // Push it back
+  pthread_mutex_lock(&this->lock);
+  pPaths->pNextFree = this->pFree;
+  this->pFree = pPaths;
+  pthread_mutex_unlock(&this->lock);
+}
+
+#endif
@@ -0,0 +1,377 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 01:07:43
+ * @ Modified time: 2026-10-19 10:24:09
+ * @ Description:
+ *
+ * Approximates the PageRank personalized to a single node by pushing its score outwards (Andersen, Chung and Lang).
+ * Only nodes holding enough leftover score are ever touched, so the work depends on the tolerance and not on the graph.
+ */
+
+#ifndef PERSONALRANK_C
+#define PERSONALRANK_C
+
+#include "../graph.c"
+#include "../structs/bitset.c"
+#include "../../utils/topk.c"
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// The defaults of a query
+#define PERSONALRANK_ALPHA 0.15
+#define PERSONALRANK_EPSILON 1e-6
+
+typedef struct PersonalRank PersonalRank;
+typedef struct PersonalRankPool PersonalRankPool;
+
+/**
+ * The reusable state of a personalized PageRank query.
+ * Every score starts out as leftover mass on the source, and is moved to the estimates one push at a time.
+ * A single instance must not be shared across threads; take one from a pool instead.
+ */
+struct PersonalRank {
+
+  // The graph to explore
+  Graph *pGraph;
+
+  // The settled scores, and the mass each node has yet to pass on
+  double *pEstimates;
+  double *pResiduals;
+
+  // The nodes waiting to be pushed, as a ring, and which ones are in it
+  int *pQueue;
+  Bitset *pQueued;
+
+  // The nodes with a nonzero estimate or residual
+  int *pTouched;
+  int touchedCount;
+
+  // The last query, and the work it took
+  int source;
+  long pushCount;
+  long edgeCount;
+
+  // The next free query in the pool
+  PersonalRank *pNextFree;
+};
+
+/**
+ * A thread-safe stack of idle personalized rank queries.
+ */
+struct PersonalRankPool {
+
+  // The graph the queries are made for
+  Graph *pGraph;
+
+  // The idle queries
+  PersonalRank *pFree;
+
+  // Guards the idle list
+  pthread_mutex_t lock;
+};
+
+/**
+ * The personalized rank interface.
+ */
+PersonalRank *_PersonalRank_alloc();
+PersonalRank *_PersonalRank_init(PersonalRank *this, Graph *pGraph);
+PersonalRank *PersonalRank_new(Graph *pGraph);
+void PersonalRank_kill(PersonalRank *this);
+
+PersonalRankPool *_PersonalRankPool_alloc();
+PersonalRankPool *_PersonalRankPool_init(PersonalRankPool *this, Graph *pGraph);
+PersonalRankPool *PersonalRankPool_new(Graph *pGraph);
+void PersonalRankPool_kill(PersonalRankPool *this);
+
+PersonalRank *PersonalRankPool_acquire(PersonalRankPool *this);
+void PersonalRankPool_release(PersonalRankPool *this, PersonalRank *pPersonalRank);
+
+void _PersonalRank_reset(PersonalRank *this);
+int PersonalRank_run(PersonalRank *this, int source, double alpha, double epsilon);
+int PersonalRank_getTop(PersonalRank *this, int k, int *pTop);
+
+/**
+ * Allocates memory for a personalized rank query.
+ *
+ * @return  { PersonalRank * }  The memory for the new query.
+ */
+PersonalRank *_PersonalRank_alloc() {
+  PersonalRank *pPersonalRank = calloc(1, sizeof(*pPersonalRank));
+
+  return pPersonalRank;
+}
+
+/**
+ * Initializes a personalized rank query against the given graph.
+ *
+ * @param   { PersonalRank * }  this    The query to initialize.
+ * @param   { Graph * }         pGraph  The graph to explore.
+ * @return  { PersonalRank * }          The initialized query.
+ */
+PersonalRank *_PersonalRank_init(PersonalRank *this, Graph *pGraph) {
+
+  // Size everything for the graph
+  int n = pGraph->nodeCount;
+  this->pGraph = pGraph;
+  this->pEstimates = calloc(n + 1, sizeof(double));
+  this->pResiduals = calloc(n + 1, sizeof(double));
+  this->pQueue = malloc((n + 1) * sizeof(int));
+  this->pQueued = Bitset_new(n);
+  this->pTouched = malloc((n + 1) * sizeof(int));
+  this->touchedCount = 0;
+  this->source = -1;
+  this->pushCount = 0;
+  this->edgeCount = 0;
+  this->pNextFree = NULL;
+
+  return this;
+}
+
+/**
+ * Creates a new personalized rank query against the given graph.
+ *
+ * @param   { Graph * }         pGraph  The graph to explore.
+ * @return  { PersonalRank * }          The new query.
+ */
+PersonalRank *PersonalRank_new(Graph *pGraph) {
+  return _PersonalRank_init(_PersonalRank_alloc(), pGraph);
+}
+
+/**
+ * Frees the memory associated with a personalized rank query.
+ *
+ * @param   { PersonalRank * }  this  The query to free.
+ */
+void PersonalRank_kill(PersonalRank *this) {
+  free(this->pEstimates);
+  free(this->pResiduals);
+  free(this->pQueue);
+  Bitset_kill(this->pQueued);
+  free(this->pTouched);
+  free(this);
+}
+
+/**
+ * Forgets the last query, touching only what it reached.
+ *
+ * @param   { PersonalRank * }  this  The query to reset.
+ */
+void _PersonalRank_reset(PersonalRank *this) {
+
+  // Clear each touched node
+  for(int i = 0; i < this->touchedCount; i++) {
+    int u = this->pTouched[i];
+    this->pEstimates[u] = 0;
+    this->pResiduals[u] = 0;
+  }
+
+  this->touchedCount = 0;
+  this->pushCount = 0;
+  this->edgeCount = 0;
+}
+
+/**
+ * Approximates the PageRank of every node, personalized to the source.
+ * A node is pushed while its leftover mass is at least epsilon times its degree: it keeps alpha of that mass,
+ * and splits the rest evenly among its neighbors. Every estimate ends up within epsilon times the degree of
+ * its true value, and at most 1 / (alpha * epsilon) pushes happen in total.
+ * Afterwards, pTouched lists every node with a nonzero estimate or residual.
+ *
+ * @param   { PersonalRank * }  this      The query to run.
+ * @param   { int }             source    The node to personalize to.
+ * @param   { double }          alpha     How likely a walk is to jump back to the source at each step.
+ * @param   { double }          epsilon   How much leftover mass per neighbor is small enough to leave behind.
+ * @return  { int }                       How many nodes were touched.
+ */
+int PersonalRank_run(PersonalRank *this, int source, double alpha, double epsilon) {
+  Graph *pGraph = this->pGraph;
+  int capacity = pGraph->nodeCount + 1;
+
+  // Forget the last query
+  _PersonalRank_reset(this);
+  this->source = source;
+
+  // All of the mass starts on the source
+  this->pResiduals[source] = 1;
+  this->pTouched[this->touchedCount++] = source;
+
+  // Nobody to pass it on to
+  if(!Graph_getDegree(pGraph, source)) {
+    this->pEstimates[source] = 1;
+    this->pResiduals[source] = 0;
+    return this->touchedCount;
+  }
+
+  // The queue is a ring, since each node is in it at most once
+  int head = 0;
+  int tail = 0;
+  this->pQueue[tail++] = source;
+  Bitset_set(this->pQueued, source);
+
+  // Push until nobody has enough left over
+  while(head != tail) {
+    int u = this->pQueue[head];
+    head = (head + 1) % capacity;
+    Bitset_unset(this->pQueued, u);
+
+    // Settle part of the mass, and split the rest
+    int *pAdjs = Graph_getAdjs(pGraph, u);
+    int degree = Graph_getDegree(pGraph, u);
+    double residual = this->pResiduals[u];
+    double share = (1 - alpha) * residual / degree;
+
+    this->pEstimates[u] += alpha * residual;
+    this->pResiduals[u] = 0;
+    this->pushCount++;
+    this->edgeCount += degree;
+
+    for(int j = 0; j < degree; j++) {
+      int v = pAdjs[j];
+
+      // First time here
+      if(this->pResiduals[v] == 0 && this->pEstimates[v] == 0)
+        this->pTouched[this->touchedCount++] = v;
+
+      this->pResiduals[v] += share;
+
+      // Enough to be worth pushing
+      if(!Bitset_get(this->pQueued, v) && this->pResiduals[v] >= epsilon * Graph_getDegree(pGraph, v)) {
+        this->pQueue[tail] = v;
+        tail = (tail + 1) % capacity;
+        Bitset_set(this->pQueued, v);
+      }
+    }
+  }
+
+  return this->touchedCount;
+}
+
+/**
+ * Finds the touched nodes with the highest estimates, best first, leaving out the source.
+ * Only the touched nodes are scanned, so this costs what the query explored rather than the size of the graph.
+ *
+ * @param   { PersonalRank * }  this  The query to rank.
+ * @param   { int }             k     How many nodes to find.
+ * @param   { int * }           pTop  Where to write the nodes; must hold k entries.
+ * @return  { int }                   How many nodes were written.
+ */
+int PersonalRank_getTop(PersonalRank *this, int k, int *pTop) {
+  double *pEstimates = this->pEstimates;
+  int count = 0;
+
+  // Slide each touched node into the window
+  for(int i = 0; i < this->touchedCount; i++) {
+    int u = this->pTouched[i];
+
+    // Not worth ranking
+    if(u == this->source || pEstimates[u] == 0)
+      continue;
+
+    count = TopK_push(pEstimates, pTop, count, k, u);
+  }
+
+  return count;
+}
+
+/**
+ * Allocates memory for a pool.
+ *
+ * @return  { PersonalRankPool * }                 The memory for the new pool.
+ */
+PersonalRankPool *_PersonalRankPool_alloc() {
+  PersonalRankPool *pPool = calloc(1, sizeof(*pPool));
+
+  return pPool;
+}
+
+/**
+ * Initializes an empty pool.
+ *
+ * @param   { PersonalRankPool * }  this           The pool to initialize.
+ * @param   { Graph * }             pGraph         The graph the queries are made for.
+ * @return  { PersonalRankPool * }                 The initialized pool.
+ */
+PersonalRankPool *_PersonalRankPool_init(PersonalRankPool *this, Graph *pGraph) {
+
+  // No idle queries yet
+  this->pGraph = pGraph;
+  this->pFree = NULL;
+
+  pthread_mutex_init(&this->lock, NULL);
+
+  return this;
+}
+
+/**
+ * Creates a new empty pool.
+ *
+ * @param   { Graph * }             pGraph         The graph the queries are made for.
+ * @return  { PersonalRankPool * }                 The new pool.
+ */
+PersonalRankPool *PersonalRankPool_new(Graph *pGraph) {
+  return _PersonalRankPool_init(_PersonalRankPool_alloc(), pGraph);
+}
+
+/**
+ * Frees the pool and all of its idle queries.
+ * Queries that were never released are not freed.
+ *
+ * @param   { PersonalRankPool * }  this           The pool to free.
+ */
+void PersonalRankPool_kill(PersonalRankPool *this) {
+
+  // Free the idle queries
+  while(this->pFree != NULL) {
+    PersonalRank *pPersonalRank = this->pFree;
+    this->pFree = pPersonalRank->pNextFree;
+    PersonalRank_kill(pPersonalRank);
+  }
+
+  // Free the pool itself
+  pthread_mutex_destroy(&this->lock);
+  free(this);
+}
+
+/**
+ * Grabs an idle query, creating one if none are left.
+ * Safe to call from several threads.
+ *
+ * @param   { PersonalRankPool * }  this           The pool to take from.
+ * @return  { PersonalRank * }                     A query that the caller now owns.
+ */
+PersonalRank *PersonalRankPool_acquire(PersonalRankPool *this) {
+
+  // Pop an idle query
+  pthread_mutex_lock(&this->lock);
+  PersonalRank *pPersonalRank = this->pFree;
+
+  if(pPersonalRank != NULL)
+    this->pFree = pPersonalRank->pNextFree;
+
+  pthread_mutex_unlock(&this->lock);
+
+  // Make a new one outside the lock
+  if(pPersonalRank == NULL)
+    pPersonalRank = PersonalRank_new(this->pGraph);
+
+  return pPersonalRank;
+}
+
+/**
+ * Returns a query to the pool so its buffers can be reused.
+ * Safe to call from several threads.
+ *
+ * @param   { PersonalRankPool * }  this           The pool to return to.
+ * @param   { PersonalRank * }      pPersonalRank  The query to return.
+ */
+void PersonalRankPool_release(PersonalRankPool *this, PersonalRank *pPersonalRank) {
+
+  // Push it back
+  pthread_mutex_lock(&this->lock);
+  pPersonalRank->pNextFree = this->pFree;
+  this->pFree = pPersonalRank;
+  pthread_mutex_unlock(&this->lock);
+}
+
+#endif
@@ -0,0 +1,281 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 20:52:19
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ *
+ * Holds the state of a single connection query, and a pool to recycle those between queries.
+ * Queries never write to the graph, so any number of them can run at once against the same model.
+ */
+
+#ifndef QUERY_C
+#define QUERY_C
+
+#include "../graph.c"
+#include "../metrics/components.c"
+#include "./bfs.c"
+
+#include <stdlib.h>
+#include <pthread.h>
+
+typedef struct Query Query;
+typedef struct QueryPool QueryPool;
+
+/**
+ * The state of a single query.
+ * A query owns its scratch buffers and its result, and is handed out by a pool.
+ */
+struct Query {
+
+  // The graph being queried, and its components if known
+  Graph *pGraph;
+  Components *pComponents;
+
+  // The reusable search buffers
+  BFSScratch *pScratch;
+
+  // The last path found, from source to target, and its length in nodes
+  int *pPath;
+  int pathLength;
+
+  // The counters of the last search
+  BFSStats stats;
+
+  // The next free query in the pool
+  Query *pNextFree;
+};
+
+/**
+ * A thread-safe stack of idle queries.
+ */
+struct QueryPool {
+
+  // The graph the queries are made for, and its components if known
+  Graph *pGraph;
+  Components *pComponents;
+
+  // The idle queries
+  Query *pFree;
+
+  // Guards the idle list
+  pthread_mutex_t lock;
+};
+
+/**
+ * The query interface.
+ */
+Query *_Query_alloc();
+Query *_Query_init(Query *this, Graph *pGraph, Components *pComponents);
+Query *Query_new(Graph *pGraph, Components *pComponents);
+void Query_kill(Query *this);
+
+int Query_connect(Query *this, int source, int target);
+int Query_connectWithin(Query *this, int source, int target, BFSLimits *pLimits);
+
+QueryPool *_QueryPool_alloc();
+QueryPool *_QueryPool_init(QueryPool *this, Graph *pGraph, Components *pComponents);
+QueryPool *QueryPool_new(Graph *pGraph, Components *pComponents);
+void QueryPool_kill(QueryPool *this);
+
+Query *QueryPool_acquire(QueryPool *this);
+void QueryPool_release(QueryPool *this, Query *pQuery);
+
+/**
+ * Allocates memory for a query.
+ *
+ * @return  { Query * }   The memory for the new query.
+ */
+Query *_Query_alloc() {
+  Query *pQuery = calloc(1, sizeof(*pQuery));
+
+  return pQuery;
+}
+
+/**
+ * Initializes a query against the given graph.
+ *
+ * @param   { Query * }       this          The query to initialize.
+ * @param   { Graph * }       pGraph        The graph to query.
+ * @param   { Components * }  pComponents   The components of the graph; may be NULL.
+ * @return  { Query * }                     The initialized query.
+ */
+Query *_Query_init(Query *this, Graph *pGraph, Components *pComponents) {
+
+  // Size everything for the graph
+  this->pGraph = pGraph;
+  this->pComponents = pComponents;
+  this->pScratch = BFSScratch_new(pGraph->nodeCount);
+  this->pPath = malloc((pGraph->nodeCount + 1) * sizeof(int));
+  this->pathLength = 0;
+  this->pNextFree = NULL;
+
+  return this;
+}
+
+/**
+ * Creates a new query against the given graph.
+ *
+ * @param   { Graph * }       pGraph        The graph to query.
+ * @param   { Components * }  pComponents   The components of the graph; may be NULL.
+ * @return  { Query * }                     The new query.
+ */
+Query *Query_new(Graph *pGraph, Components *pComponents) {
+  return _Query_init(_Query_alloc(), pGraph, pComponents);
+}
+
+/**
+ * Frees the memory associated with a query.
+ *
+ * @param   { Query * }   this  The query to free.
+ */
+void Query_kill(Query *this) {
+  BFSScratch_kill(this->pScratch);
+  free(this->pPath);
+  free(this);
+}
+
+/**
+ * Looks for a shortest path between two nodes.
+ * Nodes in different components are turned away without searching.
+ * The path is stored in the query; returns its length in nodes, or 0 if there is none.
+ *
+ * @param   { Query * }   this    The query to run.
+ * @param   { int }       source  The index of the source node.
+ * @param   { int }       target  The index of the target node.
+ * @return  { int }               The number of nodes in the path.
+ */
+int Query_connect(Query *this, int source, int target) {
+  return Query_connectWithin(this, source, target, NULL);
+}
+
+/**
+ * Looks for a shortest path between two nodes, giving up once any of the limits is hit.
+ * The status in the query's counters says whether it stopped early, and why.
+ * The path is stored in the query; returns its length in nodes, or 0 if none was found.
+ *
+ * @param   { Query * }       this      The query to run.
+ * @param   { int }           source    The index of the source node.
+ * @param   { int }           target    The index of the target node.
+ * @param   { BFSLimits * }   pLimits   The bounds of the search; NULL for none.
+ * @return  { int }                     The number of nodes in the path.
+ */
+int Query_connectWithin(Query *this, int source, int target, BFSLimits *pLimits) {
+
+  // There can't be a path
+  if(this->pComponents != NULL && !Components_isConnectable(this->pComponents, source, target)) {
+    this->stats = (BFSStats) { 0 };
+    this->stats.status = BFS_STATUS_NONE;
+    this->pathLength = 0;
+    return 0;
+  }
+
+  // Search from both ends
+  this->pathLength = BFS_bidirectionalWithin(this->pGraph, this->pScratch, source, target, pLimits, this->pPath, &this->stats);
+
+  return this->pathLength;
+}
+
+/**
+ * Allocates memory for a pool.
+ *
+ * @return  { QueryPool * }   The memory for the new pool.
+ */
+QueryPool *_QueryPool_alloc() {
+  QueryPool *pPool = calloc(1, sizeof(*pPool));
+
+  return pPool;
+}
+
+/**
+ * Initializes an empty pool.
+ *
+ * @param   { QueryPool * }   this          The pool to initialize.
+ * @param   { Graph * }       pGraph        The graph the queries are made for.
+ * @param   { Components * }  pComponents   The components of the graph; may be NULL.
+ * @return  { QueryPool * }                 The initialized pool.
+ */
+QueryPool *_QueryPool_init(QueryPool *this, Graph *pGraph, Components *pComponents) {
+
+  // No idle queries yet
+  this->pGraph = pGraph;
+  this->pComponents = pComponents;
+  this->pFree = NULL;
+
+  pthread_mutex_init(&this->lock, NULL);
+
+  return this;
+}
+
+/**
+ * Creates a new empty pool.
+ *
+ * @param   { Graph * }       pGraph        The graph the queries are made for.
+ * @param   { Components * }  pComponents   The components of the graph; may be NULL.
+ * @return  { QueryPool * }                 The new pool.
+ */
+QueryPool *QueryPool_new(Graph *pGraph, Components *pComponents) {
+  return _QueryPool_init(_QueryPool_alloc(), pGraph, pComponents);
+}
+
+/**
+ * Frees the pool and all of its idle queries.
+ * Queries that were never released are not freed.
+ *
+ * @param   { QueryPool * }   this  The pool to free.
+ */
+void QueryPool_kill(QueryPool *this) {
+
+  // Free the idle queries
+  while(this->pFree != NULL) {
+    Query *pQuery = this->pFree;
+    this->pFree = pQuery->pNextFree;
+    Query_kill(pQuery);
+  }
+
+  // Free the pool itself
+  pthread_mutex_destroy(&this->lock);
+  free(this);
+}
+
+/**
+ * Grabs an idle query, creating one if none are left.
+ * Safe to call from several threads.
+ *
+ * @param   { QueryPool * }   this  The pool to take from.
+ * @return  { Query * }             A query that the caller now owns.
+ */
+Query *QueryPool_acquire(QueryPool *this) {
+
+  // Pop an idle query
+  pthread_mutex_lock(&this->lock);
+  Query *pQuery = this->pFree;
+
+  if(pQuery != NULL)
+    this->pFree = pQuery->pNextFree;
+
+  pthread_mutex_unlock(&this->lock);
+
+  // Make a new one outside the lock
+  if(pQuery == NULL)
+    pQuery = Query_new(this->pGraph, this->pComponents);
+
+  return pQuery;
+}
+
+/**
+ * Returns a query to the pool so its buffers can be reused.
+ * Safe to call from several threads.
+ *
+ * @param   { QueryPool * }   this    The pool to return to.
+ * @param   { Query * }       pQuery  The query to return.
+ */
+void QueryPool_release(QueryPool *this, Query *pQuery) {
+
+  // Push it back
+  pthread_mutex_lock(&this->lock);
+  pQuery->pNextFree = this->pFree;
+  this->pFree = pQuery;
+  pthread_mutex_unlock(&this->lock);
+}
+
+#endif
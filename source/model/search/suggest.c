@@ -0,0 +1,560 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 05:33:40
+ * @ Modified time: 2026-10-19 10:33:48
+ * @ Description:
+ *
+ * Suggests new friends for a node: the people it isn't friends with yet who share the most friends with it.
+ * Everyone two hops out is scored in a single pass over the friends of its friends, using dense scratch
+ * arrays that are cleaned up by touching only what was used, so a query costs nothing but that neighborhood.
+ */
+
+#ifndef SUGGEST_C
+#define SUGGEST_C
+
+#include "../graph.c"
+#include "../../utils/math.c"
+#include "../../utils/thread.c"
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// How many nodes each thread claims at a time when suggesting for everyone
+#define SUGGEST_CHUNK 64
+
+// Marks the source and its friends, who can't be suggested
+#define SUGGEST_EXCLUDED (-1)
+
+typedef enum SuggestMetric SuggestMetric;
+typedef struct Suggest Suggest;
+typedef struct SuggestPool SuggestPool;
+typedef struct SuggestJob SuggestJob;
+
+/**
+ * How to score a candidate w for a source s, with N(x) the friends of x.
+ */
+enum SuggestMetric {
+
+  // |N(s) & N(w)|
+  SUGGEST_COMMON,
+
+  // |N(s) & N(w)| / |N(s) | N(w)|
+  SUGGEST_JACCARD,
+
+  // The sum of 1 / log |N(u)| over every u in N(s) & N(w), so mutual friends with fewer friends count for more
+  SUGGEST_ADAMIC_ADAR,
+};
+
+/**
+ * The reusable state of a suggestion query.
+ * A single instance must not be shared across threads; take one from a pool instead.
+ */
+struct Suggest {
+
+  // The graph to explore
+  Graph *pGraph;
+
+  // 1 / log d for every degree d, up to the highest
+  double *pInverseLogs;
+
+  // The friends in common with each candidate, and their weight
+  int *pCounts;
+  double *pScores;
+
+  // The candidates reached by the last query
+  int *pTouched;
+  int touchedCount;
+
+  // The best candidates of the last query, best first, and their scores
+  int *pTop;
+  double *pTopScores;
+  int topCount;
+  int topLimit;
+
+  // The work the last query took
+  long edgeCount;
+
+  // The next free query in the pool
+  Suggest *pNextFree;
+};
+
+/**
+ * A thread-safe stack of idle suggestion queries.
+ */
+struct SuggestPool {
+
+  // The graph the queries are made for
+  Graph *pGraph;
+
+  // The idle queries
+  Suggest *pFree;
+
+  // Guards the idle list
+  pthread_mutex_t lock;
+};
+
+/**
+ * The state shared by the threads suggesting for everyone.
+ */
+struct SuggestJob {
+
+  // The graph, and what to ask for
+  Graph *pGraph;
+  SuggestMetric metric;
+  int k;
+
+  // The query of each thread, made when the thread first needs it
+  Suggest *pQueries[THREAD_MAX_COUNT];
+
+  // k suggestions per node, and how many each node got
+  int *pResults;
+  int *pCounts;
+};
+
+/**
+ * The suggestion interface.
+ */
+Suggest *_Suggest_alloc();
+Suggest *_Suggest_init(Suggest *this, Graph *pGraph);
+Suggest *Suggest_new(Graph *pGraph);
+void Suggest_kill(Suggest *this);
+
+SuggestPool *_SuggestPool_alloc();
+SuggestPool *_SuggestPool_init(SuggestPool *this, Graph *pGraph);
+SuggestPool *SuggestPool_new(Graph *pGraph);
+void SuggestPool_kill(SuggestPool *this);
+
+Suggest *SuggestPool_acquire(SuggestPool *this);
+void SuggestPool_release(SuggestPool *this, Suggest *pSuggest);
+
+static inline int _Suggest_isBefore(int a, double aScore, int b, double bScore);
+void _Suggest_siftDown(Suggest *this, int i);
+void _Suggest_offer(Suggest *this, int w, double score);
+int Suggest_run(Suggest *this, int source, SuggestMetric metric, int k);
+
+void _Suggest_runRange(void *pArgs, int thread, int start, int end);
+long Suggest_runAll(Graph *pGraph, SuggestMetric metric, int k, int *pResults, int *pCounts);
+
+/**
+ * Allocates memory for a suggestion query.
+ *
+ * @return  { Suggest * }   The memory for the new query.
+ */
+Suggest *_Suggest_alloc() {
+  Suggest *pSuggest = calloc(1, sizeof(*pSuggest));
+
+  return pSuggest;
+}
+
+/**
+ * Initializes a suggestion query against the given graph.
+ *
+ * @param   { Suggest * }   this    The query to initialize.
+ * @param   { Graph * }     pGraph  The graph to explore.
+ * @return  { Suggest * }           The initialized query.
+ */
+Suggest *_Suggest_init(Suggest *this, Graph *pGraph) {
+
+  // Size everything for the graph
+  int n = pGraph->nodeCount;
+  int maxDegree = 0;
+
+  for(int v = 0; v < n; v++)
+    if(Graph_getDegree(pGraph, v) > maxDegree)
+      maxDegree = Graph_getDegree(pGraph, v);
+
+  this->pGraph = pGraph;
+  this->pCounts = calloc(n + 1, sizeof(int));
+  this->pScores = calloc(n + 1, sizeof(double));
+  this->pTouched = malloc((n + 1) * sizeof(int));
+  this->touchedCount = 0;
+  this->pTop = NULL;
+  this->pTopScores = NULL;
+  this->topCount = 0;
+  this->topLimit = 0;
+  this->edgeCount = 0;
+
+  // A mutual friend has at least two friends, so the logs are never 0
+  this->pInverseLogs = calloc(maxDegree + 2, sizeof(double));
+
+  for(int d = 2; d <= maxDegree; d++)
+    this->pInverseLogs[d] = 1 / Math_log(d);
+  this->pNextFree = NULL;
+
+  return this;
+}
+
+/**
+ * Creates a new suggestion query against the given graph.
+ *
+ * @param   { Graph * }     pGraph  The graph to explore.
+ * @return  { Suggest * }           The new query.
+ */
+Suggest *Suggest_new(Graph *pGraph) {
+  return _Suggest_init(_Suggest_alloc(), pGraph);
+}
+
+/**
+ * Frees the memory associated with a suggestion query.
+ *
+ * @param   { Suggest * }   this  The query to free.
+ */
+void Suggest_kill(Suggest *this) {
+  free(this->pInverseLogs);
+  free(this->pCounts);
+  free(this->pScores);
+  free(this->pTouched);
+  free(this->pTop);
+  free(this->pTopScores);
+  free(this);
+}
+
+/**
+ * Checks whether one candidate ranks before another: a higher score, or the lower index on a tie.
+ *
+ * @param   { int }         a       The first candidate.
+ * @param   { double }      aScore  Its score.
+ * @param   { int }         b       The second candidate.
+ * @param   { double }      bScore  Its score.
+ * @return  { int }                 Whether a ranks before b.
+ */
+static inline int _Suggest_isBefore(int a, double aScore, int b, double bScore) {
+  return aScore > bScore || (aScore == bScore && a < b);
+}
+
+/**
+ * Restores the heap below the given spot.
+ * The heap keeps the worst of the best candidates on top, so it's the one to replace.
+ *
+ * @param   { Suggest * }   this  The query being ranked.
+ * @param   { int }         i     The spot that may be out of place.
+ */
+void _Suggest_siftDown(Suggest *this, int i) {
+  int *pTop = this->pTop;
+  double *pScores = this->pTopScores;
+
+  while(1) {
+    int worst = i;
+    int left = 2 * i + 1;
+    int right = left + 1;
+
+    // Find the worst of the three
+    if(left < this->topCount && _Suggest_isBefore(pTop[worst], pScores[worst], pTop[left], pScores[left]))
+      worst = left;
+    if(right < this->topCount && _Suggest_isBefore(pTop[worst], pScores[worst], pTop[right], pScores[right]))
+      worst = right;
+
+    if(worst == i)
+      return;
+
+    // Swap it up
+    int node = pTop[i];
+    double score = pScores[i];
+    pTop[i] = pTop[worst];
+    pScores[i] = pScores[worst];
+    pTop[worst] = node;
+    pScores[worst] = score;
+    i = worst;
+  }
+}
+
+/**
+ * Offers a candidate to the heap of the best k.
+ * It gets in while there's room, and afterwards only by beating the worst one there.
+ *
+ * @param   { Suggest * }   this    The query being ranked.
+ * @param   { int }         w       The candidate.
+ * @param   { double }      score   Its score.
+ */
+void _Suggest_offer(Suggest *this, int w, double score) {
+  int *pTop = this->pTop;
+  double *pScores = this->pTopScores;
+
+  // Not good enough
+  if(this->topCount == this->topLimit) {
+    if(!_Suggest_isBefore(w, score, pTop[0], pScores[0]))
+      return;
+
+    pTop[0] = w;
+    pScores[0] = score;
+    _Suggest_siftDown(this, 0);
+    return;
+  }
+
+  // Room left, so sift it up
+  int i = this->topCount++;
+
+  for(; i > 0 && _Suggest_isBefore(pTop[(i - 1) / 2], pScores[(i - 1) / 2], w, score); i = (i - 1) / 2) {
+    pTop[i] = pTop[(i - 1) / 2];
+    pScores[i] = pScores[(i - 1) / 2];
+  }
+
+  pTop[i] = w;
+  pScores[i] = score;
+}
+
+/**
+ * Finds the k best friends to suggest to a node.
+ * The source and its friends are marked first, then every friend of a friend gets a count and a weight from
+ * each mutual friend. Only those with a count are scored, through a bounded heap, and only the marked and
+ * counted entries are cleared afterwards. The work is the sum of the degrees of the source's friends.
+ * Afterwards pTop and pTopScores hold the suggestions, best first.
+ *
+ * @param   { Suggest * }       this    The query to run.
+ * @param   { int }             source  The node to suggest for.
+ * @param   { SuggestMetric }   metric  How to score the candidates.
+ * @param   { int }             k       How many to suggest.
+ * @return  { int }                     How many were suggested.
+ */
+int Suggest_run(Suggest *this, int source, SuggestMetric metric, int k) {
+  Graph *pGraph = this->pGraph;
+  int *pAdjs = Graph_getAdjs(pGraph, source);
+  int degree = Graph_getDegree(pGraph, source);
+
+  // Make room for the answer
+  if(k > this->topLimit) {
+    this->pTop = realloc(this->pTop, k * sizeof(int));
+    this->pTopScores = realloc(this->pTopScores, k * sizeof(double));
+  }
+
+  this->topLimit = k;
+  this->topCount = 0;
+  this->touchedCount = 0;
+  this->edgeCount = 0;
+
+  // Nobody can be suggested to the node or its friends
+  this->pCounts[source] = SUGGEST_EXCLUDED;
+
+  for(int i = 0; i < degree; i++)
+    this->pCounts[pAdjs[i]] = SUGGEST_EXCLUDED;
+
+  // Count the mutual friends with everyone two hops out
+  for(int i = 0; i < degree; i++) {
+    int u = pAdjs[i];
+    int *pOthers = Graph_getAdjs(pGraph, u);
+    int otherDegree = Graph_getDegree(pGraph, u);
+    double weight = this->pInverseLogs[otherDegree];
+
+    this->edgeCount += otherDegree;
+
+    for(int j = 0; j < otherDegree; j++) {
+      int w = pOthers[j];
+
+      if(this->pCounts[w] == SUGGEST_EXCLUDED)
+        continue;
+
+      // First time here
+      if(!this->pCounts[w])
+        this->pTouched[this->touchedCount++] = w;
+
+      this->pCounts[w]++;
+      this->pScores[w] += weight;
+    }
+  }
+
+  // Score everyone reached, then clean up after them
+  for(int i = 0; i < this->touchedCount; i++) {
+    int w = this->pTouched[i];
+    int common = this->pCounts[w];
+    double score =
+      metric == SUGGEST_JACCARD ? (double) common / (degree + Graph_getDegree(pGraph, w) - common) :
+      metric == SUGGEST_ADAMIC_ADAR ? this->pScores[w] :
+      common;
+
+    if(k > 0)
+      _Suggest_offer(this, w, score);
+
+    this->pCounts[w] = 0;
+    this->pScores[w] = 0;
+  }
+
+  this->pCounts[source] = 0;
+
+  for(int i = 0; i < degree; i++)
+    this->pCounts[pAdjs[i]] = 0;
+
+  // Empty the heap from the worst, filling the list from the back
+  int count = this->topCount;
+
+  while(this->topCount) {
+    int last = --this->topCount;
+    int node = this->pTop[0];
+    double score = this->pTopScores[0];
+
+    this->pTop[0] = this->pTop[last];
+    this->pTopScores[0] = this->pTopScores[last];
+    _Suggest_siftDown(this, 0);
+
+    this->pTop[last] = node;
+    this->pTopScores[last] = score;
+  }
+
+  this->topCount = count;
+
+  return count;
+}
+
+/**
+ * Suggests friends for every node within the given range, saving them into the shared results.
+ *
+ * @param   { void * }  pArgs   The shared SuggestJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first node to suggest for.
+ * @param   { int }     end     One past the last node to suggest for.
+ */
+void _Suggest_runRange(void *pArgs, int thread, int start, int end) {
+  SuggestJob *pJob = pArgs;
+
+  // Make this thread's query the first time it's needed
+  if(pJob->pQueries[thread] == NULL)
+    pJob->pQueries[thread] = Suggest_new(pJob->pGraph);
+
+  Suggest *pSuggest = pJob->pQueries[thread];
+
+  for(int v = start; v < end; v++) {
+    int count = Suggest_run(pSuggest, v, pJob->metric, pJob->k);
+
+    for(int i = 0; i < count; i++)
+      pJob->pResults[(long) v * pJob->k + i] = pSuggest->pTop[i];
+
+    pJob->pCounts[v] = count;
+  }
+}
+
+/**
+ * Suggests friends for every node at once, across threads.
+ * The suggestions of node v land in pResults[v * k] onwards, best first.
+ *
+ * @param   { Graph * }         pGraph    The graph to explore.
+ * @param   { SuggestMetric }   metric    How to score the candidates.
+ * @param   { int }             k         How many to suggest to each node.
+ * @param   { int * }           pResults  Where to write the suggestions; must hold nodeCount * k entries.
+ * @param   { int * }           pCounts   Where to write how many each node got; must hold nodeCount entries.
+ * @return  { long }                      How many suggestions were made in total.
+ */
+long Suggest_runAll(Graph *pGraph, SuggestMetric metric, int k, int *pResults, int *pCounts) {
+  SuggestJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pGraph = pGraph;
+  pJob->metric = metric;
+  pJob->k = k;
+  pJob->pResults = pResults;
+  pJob->pCounts = pCounts;
+
+  Thread_parallelFor(pGraph->nodeCount, SUGGEST_CHUNK, _Suggest_runRange, pJob);
+
+  // Garbage collection, and the total
+  long total = 0;
+
+  for(int i = 0; i < THREAD_MAX_COUNT; i++)
+    if(pJob->pQueries[i] != NULL)
+      Suggest_kill(pJob->pQueries[i]);
+
+  for(int v = 0; v < pGraph->nodeCount; v++)
+    total += pCounts[v];
+
+  free(pJob);
+
+  return total;
+}
+
+/**
+ * Allocates memory for a pool.
+ *
+ * @return  { SuggestPool * }            The memory for the new pool.
+ */
+SuggestPool *_SuggestPool_alloc() {
+  SuggestPool *pPool = calloc(1, sizeof(*pPool));
+
+  return pPool;
+}
+
+/**
+ * Initializes an empty pool.
+ *
+ * @param   { SuggestPool * }  this      The pool to initialize.
+ * @param   { Graph * }        pGraph    The graph the queries are made for.
+ * @return  { SuggestPool * }            The initialized pool.
+ */
+SuggestPool *_SuggestPool_init(SuggestPool *this, Graph *pGraph) {
+
+  // No idle queries yet
+  this->pGraph = pGraph;
+  this->pFree = NULL;
+
+  pthread_mutex_init(&this->lock, NULL);
+
+  return this;
+}
+
+/**
+ * Creates a new empty pool.
+ *
+ * @param   { Graph * }        pGraph    The graph the queries are made for.
+ * @return  { SuggestPool * }            The new pool.
+ */
+SuggestPool *SuggestPool_new(Graph *pGraph) {
+  return _SuggestPool_init(_SuggestPool_alloc(), pGraph);
+}
+
+/**
+ * Frees the pool and all of its idle queries.
+ * Queries that were never released are not freed.
+ *
+ * @param   { SuggestPool * }  this      The pool to free.
+ */
+void SuggestPool_kill(SuggestPool *this) {
+
+  // Free the idle queries
+  while(this->pFree != NULL) {
+    Suggest *pSuggest = this->pFree;
+    this->pFree = pSuggest->pNextFree;
+    Suggest_kill(pSuggest);
+  }
+
+  // Free the pool itself
+  pthread_mutex_destroy(&this->lock);
+  free(this);
+}
+
+/**
+ * Grabs an idle query, creating one if none are left.
+ * Safe to call from several threads.
+ *
+ * @param   { SuggestPool * }  this      The pool to take from.
+ * @return  { Suggest * }                A query that the caller now owns.
+ */
+Suggest *SuggestPool_acquire(SuggestPool *this) {
+
+  // Pop an idle query
+  pthread_mutex_lock(&this->lock);
+  Suggest *pSuggest = this->pFree;
+
+  if(pSuggest != NULL)
+    this->pFree = pSuggest->pNextFree;
+
+  pthread_mutex_unlock(&this->lock);
+
+  // Make a new one outside the lock
+  if(pSuggest == NULL)
+    pSuggest = Suggest_new(this->pGraph);
+
+  return pSuggest;
+}
+
+/**
+ * Returns a query to the pool so its buffers can be reused.
+ * Safe to call from several threads.
+ *
+ * @param   { SuggestPool * }  this      The pool to return to.
+ * @param   { Suggest * }      pSuggest  The query to return.
+ */
+void SuggestPool_release(SuggestPool *this, Suggest *pSuggest) {
+
+  // Push it back
+  pthread_mutex_lock(&this->lock);
+  pSuggest->pNextFree = this->pFree;
+  this->pFree = pSuggest;
+  pthread_mutex_unlock(&this->lock);
+}
+
+#endif
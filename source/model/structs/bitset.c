@@ -0,0 +1,150 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 20:15:02
+ * @ Modified time: 2026-10-18 20:15:02
+ * @ Description:
+ *
+ * A fixed-size set of bits, packed into 64-bit words.
+ */
+
+#ifndef BITSET_C
+#define BITSET_C
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define BITSET_WORD_BITS 64
+
+typedef struct Bitset Bitset;
+
+/**
+ * The bitset struct.
+ */
+struct Bitset {
+
+  // The packed bits
+  uint64_t *words;
+
+  // How many bits and how many words there are
+  int size;
+  int wordCount;
+};
+
+/**
+ * The bitset interface.
+ */
+Bitset *_Bitset_alloc();
+Bitset *_Bitset_init(Bitset *this, int size);
+Bitset *Bitset_new(int size);
+void Bitset_kill(Bitset *this);
+
+void Bitset_clear(Bitset *this);
+int Bitset_count(Bitset *this);
+
+/**
+ * Checks whether a bit is set.
+ *
+ * @param   { Bitset * }  this  The bitset to read.
+ * @param   { int }       i     The bit to check.
+ * @return  { int }             Whether or not the bit is set.
+ */
+static inline int Bitset_get(Bitset *this, int i) {
+  return (this->words[i >> 6] >> (i & 63)) & 1;
+}
+
+/**
+ * Sets a bit.
+ * Not safe when other threads write to the same word.
+ *
+ * @param   { Bitset * }  this  The bitset to modify.
+ * @param   { int }       i     The bit to set.
+ */
+static inline void Bitset_set(Bitset *this, int i) {
+  this->words[i >> 6] |= 1ULL << (i & 63);
+}
+
+/**
+ * Unsets a bit.
+ *
+ * @param   { Bitset * }  this  The bitset to modify.
+ * @param   { int }       i     The bit to unset.
+ */
+static inline void Bitset_unset(Bitset *this, int i) {
+  this->words[i >> 6] &= ~(1ULL << (i & 63));
+}
+
+/**
+ * Allocates memory for a bitset.
+ *
+ * @return  { Bitset * }  The memory for the new bitset.
+ */
+Bitset *_Bitset_alloc() {
+  Bitset *pBitset = calloc(1, sizeof(*pBitset));
+
+  return pBitset;
+}
+
+/**
+ * Initializes a bitset with all of its bits unset.
+ *
+ * @param   { Bitset * }  this  The bitset to initialize.
+ * @param   { int }       size  How many bits to hold.
+ * @return  { Bitset * }        The initialized bitset.
+ */
+Bitset *_Bitset_init(Bitset *this, int size) {
+
+  // Round up to whole words
+  this->size = size;
+  this->wordCount = (size + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+  this->words = calloc(this->wordCount + 1, sizeof(uint64_t));
+
+  return this;
+}
+
+/**
+ * Creates a new empty bitset.
+ *
+ * @param   { int }       size  How many bits to hold.
+ * @return  { Bitset * }        The new bitset.
+ */
+Bitset *Bitset_new(int size) {
+  return _Bitset_init(_Bitset_alloc(), size);
+}
+
+/**
+ * Frees the memory associated with a bitset.
+ *
+ * @param   { Bitset * }  this  The bitset to free.
+ */
+void Bitset_kill(Bitset *this) {
+  free(this->words);
+  free(this);
+}
+
+/**
+ * Unsets all the bits.
+ *
+ * @param   { Bitset * }  this  The bitset to clear.
+ */
+void Bitset_clear(Bitset *this) {
+  memset(this->words, 0, this->wordCount * sizeof(uint64_t));
+}
+
+/**
+ * Counts how many bits are set.
+ *
+ * @param   { Bitset * }  this  The bitset to count.
+ * @return  { int }             The number of set bits.
+ */
+int Bitset_count(Bitset *this) {
+  int count = 0;
+
+  // Popcount each word
+  for(int i = 0; i < this->wordCount; i++)
+    count += __builtin_popcountll(this->words[i]);
+
+  return count;
+}
+
+#endif
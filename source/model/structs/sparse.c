@@ -0,0 +1,437 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 06:48:52
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ *
+ * Sparse matrices in compressed sparse row form, and their products.
+ * Products are computed a row at a time (Gustavson): row i of A * B sums the rows of B picked out by row i of A,
+ * accumulated in a dense per-thread array. Rows can be thinned as they come out so the result stays small.
+ */
+
+#ifndef SPARSE_C
+#define SPARSE_C
+
+#include "../graph.c"
+#include "../../utils/thread.c"
+
+#include <stdlib.h>
+#include <string.h>
+
+// How many rows are multiplied between handoffs, which bounds the memory of a streamed product
+#define SPARSE_BLOCK_ROWS 4096
+
+// How many rows each thread claims at a time
+#define SPARSE_CHUNK 64
+
+// Leaves a filter unset
+#define SPARSE_NO_LIMIT (-1)
+
+typedef struct Sparse Sparse;
+typedef struct SparseEntry SparseEntry;
+typedef struct SparseFilter SparseFilter;
+typedef struct SparseJob SparseJob;
+
+/**
+ * Called for every entry of a streamed product, in order of rows and then of columns.
+ * It receives the shared arguments, the row, the column, and the value.
+ */
+typedef void (*SparseVisit)(void *pArgs, int row, int column, double value);
+
+/**
+ * A sparse matrix.
+ * The entries of row i are at [pOffsets[i], pOffsets[i + 1]), sorted by column.
+ */
+struct Sparse {
+
+  // The shape, how many entries are stored, and how many fit
+  int rowCount;
+  int columnCount;
+  long entryCount;
+  long entryLimit;
+
+  // The rows
+  long *pOffsets;
+  int *pColumns;
+  double *pValues;
+};
+
+/**
+ * A single entry of a row.
+ */
+struct SparseEntry {
+  int column;
+  double value;
+};
+
+/**
+ * Which entries of a product to keep.
+ */
+struct SparseFilter {
+
+  // The smallest value to keep; SPARSE_NO_LIMIT keeps everything
+  double threshold;
+
+  // The most entries to keep per row, largest first; SPARSE_NO_LIMIT keeps everything
+  int k;
+
+  // Whether to keep the entries where the row and the column are the same
+  int bDiagonal;
+};
+
+/**
+ * The state shared by the threads multiplying a block of rows.
+ */
+struct SparseJob {
+
+  // The factors, and what to keep
+  Sparse *pA;
+  Sparse *pB;
+  SparseFilter *pFilter;
+
+  // The first row of the block
+  int blockStart;
+
+  // The dense accumulator of each thread, which columns the current row touched, and their list
+  double *pSums[THREAD_MAX_COUNT];
+  char *pSeen[THREAD_MAX_COUNT];
+  int *pTouched[THREAD_MAX_COUNT];
+
+  // The entries each thread produced for the block
+  SparseEntry *pEntries[THREAD_MAX_COUNT];
+  long entryCounts[THREAD_MAX_COUNT];
+  long entryLimits[THREAD_MAX_COUNT];
+
+  // Where each row of the block went: the thread, where its entries start, and how many there are
+  int pThreads[SPARSE_BLOCK_ROWS];
+  long pStarts[SPARSE_BLOCK_ROWS];
+  int pCounts[SPARSE_BLOCK_ROWS];
+
+  // How many multiply-adds were done, per thread
+  long productCounts[THREAD_MAX_COUNT];
+};
+
+/**
+ * The sparse interface.
+ */
+Sparse *_Sparse_alloc();
+Sparse *_Sparse_init(Sparse *this, int rowCount, int columnCount, long entryLimit);
+Sparse *Sparse_new(int rowCount, int columnCount, long entryLimit);
+Sparse *Sparse_fromGraph(Graph *pGraph);
+void Sparse_kill(Sparse *this);
+
+void _Sparse_multiplyRows(void *pArgs, int thread, int start, int end);
+long Sparse_stream(Sparse *pA, Sparse *pB, SparseFilter *pFilter, SparseVisit pVisit, void *pArgs);
+void _Sparse_append(void *pArgs, int row, int column, double value);
+Sparse *Sparse_multiply(Sparse *pA, Sparse *pB, SparseFilter *pFilter, long *pProductCount);
+
+/**
+ * Orders entries by decreasing value, then by column.
+ *
+ * @param   { const void * }  a   The first entry.
+ * @param   { const void * }  b   The second entry.
+ * @return  { int }               The ordering of the two entries.
+ */
+static int _Sparse_compareValues(const void *a, const void *b) {
+  const SparseEntry *pA = a;
+  const SparseEntry *pB = b;
+
+  if(pA->value != pB->value)
+    return pA->value > pB->value ? -1 : 1;
+
+  return pA->column - pB->column;
+}
+
+/**
+ * Orders entries by column.
+ *
+ * @param   { const void * }  a   The first entry.
+ * @param   { const void * }  b   The second entry.
+ * @return  { int }               The ordering of the two entries.
+ */
+static int _Sparse_compareColumns(const void *a, const void *b) {
+  return ((const SparseEntry *) a)->column - ((const SparseEntry *) b)->column;
+}
+
+/**
+ * Allocates memory for a sparse matrix.
+ *
+ * @return  { Sparse * }  The memory for the matrix.
+ */
+Sparse *_Sparse_alloc() {
+  Sparse *pSparse = calloc(1, sizeof(*pSparse));
+
+  return pSparse;
+}
+
+/**
+ * Initializes an empty sparse matrix with room for some entries.
+ *
+ * @param   { Sparse * }  this          The matrix to initialize.
+ * @param   { int }       rowCount      How many rows it has.
+ * @param   { int }       columnCount   How many columns it has.
+ * @param   { long }      entryLimit    How many entries to make room for.
+ * @return  { Sparse * }                The initialized matrix.
+ */
+Sparse *_Sparse_init(Sparse *this, int rowCount, int columnCount, long entryLimit) {
+  this->rowCount = rowCount;
+  this->columnCount = columnCount;
+  this->entryCount = 0;
+  this->entryLimit = entryLimit;
+  this->pOffsets = calloc(rowCount + 1, sizeof(long));
+  this->pColumns = malloc((entryLimit + 1) * sizeof(int));
+  this->pValues = malloc((entryLimit + 1) * sizeof(double));
+
+  return this;
+}
+
+/**
+ * Creates an empty sparse matrix with room for some entries.
+ *
+ * @param   { int }       rowCount      How many rows it has.
+ * @param   { int }       columnCount   How many columns it has.
+ * @param   { long }      entryLimit    How many entries to make room for.
+ * @return  { Sparse * }                The new matrix.
+ */
+Sparse *Sparse_new(int rowCount, int columnCount, long entryLimit) {
+  return _Sparse_init(_Sparse_alloc(), rowCount, columnCount, entryLimit);
+}
+
+/**
+ * Creates the adjacency matrix of a graph, with a 1 for every adjacency.
+ *
+ * @param   { Graph * }   pGraph  The graph to copy.
+ * @return  { Sparse * }          Its adjacency matrix.
+ */
+Sparse *Sparse_fromGraph(Graph *pGraph) {
+  int n = pGraph->nodeCount;
+  Sparse *this = Sparse_new(n, n, pGraph->adjCount);
+
+  // The lists are already sorted
+  for(int v = 0; v <= n; v++)
+    this->pOffsets[v] = pGraph->offsets[v];
+
+  for(int i = 0; i < pGraph->adjCount; i++) {
+    this->pColumns[i] = pGraph->adjs[i];
+    this->pValues[i] = 1;
+  }
+
+  this->entryCount = pGraph->adjCount;
+
+  return this;
+}
+
+/**
+ * Frees the memory associated with a sparse matrix.
+ *
+ * @param   { Sparse * }  this  The matrix to free.
+ */
+void Sparse_kill(Sparse *this) {
+  free(this->pOffsets);
+  free(this->pColumns);
+  free(this->pValues);
+  free(this);
+}
+
+/**
+ * Multiplies the rows of the block within the given range, thinning each one by the filter.
+ * Row i scatters a_ik * b_kj into the dense sums for every entry of row k of B, remembering which columns
+ * it touched, so that gathering and clearing them only costs what the row actually produced.
+ *
+ * @param   { void * }  pArgs   The shared SparseJob.
+ * @param   { int }     thread  The index of the running thread.
+ * @param   { int }     start   The first row of the block to multiply.
+ * @param   { int }     end     One past the last row to multiply.
+ */
+void _Sparse_multiplyRows(void *pArgs, int thread, int start, int end) {
+  SparseJob *pJob = pArgs;
+  Sparse *pA = pJob->pA;
+  Sparse *pB = pJob->pB;
+  SparseFilter *pFilter = pJob->pFilter;
+
+  // Make this thread's accumulator the first time it's needed
+  if(pJob->pSums[thread] == NULL) {
+    pJob->pSums[thread] = calloc(pB->columnCount + 1, sizeof(double));
+    pJob->pSeen[thread] = calloc(pB->columnCount + 1, sizeof(char));
+    pJob->pTouched[thread] = malloc((pB->columnCount + 1) * sizeof(int));
+  }
+
+  double *pSums = pJob->pSums[thread];
+  char *pSeen = pJob->pSeen[thread];
+  int *pTouched = pJob->pTouched[thread];
+  long productCount = 0;
+
+  for(int r = start; r < end; r++) {
+    int i = pJob->blockStart + r;
+    int touchedCount = 0;
+
+    // Scatter
+    for(long p = pA->pOffsets[i]; p < pA->pOffsets[i + 1]; p++) {
+      int k = pA->pColumns[p];
+      double a = pA->pValues[p];
+
+      productCount += pB->pOffsets[k + 1] - pB->pOffsets[k];
+
+      for(long q = pB->pOffsets[k]; q < pB->pOffsets[k + 1]; q++) {
+        int j = pB->pColumns[q];
+
+        if(!pSeen[j]) {
+          pSeen[j] = 1;
+          pTouched[touchedCount++] = j;
+        }
+
+        pSums[j] += a * pB->pValues[q];
+      }
+    }
+
+    // Make room for the whole row
+    if(pJob->entryCounts[thread] + touchedCount > pJob->entryLimits[thread]) {
+      long limit = pJob->entryLimits[thread] ? pJob->entryLimits[thread] : 1024;
+
+      while(limit < pJob->entryCounts[thread] + touchedCount)
+        limit *= 2;
+
+      pJob->pEntries[thread] = realloc(pJob->pEntries[thread], limit * sizeof(SparseEntry));
+      pJob->entryLimits[thread] = limit;
+    }
+
+    // Gather what passes the filter, clearing as we go
+    SparseEntry *pRow = pJob->pEntries[thread] + pJob->entryCounts[thread];
+    int count = 0;
+
+    for(int t = 0; t < touchedCount; t++) {
+      int j = pTouched[t];
+      double sum = pSums[j];
+      pSums[j] = 0;
+      pSeen[j] = 0;
+
+      if(sum == 0 || (!pFilter->bDiagonal && j == i))
+        continue;
+      if(pFilter->threshold != SPARSE_NO_LIMIT && sum < pFilter->threshold)
+        continue;
+
+      pRow[count].column = j;
+      pRow[count].value = sum;
+      count++;
+    }
+
+    // Keep only the largest, then put the row back in column order
+    if(pFilter->k != SPARSE_NO_LIMIT && count > pFilter->k) {
+      qsort(pRow, count, sizeof(SparseEntry), _Sparse_compareValues);
+      count = pFilter->k;
+    }
+
+    qsort(pRow, count, sizeof(SparseEntry), _Sparse_compareColumns);
+
+    // Remember where it went
+    pJob->pThreads[r] = thread;
+    pJob->pStarts[r] = pJob->entryCounts[thread];
+    pJob->pCounts[r] = count;
+    pJob->entryCounts[thread] += count;
+  }
+
+  pJob->productCounts[thread] += productCount;
+}
+
+/**
+ * Multiplies A by B, handing every kept entry of the product to pVisit in order.
+ * The rows are done a block at a time across threads, so only a block of the product is ever held in memory.
+ * An entry that cancels out to exactly 0 is never kept.
+ *
+ * @param   { Sparse * }        pA        The left factor.
+ * @param   { Sparse * }        pB        The right factor; it must have as many rows as A has columns.
+ * @param   { SparseFilter * }  pFilter   Which entries to keep.
+ * @param   { SparseVisit }     pVisit    What to do with each entry.
+ * @param   { void * }          pArgs     The arguments passed to pVisit.
+ * @return  { long }                      How many multiply-adds it took.
+ */
+long Sparse_stream(Sparse *pA, Sparse *pB, SparseFilter *pFilter, SparseVisit pVisit, void *pArgs) {
+  SparseJob *pJob = calloc(1, sizeof(*pJob));
+  pJob->pA = pA;
+  pJob->pB = pB;
+  pJob->pFilter = pFilter;
+
+  // One block at a time
+  for(pJob->blockStart = 0; pJob->blockStart < pA->rowCount; pJob->blockStart += SPARSE_BLOCK_ROWS) {
+    int blockCount = pA->rowCount - pJob->blockStart;
+
+    if(blockCount > SPARSE_BLOCK_ROWS)
+      blockCount = SPARSE_BLOCK_ROWS;
+
+    memset(pJob->entryCounts, 0, sizeof(pJob->entryCounts));
+    Thread_parallelFor(blockCount, SPARSE_CHUNK, _Sparse_multiplyRows, pJob);
+
+    // Hand the rows over in order
+    for(int r = 0; r < blockCount; r++) {
+      SparseEntry *pRow = pJob->pEntries[pJob->pThreads[r]] + pJob->pStarts[r];
+
+      for(int c = 0; c < pJob->pCounts[r]; c++)
+        pVisit(pArgs, pJob->blockStart + r, pRow[c].column, pRow[c].value);
+    }
+  }
+
+  // Garbage collection, and the total
+  long productCount = 0;
+
+  for(int t = 0; t < THREAD_MAX_COUNT; t++) {
+    productCount += pJob->productCounts[t];
+    free(pJob->pSums[t]);
+    free(pJob->pSeen[t]);
+    free(pJob->pTouched[t]);
+    free(pJob->pEntries[t]);
+  }
+
+  free(pJob);
+
+  return productCount;
+}
+
+/**
+ * Appends an entry to the matrix being built, growing it if needed.
+ * Entries arrive in order, so each row only has to note where it ends so far.
+ *
+ * @param   { void * }  pArgs   The matrix being built.
+ * @param   { int }     row     The row of the entry.
+ * @param   { int }     column  The column of the entry.
+ * @param   { double }  value   The value of the entry.
+ */
+void _Sparse_append(void *pArgs, int row, int column, double value) {
+  Sparse *this = pArgs;
+
+  // Grow if needed
+  if(this->entryCount == this->entryLimit) {
+    this->entryLimit = this->entryLimit ? this->entryLimit * 2 : 1024;
+    this->pColumns = realloc(this->pColumns, (this->entryLimit + 1) * sizeof(int));
+    this->pValues = realloc(this->pValues, (this->entryLimit + 1) * sizeof(double));
+  }
+
+  this->pColumns[this->entryCount] = column;
+  this->pValues[this->entryCount] = value;
+  this->pOffsets[row + 1] = ++this->entryCount;
+}
+
+/**
+ * Multiplies A by B into a new matrix.
+ *
+ * @param   { Sparse * }        pA              The left factor.
+ * @param   { Sparse * }        pB              The right factor; it must have as many rows as A has columns.
+ * @param   { SparseFilter * }  pFilter         Which entries to keep.
+ * @param   { long * }          pProductCount   Where to put how many multiply-adds it took; may be NULL.
+ * @return  { Sparse * }                        The product.
+ */
+Sparse *Sparse_multiply(Sparse *pA, Sparse *pB, SparseFilter *pFilter, long *pProductCount) {
+  Sparse *this = Sparse_new(pA->rowCount, pB->columnCount, 0);
+  long productCount = Sparse_stream(pA, pB, pFilter, _Sparse_append, this);
+
+  // Rows that got nothing end where the row before them did
+  for(int i = 1; i <= this->rowCount; i++)
+    if(this->pOffsets[i] < this->pOffsets[i - 1])
+      this->pOffsets[i] = this->pOffsets[i - 1];
+
+  if(pProductCount != NULL)
+    *pProductCount = productCount;
+
+  return this;
+}
+
+#endif
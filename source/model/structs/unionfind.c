@@ -0,0 +1,180 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 22:31:14
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ * 
+ * A disjoint-set forest over dense indices.
+ * Uses union by rank and path halving, so every operation is practically constant time.
+ */
+
+#ifndef UNIONFIND_C
+#define UNIONFIND_C
+
+#include <stdlib.h>
+
+typedef struct UnionFind UnionFind;
+
+/**
+ * The union-find struct.
+ */
+struct UnionFind {
+
+  // The parent and rank of each element
+  int *pParents;
+  unsigned char *pRanks;
+
+  // How many elements there are, and how many fit
+  int count;
+  int limit;
+
+  // How many disjoint sets there are
+  int setCount;
+};
+
+/**
+ * The union-find interface.
+ */
+UnionFind *_UnionFind_alloc();
+UnionFind *_UnionFind_init(UnionFind *this, int limit);
+UnionFind *UnionFind_new(int limit);
+void UnionFind_kill(UnionFind *this);
+
+int UnionFind_add(UnionFind *this);
+int UnionFind_find(UnionFind *this, int i);
+int UnionFind_union(UnionFind *this, int a, int b);
+
+/**
+ * Allocates memory for a union-find.
+ * 
+ * @return  { UnionFind * }   The memory for the new union-find.
+*/
+UnionFind *_UnionFind_alloc() {
+  UnionFind *pUnionFind = calloc(1, sizeof(*pUnionFind));
+
+  return pUnionFind;
+}
+
+/**
+ * Initializes an empty union-find.
+ * 
+ * @param   { UnionFind * }   this    The union-find to initialize.
+ * @param   { int }           limit   How many elements to make room for at first.
+ * @return  { UnionFind * }           The initialized union-find.
+*/
+UnionFind *_UnionFind_init(UnionFind *this, int limit) {
+
+  // Make room
+  this->limit = limit < 16 ? 16 : limit;
+  this->pParents = malloc(this->limit * sizeof(int));
+  this->pRanks = calloc(this->limit, sizeof(unsigned char));
+
+  // Nothing in it yet
+  this->count = 0;
+  this->setCount = 0;
+
+  return this;
+}
+
+/**
+ * Creates a new empty union-find.
+ * 
+ * @param   { int }           limit   How many elements to make room for at first.
+ * @return  { UnionFind * }           The new union-find.
+*/
+UnionFind *UnionFind_new(int limit) {
+  return _UnionFind_init(_UnionFind_alloc(), limit);
+}
+
+/**
+ * Frees the memory associated with a union-find.
+ * 
+ * @param   { UnionFind * }   this  The union-find to free.
+*/
+void UnionFind_kill(UnionFind *this) {
+  free(this->pParents);
+  free(this->pRanks);
+  free(this);
+}
+
+/**
+ * Adds a new element in a set of its own.
+ * Elements are numbered in the order they're added.
+ * 
+ * @param   { UnionFind * }   this  The union-find to grow.
+ * @return  { int }                 The new element.
+*/
+int UnionFind_add(UnionFind *this) {
+
+  // Grow if needed
+  if(this->count == this->limit) {
+    this->limit <<= 1;
+    this->pParents = realloc(this->pParents, this->limit * sizeof(int));
+    this->pRanks = realloc(this->pRanks, this->limit * sizeof(unsigned char));
+  }
+
+  // Its own root
+  this->pParents[this->count] = this->count;
+  this->pRanks[this->count] = 0;
+  this->setCount++;
+
+  return this->count++;
+}
+
+/**
+ * Finds the root of the set an element belongs to.
+ * Every other node on the way gets pointed at its grandparent.
+ * 
+ * @param   { UnionFind * }   this  The union-find to search.
+ * @param   { int }           i     The element to look up.
+ * @return  { int }                 The root of its set.
+*/
+int UnionFind_find(UnionFind *this, int i) {
+  int *pParents = this->pParents;
+
+  // Halve the path as we go
+  while(pParents[i] != i) {
+    pParents[i] = pParents[pParents[i]];
+    i = pParents[i];
+  }
+
+  return i;
+}
+
+/**
+ * Merges the sets of two elements.
+ * The shallower tree is hung under the deeper one.
+ * 
+ * @param   { UnionFind * }   this  The union-find to modify.
+ * @param   { int }           a     The first element.
+ * @param   { int }           b     The second element.
+ * @return  { int }                 Whether or not the two were in different sets.
+*/
+int UnionFind_union(UnionFind *this, int a, int b) {
+
+  // Find both roots
+  a = UnionFind_find(this, a);
+  b = UnionFind_find(this, b);
+
+  // Already together
+  if(a == b)
+    return 0;
+
+  // Keep a as the deeper tree
+  if(this->pRanks[a] < this->pRanks[b]) {
+    int temp = a;
+    a = b;
+    b = temp;
+  }
+
+  // Hang b under a
+  this->pParents[b] = a;
+  if(this->pRanks[a] == this->pRanks[b])
+    this->pRanks[a]++;
+
+  this->setCount--;
+
+  return 1;
+}
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 05:31:12
+ * @ Modified time: 2026-10-19 08:14:06
+ * @ Description:
+ * 
+ * The few bits of math the model needs, so it doesn't have to link the math library.
+ */
+
+#ifndef MATH_C
+#define MATH_C
+
+// The natural log of 2
+#define MATH_LN2 0.6931471805599453
+
+/**
+ * Computes a natural log.
+ * The number is halved or doubled into [1, 2), and the rest comes from the series of 2 atanh((x - 1) / (x + 1)).
+ * 
+ * @param   { double }  x   A positive number.
+ * @return  { double }      Its natural log.
+*/
+double Math_log(double x) {
+  int exponent = 0;
+
+  // Bring it into [1, 2)
+  while(x >= 2) {
+    x /= 2;
+    exponent++;
+  }
+
+  while(x < 1) {
+    x *= 2;
+    exponent--;
+  }
+
+  // The series converges fast, since y is at most 1/3
+  double y = (x - 1) / (x + 1);
+  double power = y;
+  double sum = 0;
+
+  for(int k = 1; k < 40; k += 2) {
+    sum += power / k;
+    power *= y * y;
+  }
+
+  return exponent * MATH_LN2 + 2 * sum;
+}
+
+#endif
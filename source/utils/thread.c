@@ -0,0 +1,206 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 20:08:31
+ * @ Modified time: 2026-10-19 09:21:14
+ * @ Description:
+ *
+ * Utilities for splitting loops across threads.
+ */
+
+#ifndef THREAD_C
+#define THREAD_C
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define THREAD_MAX_COUNT 64
+#define THREAD_ENV "MODEL_THREADS"
+
+typedef struct ThreadTask ThreadTask;
+
+/**
+ * The function run on each chunk of a parallel loop.
+ * It receives the shared arguments, the index of the running thread, and the range to process.
+ */
+typedef void (*ThreadWork)(void *pArgs, int thread, int start, int end);
+
+struct Thread {
+
+  // How many threads to use for parallel loops
+  int count;
+
+} Thread;
+
+/**
+ * The state shared by the threads of a single parallel loop.
+ */
+struct ThreadTask {
+
+  // The work to do and its arguments
+  ThreadWork pWork;
+  void *pArgs;
+
+  // The range of the loop, and the next unclaimed index
+  int count;
+  int chunk;
+  int next;
+};
+
+/**
+ * The thread interface.
+ */
+void Thread_init();
+int Thread_getCount();
+void Thread_parallelFor(int count, int chunk, ThreadWork pWork, void *pArgs);
+
+/**
+ * Initializes the thread settings.
+ * Uses the MODEL_THREADS environment variable if set, otherwise the number of processors.
+ */
+void Thread_init() {
+
+  // Check for an override first
+  char *env = getenv(THREAD_ENV);
+  int count = env != NULL ? atoi(env) : 0;
+
+  // Ask the system
+  if(count <= 0) {
+    #ifndef _WIN32
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+    #else
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    count = info.dwNumberOfProcessors;
+    #endif
+  }
+
+  // Clamp it
+  if(count < 1)
+    count = 1;
+  if(count > THREAD_MAX_COUNT)
+    count = THREAD_MAX_COUNT;
+
+  Thread.count = count;
+}
+
+/**
+ * Returns how many threads parallel loops will use.
+ *
+ * @return  { int }   The thread count.
+ */
+int Thread_getCount() {
+
+  // Init lazily
+  if(Thread.count == 0)
+    Thread_init();
+
+  return Thread.count;
+}
+
+/**
+ * Claims chunks of the loop until none are left.
+ *
+ * @param   { ThreadTask * }  pTask     The shared loop state.
+ * @param   { int }           thread    The index of the running thread.
+ */
+static void _Thread_run(ThreadTask *pTask, int thread) {
+
+  // Keep grabbing chunks
+  while(1) {
+
+    // Claim the next chunk
+    int start = __atomic_fetch_add(&pTask->next, pTask->chunk, __ATOMIC_RELAXED);
+    int end = start + pTask->chunk;
+
+    // Nothing left
+    if(start >= pTask->count)
+      break;
+
+    // Don't go past the end
+    if(end > pTask->count)
+      end = pTask->count;
+
+    // Do the work
+    pTask->pWork(pTask->pArgs, thread, start, end);
+  }
+}
+
+/**
+ * The entry point of each spawned thread.
+ *
+ * @param   { void * }  pArg  Points to the task and the index of the thread.
+ * @return  { void * }        Nothing.
+ */
+static void *_Thread_main(void *pArg) {
+
+  // Unpack the task and the index
+  void **pSlot = pArg;
+  ThreadTask *pTask = pSlot[0];
+  int thread = (int) (intptr_t) pSlot[1];
+
+  _Thread_run(pTask, thread);
+
+  return NULL;
+}
+
+/**
+ * Runs a loop over [0, count) across the threads.
+ * The range is handed out in chunks of the given size, so ranges never straddle a chunk boundary.
+ * The calling thread takes part as thread 0, and nothing is spawned when a single thread would do.
+ * If a thread can't be spawned, the ones that were (or just the calling thread) finish the loop.
+ *
+ * @param   { int }         count   The size of the loop.
+ * @param   { int }         chunk   How many iterations to hand out at a time.
+ * @param   { ThreadWork }  pWork   The work to run on each chunk.
+ * @param   { void * }      pArgs   The shared arguments of the work.
+ */
+void Thread_parallelFor(int count, int chunk, ThreadWork pWork, void *pArgs) {
+
+  // The shared state
+  ThreadTask task = { pWork, pArgs, count, chunk < 1 ? 1 : chunk, 0 };
+
+  // Don't spawn more threads than there are chunks
+  int threadCount = Thread_getCount();
+  int chunkCount = (count + task.chunk - 1) / task.chunk;
+
+  if(threadCount > chunkCount)
+    threadCount = chunkCount;
+
+  // Just do it here
+  if(threadCount <= 1) {
+    _Thread_run(&task, 0);
+    return;
+  }
+
+  // The handles and the arguments of each thread
+  pthread_t threads[THREAD_MAX_COUNT];
+  void *slots[THREAD_MAX_COUNT][2];
+
+  // Spawn the helpers, stopping at the first that can't be made
+  // Chunks are claimed as threads free up, so whatever a missing helper would have taken falls to the rest
+  int spawnedCount = 1;
+
+  for(; spawnedCount < threadCount; spawnedCount++) {
+    slots[spawnedCount][0] = &task;
+    slots[spawnedCount][1] = (void *) (intptr_t) spawnedCount;
+
+    if(pthread_create(&threads[spawnedCount], NULL, _Thread_main, slots[spawnedCount]))
+      break;
+  }
+
+  // Help out
+  _Thread_run(&task, 0);
+
+  // Wait for the ones that were made
+  for(int i = 1; i < spawnedCount; i++)
+    pthread_join(threads[i], NULL);
+}
+
+#endif
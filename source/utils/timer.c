@@ -0,0 +1,38 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-18 21:58:03
+ * @ Modified time: 2026-10-18 21:58:03
+ * @ Description:
+ * 
+ * A wall clock for timing the model.
+ */
+
+#ifndef TIMER_C
+#define TIMER_C
+
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/**
+ * Returns the current time in seconds.
+ * Only differences between two readings are meaningful.
+ * 
+ * @return  { double }  The current time.
+*/
+double Timer_now() {
+  #ifndef _WIN32
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+  #else
+  LARGE_INTEGER now, frequency;
+  QueryPerformanceCounter(&now);
+  QueryPerformanceFrequency(&frequency);
+  return (double) now.QuadPart / frequency.QuadPart;
+  #endif
+}
+
+#endif
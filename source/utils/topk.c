@@ -0,0 +1,57 @@
+/**
+ * @ Author: Mo David
+ * @ Create Time: 2026-10-19 08:41:27
+ * @ Modified time: 2026-10-19 08:41:27
+ * @ Description:
+ *
+ * Picks the k highest-scoring items out of many, best first.
+ * A sorted window of k is kept while scanning, which is cheap for the small k the summaries ask for.
+ */
+
+#ifndef TOPK_C
+#define TOPK_C
+
+/**
+ * Slides an item into a sorted window of the best items so far, if it belongs there.
+ * Ties keep the item that came first.
+ *
+ * @param   { double * }  pScores   The score of every item.
+ * @param   { int * }     pTop      The window, best first; must hold k entries.
+ * @param   { int }       count     How many items the window holds so far.
+ * @param   { int }       k         How many items the window can hold.
+ * @param   { int }       item      The item to slide in.
+ * @return  { int }                 How many items the window holds now.
+*/
+static inline int TopK_push(double *pScores, int *pTop, int count, int k, int item) {
+  int j = count < k ? count++ : k;
+
+  // Shift the lower scores down
+  for(; j > 0 && pScores[pTop[j - 1]] < pScores[item]; j--)
+    if(j < k)
+      pTop[j] = pTop[j - 1];
+
+  if(j < k)
+    pTop[j] = item;
+
+  return count;
+}
+
+/**
+ * Finds the items with the highest scores, best first.
+ *
+ * @param   { double * }  pScores   The score of every item.
+ * @param   { int }       n         How many items there are.
+ * @param   { int }       k         How many items to find.
+ * @param   { int * }     pTop      Where to write the items; must hold k entries.
+ * @return  { int }                 How many items were written.
+*/
+int TopK_select(double *pScores, int n, int k, int *pTop) {
+  int count = 0;
+
+  for(int i = 0; i < n; i++)
+    count = TopK_push(pScores, pTop, count, k, i);
+
+  return count;
+}
+
+#endif